@@ -13,7 +13,13 @@
 
 
 #include "__base.hpp"
-#include <unordered_map>
+#include "IndexSet.hpp"
+#include "Storage.hpp"
+#include "ChainExpression.hpp"
+#include "ChainView.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 
@@ -27,21 +33,24 @@ namespace OSM {
  * 
  * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
  * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The chain storage policy (default is OSM::DefaultStorage)
  * 
  * \author Fedyna K.
  * \version 0.1.0
  * \date 08/04/2024
  */
-template <typename _CoefficientType, int _ChainTypeFlag>
-class Chain {
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class Chain : public ChainOperators<_CoefficientType, _ChainTypeFlag, _StorageType> {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "A chain is either a column or a row.");
 
 public:
-    typedef typename std::unordered_map<int, _CoefficientType>::iterator iterator;
-    typedef typename std::unordered_map<int, _CoefficientType>::const_iterator const_iterator;
+    typedef typename _StorageType::iterator iterator;
+    typedef typename _StorageType::const_iterator const_iterator;
 
 private:
     /** \brief The chain inner representation and storage of data. */
-    std::unordered_map<int, _CoefficientType> chainData;
+    _StorageType chainData;
 
     /** \brief The chain coefficient type. */
     typedef _CoefficientType coefficientType;
@@ -116,40 +125,48 @@ public:
     Chain(const Chain &_otherToCopy);
 
     /**
-     * \brief Assign to other chain.
+     * \brief Create new Chain for SparseMatrix object.
      * 
-     * Assign to other chain coefficient-wise, equivalent to copying it.
+     * Conversion constructor, the resulting chain will be a copy of the viewed chain.
      * 
-     * \pre The chains have the same coefficent type.
+     * \param[in] _view The view on the chain we want to copy.
      * 
-     * \warning Will raise an error if the other chain is not the same coefficient type.
+     * \see \link OSM::ChainView \endlink
+     */
+    Chain(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view);
+
+    /**
+     * \brief Create new Chain for SparseMatrix object.
      * 
-     * \param[in] _otherToCopy The chain we want to copy.
+     * Move constructor, the resulting chain takes over the storage of the passed chain, which is left empty.
      * 
-     * \return The reference to the modified chain.
+     * \param[in] _otherToMove The chain we want to move.
+     */
+    Chain(Chain &&_otherToMove) noexcept;
+
+    /**
+     * \brief Create new Chain for SparseMatrix object.
      * 
-     * \see \link OSM::Chain \endlink
+     * Evaluation constructor, the linear combination is merged in a single pass into the new chain.
      * 
-     * \author Fedyna K.
-     * \version 0.1.0
-     * \date 08/04/2024
+     * \param[in] _expression The linear combination of chains.
+     * 
+     * \see \link OSM::ChainExpression \endlink
      */
-    Chain& operator=(const Chain &_otherToCopy);
+    Chain(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_expression);
 
     /**
-     * \brief Adds two chains together.
+     * \brief Assign to other chain.
      * 
-     * Adds each coefficient of the chain together.
+     * Assign to other chain coefficient-wise, equivalent to copying it.
      * 
-     * \pre The chains have the same coefficent type and the same type flag.
+     * \pre The chains have the same coefficent type.
      * 
-     * \warning Will raise an error if the two chains are not the same coefficient type.
-     * \warning Will raise an error if the two chains don't have the same type flag.
+     * \warning Will raise an error if the other chain is not the same coefficient type.
      * 
-     * \param[in] _first The first chain.
-     * \param[in] _second The second chain.
+     * \param[in] _otherToCopy The chain we want to copy.
      * 
-     * \return A new chain representing the result.
+     * \return The reference to the modified chain.
      * 
      * \see \link OSM::Chain \endlink
      * 
@@ -157,66 +174,43 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend Chain operator+(const Chain<_CT, _CTF> &_first, const Chain<_CT, _CTF> &_second);
+    Chain& operator=(const Chain &_otherToCopy);
 
     /**
-     * \brief Substract two chains together.
+     * \brief Move assign to other chain.
      * 
-     * Substract each coefficient of the chain together.
+     * Takes over the storage of the other chain, which is left empty.
      * 
-     * \pre The chains have the same coefficent type and the same type flag.
+     * \param[in] _otherToMove The chain we want to move.
      * 
-     * \warning Will raise an error if the two chains are not the same coefficient type.
-     * \warning Will raise an error if the two chains don't have the same type flag.
-     * 
-     * \param[in] _first The first chain.
-     * \param[in] _second The second chain.
-     * 
-     * \return A new chain representing the result.
-     * 
-     * \see \link OSM::Chain \endlink
-     * 
-     * \author Fedyna K.
-     * \version 0.1.0
-     * \date 08/04/2024
+     * \return The reference to the modified chain.
      */
-    template <typename _CT, int _CTF>
-    friend Chain operator-(const Chain<_CT, _CTF> &_first, const Chain<_CT, _CTF> &_second);
+    Chain& operator=(Chain &&_otherToMove) noexcept;
 
     /**
-     * \brief Apply factor on each coefficients.
+     * \brief Assign to a viewed chain.
      * 
-     * \param[in] _lambda The factor to apply.
-     * \param[in] _chain The second chain.
-     * 
-     * \return A new chain representing the result.
+     * \param[in] _view The view on the chain we want to copy.
      * 
-     * \see \link OSM::Chain \endlink
+     * \return The reference to the modified chain.
      * 
-     * \author Fedyna K.
-     * \version 0.1.0
-     * \date 08/04/2024
+     * \see \link OSM::ChainView \endlink
      */
-    template <typename _CT, int _CTF>
-    friend Chain operator*(const int _lambda, const Chain<_CT, _CTF> &_chain);
+    Chain& operator=(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view);
 
     /**
-     * \brief Apply factor on each coefficients.
+     * \brief Assign to a linear combination of chains.
      * 
-     * \param[in] _chain The second chain.
-     * \param[in] _lambda The factor to apply.
+     * The combination is merged in a single pass written into the chain storage, no intermediate chain is built.
+     * The chain may be one of the combined chains, as in `a = a + b - 2 * c`.
      * 
-     * \return A new chain representing the result.
+     * \param[in] _expression The linear combination of chains.
      * 
-     * \see \link OSM::Chain \endlink
+     * \return The reference to the modified chain.
      * 
-     * \author Fedyna K.
-     * \version 0.1.0
-     * \date 08/04/2024
+     * \see \link OSM::ChainExpression \endlink
      */
-    template <typename _CT, int _CTF>
-    friend Chain operator*(const Chain<_CT, _CTF> &_chain, const _CT _lambda);
+    Chain& operator=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_expression);
 
     /**
      * \brief Perform matrix multiplication between two chains.
@@ -238,8 +232,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT>
-    friend SparseMatrix<_CT, COLUMN> operator*(const Chain<_CT, COLUMN> &_column, const Chain<_CT, ROW> &_row);
+    template <typename _CT, typename _ST>
+    friend SparseMatrix<_CT, COLUMN, _ST> operator*(const Chain<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row);
 
     /**
      * \brief Perform matrix multiplication between two chains.
@@ -261,8 +255,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT>
-    friend SparseMatrix<_CT, ROW> operator%(const Chain<_CT, COLUMN> &_column, const Chain<_CT, ROW> &_row);
+    template <typename _CT, typename _ST>
+    friend SparseMatrix<_CT, ROW, _ST> operator%(const Chain<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row);
 
     /**
      * \brief Perform dot product between two chains.
@@ -282,8 +276,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT>
-    friend _CT operator*(const Chain<_CT, ROW> &_row, const Chain<_CT, COLUMN> &_column);
+    template <typename _CT, typename _ST>
+    friend _CT operator*(const Chain<_CT, ROW, _ST> &_row, const Chain<_CT, COLUMN, _ST> &_column);
 
     /**
      * \brief Add a chain and assign.
@@ -295,17 +289,18 @@ public:
      * \warning Will raise an error if the two chains are not the same coefficient type.
      * \warning Will raise an error if the two chains don't have the same type flag.
      * 
-     * \param[in] _other The other chain.
+     * \param[in] _other The other chain, a view on it or a linear combination of chains.
      * 
      * \return The modified chain representing the result.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainExpression \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    Chain& operator+=(const Chain &_other);
+    Chain& operator+=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_other);
 
     /**
      * \brief Substract a chain and assign.
@@ -317,17 +312,18 @@ public:
      * \warning Will raise an error if the two chains are not the same coefficient type.
      * \warning Will raise an error if the two chains don't have the same type flag.
      * 
-     * \param[in] _other The other chain.
+     * \param[in] _other The other chain, a view on it or a linear combination of chains.
      * 
      * \return The modified chain representing the result.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainExpression \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    Chain& operator-=(const Chain &_other);
+    Chain& operator-=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_other);
 
     /**
      * \brief Apply factor on each coefficients and assign.
@@ -344,6 +340,22 @@ public:
      */
     Chain& operator*=(const int _lambda);
 
+    /**
+     * \brief Add a scaled chain and assign.
+     * 
+     * Fused `*this += _lambda * _other`, performed in a single merge without any temporary chain.
+     * Entries cancelling to zero are dropped.
+     * 
+     * \param[in] _lambda The factor applied to the other chain.
+     * \param[in] _other The other chain, or a view on it.
+     * 
+     * \return The modified chain representing the result.
+     * 
+     * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainView \endlink
+     */
+    Chain& addScaled(const _CoefficientType _lambda, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_other);
+
     /**
      * \brief Get a coefficient from the chain.
      * 
@@ -365,10 +377,11 @@ public:
      * \brief Set a coefficient in the chain.
      * 
      * \warning The chain will not perform boundary check if not specified in constructor and will assign anyways.
+     * \warning With OSM::SortedStorage, the reference is invalidated by the next insertion in the chain.
      * 
      * \param[in] _index The coefficient index.
      * 
-     * \return The reference to the assigned coefficient.
+     * \return The reference to the assigned coefficient, a proxy with OSM::Z2Storage.
      * 
      * \see \link OSM::Chain \endlink
      * 
@@ -376,7 +389,7 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    _CoefficientType& operator[](const int _index);
+    typename _StorageType::reference operator[](const int _index);
 
     /**
      * \brief Get a subchain from the chain.
@@ -397,8 +410,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend Chain<_CT, _CTF> operator/(const Chain<_CT, _CTF> &_chain, const std::vector<int> &_indexes);
+    template <typename _CT, int _CTF, typename _ST>
+    friend Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const std::vector<int> &_indexes);
 
     /**
      * \brief Get a subchain from the chain.
@@ -407,6 +420,8 @@ public:
      * 
      * \note Will return a copy of the chain if given vector is empty.
      * 
+     * \warning The indexes array must be terminated by a negative index.
+     * 
      * \param[in] _chain The chain to process.
      * \param[in] _indexes The indexes to remove.
      * 
@@ -419,8 +434,24 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend Chain<_CT, _CTF> operator/(const Chain<_CT, _CTF> &_chain, const int *_indexes);
+    template <typename _CT, int _CTF, typename _ST>
+    friend Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const int *_indexes);
+
+    /**
+     * \brief Get a subchain from the chain.
+     * 
+     * Removes all indexes of the set from the chain and returns it, in a single pass over the chain.
+     * 
+     * \param[in] _chain The chain to process.
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return A new chain representing the result.
+     * 
+     * \see \link OSM::Chain \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    template <typename _CT, int _CTF, typename _ST>
+    friend Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const IndexSet &_indexes);
 
     /**
      * \brief Get a subchain from the chain and assign.
@@ -449,6 +480,8 @@ public:
      * 
      * \note Will not alter the chain if given vector is empty.
      * 
+     * \warning The indexes array must be terminated by a negative index.
+     * 
      * \param[in] _indexes The indexes to remove.
      * 
      * \return The modified chain representing the result.
@@ -462,17 +495,44 @@ public:
      */
     Chain& operator/=(const int *_indexes);
 
+    /**
+     * \brief Get a subchain from the chain and assign.
+     * 
+     * Removes all indexes of the set from the chain, in a single pass over the chain.
+     * 
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return The modified chain representing the result.
+     * 
+     * \see \link OSM::Chain \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    Chain& operator/=(const IndexSet &_indexes);
+
+    /**
+     * \brief Restricts the chain to a set of indexes.
+     * 
+     * Keeps the indexes of the set only, renumbered among them.
+     * 
+     * \param[in] _indexes The indexes to keep.
+     * 
+     * \return A new chain of size the number of kept indexes.
+     * 
+     * \see \link OSM::Chain \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    Chain restriction(const IndexSet &_indexes) const;
+
     /**
      * \brief Iterator to the beginning of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The iterator to the beginning of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::iterator \endlink
-     * \see \link std::unordered_map::begin \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -483,14 +543,13 @@ public:
     /**
      * \brief Constant iterator to the beginning of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The constant iterator to the beginning of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::const_iterator \endlink
-     * \see \link std::unordered_map::begin \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -501,14 +560,13 @@ public:
     /**
      * \brief Constant iterator to the beginning of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The constant iterator to the beginning of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::const_iterator \endlink
-     * \see \link std::unordered_map::cbegin \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -519,14 +577,13 @@ public:
     /**
      * \brief Iterator to the end of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The iterator to the end of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::iterator \endlink
-     * \see \link std::unordered_map::end \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -537,14 +594,13 @@ public:
     /**
      * \brief Constant iterator to the end of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The constant iterator to the end of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::const_iterator \endlink
-     * \see \link std::unordered_map::end \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -555,14 +611,13 @@ public:
     /**
      * \brief Constant iterator to the end of the chain.
      * 
-     * \warning The chain is stored unordered for speed reason.
+     * \warning The iteration order depends on the storage policy, OSM::SortedStorage iterates by increasing index.
      * 
      * \return The constant iterator to the end of the chain.
      * 
      * \see \link OSM::Chain \endlink
-     * \see \link std::unordered_map \endlink
-     * \see \link std::unordered_map::const_iterator \endlink
-     * \see \link std::unordered_map::cend \endlink
+     * \see \link OSM::SortedStorage \endlink
+     * \see \link OSM::MapStorage \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
@@ -581,7 +636,7 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    inline Chain transpose();
+    inline Chain<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> transpose() const;
 
     /**
      * \brief Checks if chain is a column.
@@ -608,8 +663,338 @@ public:
      * \date 17/04/2024
      */
     bool isRow() const;
+
+    /**
+     * \brief Number of coefficients stored in the chain.
+     * 
+     * \return The number of stored coefficients.
+     * 
+     * \see \link OSM::Chain \endlink
+     */
+    inline std::size_t size() const noexcept;
+
+    /**
+     * \brief Number of coefficients the chain storage holds without growing.
+     * 
+     * \return The storage capacity, the bucket count of hashed storages.
+     * 
+     * \see \link OSM::Chain \endlink
+     */
+    inline std::size_t capacity() const noexcept;
+
+    /**
+     * \brief Get the greatest index stored in the chain.
+     * 
+     * The pivot of the chain in column reductions.
+     * 
+     * \return The last index, -1 if the chain is null.
+     * 
+     * \see \link OSM::Chain \endlink
+     */
+    inline int lastIndex() const noexcept;
+
+    /**
+     * \brief Get the chain boundary.
+     * 
+     * \return The upper bound given at construction.
+     * 
+     * \see \link OSM::Chain \endlink
+     */
+    inline int getUpperBound() const noexcept;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class Chain;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class SparseMatrix;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ChainView;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ChainExpression;
+
+    template <typename _CT, int _CTF>
+    friend class MappedMatrix;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ReorientedView;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class LazyChain;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ChainPacket;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class DistributedMatrix;
 };
 
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain() : upperBound(128) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain(const int _chainSize) : upperBound(_chainSize) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain(const Chain &_otherToCopy) :
+    chainData(_otherToCopy.chainData),
+    upperBound(_otherToCopy.upperBound) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view) :
+    chainData(*_view.chainData),
+    upperBound(_view.upperBound) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain(Chain &&_otherToMove) noexcept :
+    chainData(std::move(_otherToMove.chainData)),
+    upperBound(_otherToMove.upperBound) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::Chain(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_expression) :
+    upperBound(_expression.getUpperBound()) {
+    _expression.evaluate(chainData);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(const Chain &_otherToCopy) {
+    chainData = _otherToCopy.chainData;
+    upperBound = _otherToCopy.upperBound;
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(Chain &&_otherToMove) noexcept {
+    chainData = std::move(_otherToMove.chainData);
+    upperBound = _otherToMove.upperBound;
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view) {
+    if (_view.chainData != &chainData) {
+        chainData = *_view.chainData;
+    }
+    upperBound = _view.upperBound;
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_expression) {
+    const int expressionUpperBound = _expression.getUpperBound();
+
+    _expression.evaluate(chainData);
+    upperBound = expressionUpperBound;
+
+    return *this;
+}
+
+template <typename _CT, typename _ST>
+_CT operator*(const Chain<_CT, ROW, _ST> &_row, const Chain<_CT, COLUMN, _ST> &_column) {
+    return _ST::dot(_row.chainData, _column.chainData);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator+=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_other) {
+    if (const typename ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::Term *term = _other.singleTerm()) {
+        chainData.addScaled(term->factor, *term->storage);
+    } else {
+        *this = ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>(*this) + _other;
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator-=(const ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> &_other) {
+    if (const typename ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::Term *term = _other.singleTerm()) {
+        chainData.addScaled(-term->factor, *term->storage);
+    } else {
+        *this = ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>(*this) - _other;
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator*=(const int _lambda) {
+    chainData.scale(_CoefficientType(_lambda));
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::addScaled(const _CoefficientType _lambda, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_other) {
+    chainData.addScaled(_lambda, *_other.chainData);
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+_CoefficientType Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    return chainData.get(_index);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename _StorageType::reference Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) {
+    return chainData.access(_index);
+}
+
+template <typename _CT, int _CTF, typename _ST>
+Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const std::vector<int> &_indexes) {
+    Chain<_CT, _CTF, _ST> result = _chain;
+    result /= _indexes;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const int *_indexes) {
+    Chain<_CT, _CTF, _ST> result = _chain;
+    result /= _indexes;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+Chain<_CT, _CTF, _ST> operator/(const Chain<_CT, _CTF, _ST> &_chain, const IndexSet &_indexes) {
+    Chain<_CT, _CTF, _ST> result = _chain;
+    result /= _indexes;
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const std::vector<int> &_indexes) {
+    return *this /= IndexSet(upperBound, _indexes);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const int *_indexes) {
+    std::size_t count = 0;
+
+    while (_indexes[count] >= 0) {
+        count++;
+    }
+
+    return *this /= IndexSet(upperBound, _indexes, count);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType>& Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const IndexSet &_indexes) {
+    if (_indexes.empty()) {
+        return *this;
+    }
+
+    chainData.remapIndexes([&_indexes](const int _index) { return _indexes.removedIndex(_index); });
+    upperBound -= _indexes.rank(upperBound);
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Chain<_CoefficientType, _ChainTypeFlag, _StorageType> Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::restriction(const IndexSet &_indexes) const {
+    Chain result(*this);
+
+    result.chainData.remapIndexes([&_indexes](const int _index) { return _indexes.keptIndex(_index); });
+    result.upperBound = _indexes.rank(upperBound);
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::begin() noexcept {
+    return chainData.begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::begin() const noexcept {
+    return chainData.begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::cbegin() const noexcept {
+    return chainData.begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::end() noexcept {
+    return chainData.end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::end() const noexcept {
+    return chainData.end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::cend() const noexcept {
+    return chainData.end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline Chain<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::transpose() const {
+    Chain<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> result(upperBound);
+    result.chainData = chainData;
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+bool Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::isColumn() const {
+    return chainTypeFlag == COLUMN;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+bool Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::isRow() const {
+    return chainTypeFlag == ROW;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline std::size_t Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::size() const noexcept {
+    return chainData.size();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline std::size_t Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::capacity() const noexcept {
+    return chainData.capacity();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::lastIndex() const noexcept {
+    return chainData.lastIndex();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int Chain<_CoefficientType, _ChainTypeFlag, _StorageType>::getUpperBound() const noexcept {
+    return upperBound;
+}
+
+
+/**
+ * \brief Computes the dot product between a row and a column, any of them being a view.
+ * 
+ * \param[in] _row The row chain.
+ * \param[in] _column The column chain.
+ * 
+ * \return The result of type _CoefficientType.
+ * 
+ * \see \link OSM::ChainView \endlink
+ */
+template <typename _CT, typename _ST>
+_CT operator*(const Chain<_CT, ROW, _ST> &_row, const ChainView<_CT, COLUMN, _ST> &_column) {
+    return ChainView<_CT, ROW, _ST>(_row) * _column;
+}
+
+template <typename _CT, typename _ST>
+_CT operator*(const ChainView<_CT, ROW, _ST> &_row, const Chain<_CT, COLUMN, _ST> &_column) {
+    return _row * ChainView<_CT, COLUMN, _ST>(_column);
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+/**
+ * \file ChainExpression.hpp
+ * \brief Lazy linear combinations of chains, evaluated in a single pass when assigned.
+ *
+ * Define everything for the ChainExpression class
+ */
+
+#ifndef __OSM_CHAIN_EXPRESSION__
+#define __OSM_CHAIN_EXPRESSION__
+
+
+#include "__base.hpp"
+#include "SmallVector.hpp"
+#include "Storage.hpp"
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class ChainOperators
+ * \brief Linear operators shared by chains, chain views and chain expressions.
+ *
+ * OSM::Chain, OSM::ChainView and OSM::ChainExpression derive from this empty class, so that the operators
+ * defined here are found for any mix of them. Every operand is converted to an OSM::ChainExpression,
+ * which only records the operand and its factor.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The chain storage policy (default is OSM::DefaultStorage)
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ChainOperators {
+
+    typedef ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> Expression;
+
+public:
+    /**
+     * \brief Adds two chains together.
+     *
+     * Adds each coefficient of the chain together, lazily.
+     *
+     * \param[in] _first The first chain.
+     * \param[in] _second The second chain.
+     *
+     * \return The expression of the sum, evaluated when assigned to a chain.
+     *
+     * \see \link OSM::ChainExpression \endlink
+     *
+     * \author Fedyna K.
+     * \version 0.1.0
+     * \date 08/04/2024
+     */
+    friend Expression operator+(const Expression &_first, const Expression &_second) {
+        return Expression::combine(_first, _second, _CoefficientType(1));
+    }
+
+    /**
+     * \brief Substract two chains together.
+     *
+     * Substract each coefficient of the chain together, lazily.
+     *
+     * \param[in] _first The first chain.
+     * \param[in] _second The second chain.
+     *
+     * \return The expression of the difference, evaluated when assigned to a chain.
+     *
+     * \see \link OSM::ChainExpression \endlink
+     *
+     * \author Fedyna K.
+     * \version 0.1.0
+     * \date 08/04/2024
+     */
+    friend Expression operator-(const Expression &_first, const Expression &_second) {
+        return Expression::combine(_first, _second, _CoefficientType(-1));
+    }
+
+    /**
+     * \brief Negates a chain, lazily.
+     *
+     * \param[in] _chain The chain.
+     *
+     * \return The expression of the opposite chain.
+     *
+     * \see \link OSM::ChainExpression \endlink
+     */
+    friend Expression operator-(const Expression &_chain) {
+        return Expression::scaled(_chain, _CoefficientType(-1));
+    }
+
+    /**
+     * \brief Apply factor on each coefficients, lazily.
+     *
+     * \param[in] _lambda The factor to apply.
+     * \param[in] _chain The chain.
+     *
+     * \return The expression of the scaled chain.
+     *
+     * \see \link OSM::ChainExpression \endlink
+     *
+     * \author Fedyna K.
+     * \version 0.1.0
+     * \date 08/04/2024
+     */
+    friend Expression operator*(const int _lambda, const Expression &_chain) {
+        return Expression::scaled(_chain, _CoefficientType(_lambda));
+    }
+
+    /**
+     * \brief Apply factor on each coefficients, lazily.
+     *
+     * \param[in] _chain The chain.
+     * \param[in] _lambda The factor to apply.
+     *
+     * \return The expression of the scaled chain.
+     *
+     * \see \link OSM::ChainExpression \endlink
+     *
+     * \author Fedyna K.
+     * \version 0.1.0
+     * \date 08/04/2024
+     */
+    friend Expression operator*(const Expression &_chain, const _CoefficientType _lambda) {
+        return Expression::scaled(_chain, _lambda);
+    }
+};
+
+/**
+ * \class ChainExpression
+ * \brief Lazy linear combination of chains.
+ *
+ * Sums, differences and factors of chains build an expression holding the combined chains storages and their factors,
+ * no chain is computed. Assigning the expression to a chain merges all terms in a single pass, written directly into
+ * the destination storage: `c = a + b - 2 * d` builds no intermediate chain.
+ *
+ * \warning The expression only points to its operands, it must be evaluated before they are modified or destroyed.
+ * Do not store an expression with `auto`, assign it to a OSM::Chain.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The chain storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::ChainOperators \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ChainExpression : public ChainOperators<_CoefficientType, _ChainTypeFlag, _StorageType> {
+
+public:
+    /** \brief A term of the combination. */
+    typedef ScaledStorage<_StorageType, _CoefficientType> Term;
+
+    /** \brief The array type used for the terms, short combinations are stored inline. */
+    typedef typename std::conditional<
+        std::is_trivially_copyable<Term>::value, SmallVector<Term, 4>, std::vector<Term>
+    >::type TermContainer;
+
+private:
+    /** \brief The scaled storages to sum. */
+    TermContainer terms;
+
+    /** \brief The chain boundary, the one of the first operand. */
+    int upperBound;
+
+public:
+    /**
+     * \brief Create new ChainExpression object.
+     *
+     * The expression of a single chain, with factor 1.
+     *
+     * \param[in] _chain The chain.
+     */
+    ChainExpression(const Chain<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain);
+
+    /**
+     * \brief Create new ChainExpression object.
+     *
+     * The expression of a single viewed chain, with factor 1.
+     *
+     * \param[in] _view The viewed chain.
+     */
+    ChainExpression(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view);
+
+    /** \brief Number of terms of the combination. */
+    std::size_t termCount() const noexcept { return terms.size(); }
+
+    /** \brief Get the chain boundary of the result. */
+    int getUpperBound() const noexcept { return upperBound; }
+
+    /**
+     * \brief Checks if the expression is a single scaled chain.
+     *
+     * \return The term if so, null otherwise.
+     */
+    const Term* singleTerm() const noexcept { return terms.size() == 1 ? &terms[0] : nullptr; }
+
+    /**
+     * \brief Writes the combination into a storage, in a single merge.
+     *
+     * The storage may be one of the combined storages.
+     *
+     * \param[out] _storage The storage to overwrite.
+     */
+    void evaluate(_StorageType &_storage) const;
+
+    /**
+     * \brief Combines two expressions.
+     *
+     * \param[in] _first The first expression.
+     * \param[in] _second The second expression.
+     * \param[in] _secondFactor The factor applied to the second expression.
+     *
+     * \return The expression of _first + _secondFactor * _second.
+     */
+    static ChainExpression combine(const ChainExpression &_first, const ChainExpression &_second, const _CoefficientType _secondFactor);
+
+    /**
+     * \brief Scales an expression.
+     *
+     * \param[in] _expression The expression.
+     * \param[in] _lambda The factor applied to every term.
+     *
+     * \return The expression of _lambda * _expression.
+     */
+    static ChainExpression scaled(const ChainExpression &_expression, const _CoefficientType _lambda);
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::ChainExpression(const Chain<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) :
+    upperBound(_chain.upperBound) {
+    terms.push_back(Term{&_chain.chainData, _CoefficientType(1)});
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::ChainExpression(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_view) :
+    upperBound(_view.upperBound) {
+    terms.push_back(Term{_view.chainData, _CoefficientType(1)});
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::evaluate(_StorageType &_storage) const {
+    if (terms.size() == 1) {
+        if (terms[0].storage != &_storage) {
+            _storage = *terms[0].storage;
+        }
+
+        if (terms[0].factor != _CoefficientType(1)) {
+            _storage.scale(terms[0].factor);
+        }
+        return;
+    }
+
+    _storage.assignCombination(terms.data(), terms.size());
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::combine(const ChainExpression &_first, const ChainExpression &_second, const _CoefficientType _secondFactor) {
+    ChainExpression result = _first;
+
+    result.terms.reserve(_first.terms.size() + _second.terms.size());
+    for (const Term &term : _second.terms) {
+        result.terms.push_back(Term{term.storage, term.factor * _secondFactor});
+    }
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType> ChainExpression<_CoefficientType, _ChainTypeFlag, _StorageType>::scaled(const ChainExpression &_expression, const _CoefficientType _lambda) {
+    ChainExpression result = _expression;
+
+    for (Term &term : result.terms) {
+        term.factor *= _lambda;
+    }
+
+    return result;
+}
+
+}
+
+#endif
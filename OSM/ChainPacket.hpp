@@ -0,0 +1,177 @@
+/**
+ * \file ChainPacket.hpp
+ * \brief Fixed-size packets of chain entries, processed together by the sparse kernels.
+ *
+ * Define everything for the ChainPacket class
+ */
+
+#ifndef __OSM_CHAIN_PACKET__
+#define __OSM_CHAIN_PACKET__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "Chain.hpp"
+#include "ChainView.hpp"
+#include "MappedMatrix.hpp"
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class ChainPacket
+ * \brief Compact binary encoding of a sequence of chains, to be sent between processes.
+ *
+ * Each chain is a record made of its index (32-bit), its entry count (32-bit), the indexes of its entries (32-bit)
+ * and their coefficients, encoded as in the binary matrix files: their object representation, nothing for
+ * OSM::Z2Coefficient. A whole packet is thus sent as a single buffer, whatever its number of entries.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of the encoded chains (default is OSM::COLUMN)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::BinaryCoefficient \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ChainPacket {
+
+    static_assert(std::is_trivially_copyable<_CoefficientType>::value, "Packed coefficients must be trivially copyable.");
+
+public:
+    /** \brief The encoded chain type. */
+    typedef Chain<_CoefficientType, _ChainTypeFlag, _StorageType> PacketChain;
+
+private:
+    /** \brief The encoded records. */
+    std::vector<char> bytes;
+
+    /** \brief The number of encoded chains. */
+    std::size_t chainCount;
+
+public:
+    /**
+     * \brief Create new ChainPacket object.
+     *
+     * Default constructor, an empty packet.
+     */
+    ChainPacket() : chainCount(0) {}
+
+    /**
+     * \brief Encodes a chain at the end of the packet.
+     *
+     * \param[in] _index The index identifying the chain.
+     * \param[in] _chain The chain.
+     * \param[in] _shift The value added to the index of each entry (default is 0).
+     */
+    void append(const int _index, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain, const int _shift = 0);
+
+    /**
+     * \brief Decodes every chain of an encoded buffer, in encoding order.
+     *
+     * The entries of each record are appended to the chain given by the target, each chain must end before the
+     * first index of the appended entries. An empty chain always does.
+     *
+     * \warning Will raise an error if the buffer ends inside a record.
+     *
+     * \param[in] _begin The first byte of the buffer.
+     * \param[in] _end The byte after the last byte of the buffer.
+     * \param[in] _target Gives the chain receiving the record of an index, `PacketChain& _target(const int _index)`.
+     */
+    template <typename _Target>
+    static void decode(const char *_begin, const char *_end, const _Target &_target);
+
+    /** \brief Get the encoded records. */
+    const std::vector<char>& getBytes() const noexcept { return bytes; }
+
+    /** \brief Get the size of the encoded records in bytes. */
+    std::size_t size() const noexcept { return bytes.size(); }
+
+    /** \brief Get the number of encoded chains. */
+    std::size_t getChainCount() const noexcept { return chainCount; }
+
+    /** \brief Removes every record, keeping the allocated buffer. */
+    void clear() noexcept { bytes.clear(); chainCount = 0; }
+
+private:
+    /** \brief Appends the object representation of a value. */
+    template <typename _Type>
+    void write(const _Type &_value) {
+        const std::size_t position = bytes.size();
+
+        bytes.resize(position + sizeof(_Type));
+        std::memcpy(bytes.data() + position, &_value, sizeof(_Type));
+    }
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ChainPacket<_CoefficientType, _ChainTypeFlag, _StorageType>::append(const int _index, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain, const int _shift) {
+    const uint32_t entryCount = _chain.size();
+    const std::size_t coefficientSize = BinaryCoefficient<_CoefficientType>::size;
+
+    bytes.reserve(bytes.size() + 2 * sizeof(int32_t) + entryCount * (sizeof(int32_t) + coefficientSize));
+    write(int32_t(_index));
+    write(entryCount);
+
+    for (typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+        write(int32_t(it->first + _shift));
+    }
+
+    if (coefficientSize != 0) {
+        for (typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+            write(_CoefficientType(it->second));
+        }
+    }
+
+    chainCount++;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _Target>
+void ChainPacket<_CoefficientType, _ChainTypeFlag, _StorageType>::decode(const char *_begin, const char *_end, const _Target &_target) {
+    const std::size_t coefficientSize = BinaryCoefficient<_CoefficientType>::size;
+    const char *position = _begin;
+
+    while (position != _end) {
+        int32_t index;
+        uint32_t entryCount;
+
+        if (static_cast<std::size_t>(_end - position) < 2 * sizeof(int32_t)) {
+            throw std::invalid_argument("Truncated chain packet.");
+        }
+        std::memcpy(&index, position, sizeof(int32_t));
+        std::memcpy(&entryCount, position + sizeof(int32_t), sizeof(uint32_t));
+        position += 2 * sizeof(int32_t);
+
+        const char *indexes = position;
+        const char *coefficients = indexes + std::size_t(entryCount) * sizeof(int32_t);
+        position = coefficients + std::size_t(entryCount) * coefficientSize;
+
+        if (position > _end || position < indexes) {
+            throw std::invalid_argument("Truncated chain packet.");
+        }
+
+        PacketChain &chain = _target(index);
+        chain.chainData.reserve(chain.size() + entryCount);
+
+        for (uint32_t entry = 0 ; entry < entryCount ; entry++) {
+            int32_t entryIndex;
+            _CoefficientType coefficient(1);
+
+            std::memcpy(&entryIndex, indexes + entry * sizeof(int32_t), sizeof(int32_t));
+            if (coefficientSize != 0) {
+                std::memcpy(static_cast<void*>(&coefficient), coefficients + entry * coefficientSize, coefficientSize);
+            }
+
+            chain.chainData.append(entryIndex, coefficient);
+        }
+    }
+}
+
+}
+
+#endif
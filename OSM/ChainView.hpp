@@ -0,0 +1,202 @@
+/**
+ * \file ChainView.hpp
+ * \brief Read-only views on chains, returned by the constant matrix accessors without copies.
+ *
+ * Define everything for the ChainView class
+ */
+
+#ifndef __OSM_CHAIN_VIEW__
+#define __OSM_CHAIN_VIEW__
+
+
+#include "__base.hpp"
+#include "Storage.hpp"
+#include "ChainExpression.hpp"
+#include <cstddef>
+
+
+namespace OSM {
+
+/**
+ * \class ChainView
+ * \brief Read-only non-owning view on a chain.
+ *
+ * A view only holds a pointer to the viewed chain storage and the chain boundary, creating or copying it never allocates.
+ * Views are returned by the constant chain accessors of OSM::SparseMatrix and are accepted by the chain arithmetic operators.
+ *
+ * \warning The view is invalidated as soon as the viewed chain is modified or destroyed.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The chain storage policy (default is OSM::DefaultStorage)
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ChainView : public ChainOperators<_CoefficientType, _ChainTypeFlag, _StorageType> {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "A chain is either a column or a row.");
+
+public:
+    typedef typename _StorageType::const_iterator iterator;
+    typedef typename _StorageType::const_iterator const_iterator;
+
+private:
+    /** \brief The viewed chain storage. */
+    const _StorageType *chainData;
+
+    /** \brief The chain boundary. */
+    int upperBound;
+
+public:
+    /**
+     * \brief Create new ChainView object.
+     *
+     * Views the given chain, nothing is copied.
+     *
+     * \param[in] _chain The viewed chain.
+     *
+     * \see \link OSM::Chain \endlink
+     */
+    ChainView(const Chain<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) noexcept;
+
+    /**
+     * \brief Computes the dot product between a row view and a column view.
+     *
+     * \param[in] _row The row view.
+     * \param[in] _column The column view.
+     *
+     * \return The result of type _CoefficientType.
+     *
+     * \see \link OSM::ChainView \endlink
+     */
+    template <typename _CT, typename _ST>
+    friend _CT operator*(const ChainView<_CT, ROW, _ST> &_row, const ChainView<_CT, COLUMN, _ST> &_column);
+
+    /**
+     * \brief Get a coefficient from the viewed chain.
+     *
+     * \param[in] _index The coefficient index.
+     *
+     * \return The coefficient stored in the chain, 0 if not stored.
+     */
+    inline _CoefficientType operator[](const int _index) const;
+
+    /**
+     * \brief Constant iterator to the beginning of the viewed chain.
+     *
+     * \return The constant iterator to the beginning of the chain.
+     */
+    inline const_iterator begin() const noexcept;
+
+    /**
+     * \brief Constant iterator to the beginning of the viewed chain.
+     *
+     * \return The constant iterator to the beginning of the chain.
+     */
+    inline const_iterator cbegin() const noexcept;
+
+    /**
+     * \brief Constant iterator to the ending of the viewed chain.
+     *
+     * \return The constant iterator to the ending of the chain.
+     */
+    inline const_iterator end() const noexcept;
+
+    /**
+     * \brief Constant iterator to the ending of the viewed chain.
+     *
+     * \return The constant iterator to the ending of the chain.
+     */
+    inline const_iterator cend() const noexcept;
+
+    /**
+     * \brief Transpose a view.
+     *
+     * \return A view on the same chain where the chain type flag is changed.
+     */
+    inline ChainView<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> transpose() const noexcept;
+
+    /** \brief Checks if the viewed chain is a column. */
+    bool isColumn() const noexcept { return _ChainTypeFlag == COLUMN; }
+
+    /** \brief Checks if the viewed chain is a row. */
+    bool isRow() const noexcept { return _ChainTypeFlag == ROW; }
+
+    /** \brief Number of coefficients stored in the viewed chain. */
+    inline std::size_t size() const noexcept { return chainData->size(); }
+
+    /** \brief Greatest index stored in the viewed chain, -1 if null. */
+    inline int lastIndex() const noexcept { return chainData->lastIndex(); }
+
+    /** \brief Get the viewed chain boundary. */
+    inline int getUpperBound() const noexcept { return upperBound; }
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class Chain;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ChainView;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class SparseMatrix;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ChainExpression;
+
+private:
+    /**
+     * \brief Create new ChainView object.
+     *
+     * \param[in] _chainData The viewed storage.
+     * \param[in] _upperBound The chain boundary.
+     */
+    ChainView(const _StorageType &_chainData, const int _upperBound) noexcept;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::ChainView(const Chain<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) noexcept :
+    chainData(&_chain.chainData),
+    upperBound(_chain.upperBound) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::ChainView(const _StorageType &_chainData, const int _upperBound) noexcept :
+    chainData(&_chainData),
+    upperBound(_upperBound) {}
+
+template <typename _CT, typename _ST>
+_CT operator*(const ChainView<_CT, ROW, _ST> &_row, const ChainView<_CT, COLUMN, _ST> &_column) {
+    return _ST::dot(*_row.chainData, *_column.chainData);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline _CoefficientType ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    return chainData->get(_index);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::begin() const noexcept {
+    return chainData->begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::cbegin() const noexcept {
+    return chainData->begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::end() const noexcept {
+    return chainData->end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::cend() const noexcept {
+    return chainData->end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline ChainView<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::transpose() const noexcept {
+    return ChainView<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>(*chainData, upperBound);
+}
+
+}
+
+#endif
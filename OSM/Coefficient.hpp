@@ -0,0 +1,393 @@
+/**
+ * \file Coefficient.hpp
+ * \brief Z/2Z and Z/pZ coefficient types, deferred modular sums and exact quotients.
+ *
+ * Define everything for the chain coefficient types
+ */
+
+#ifndef __OSM_COEFFICIENT__
+#define __OSM_COEFFICIENT__
+
+
+#include "__base.hpp"
+#include <climits>
+#include <stdexcept>
+#include <stdint.h>
+
+
+namespace OSM {
+
+/**
+ * \class Z2Coefficient
+ * \brief Coefficients of Z/2Z.
+ *
+ * A single bit, addition and substraction are a XOR and product is an AND.
+ * Integers are converted by their parity, so `Z2Coefficient(-1) == Z2Coefficient(1)`.
+ *
+ * Chains of Z2Coefficient use the OSM::Z2Storage policy by default, which only stores the index set.
+ *
+ * \see \link OSM::Z2Storage \endlink
+ */
+class Z2Coefficient {
+
+private:
+    /** \brief The coefficient bit. */
+    uint8_t value;
+
+public:
+    /**
+     * \brief Create new Z2Coefficient object.
+     *
+     * Default constructor, the null coefficient.
+     */
+    constexpr Z2Coefficient() noexcept : value(0) {}
+
+    /**
+     * \brief Create new Z2Coefficient object.
+     *
+     * \param[in] _value The integer, reduced modulo 2.
+     */
+    constexpr Z2Coefficient(const int _value) noexcept : value(static_cast<uint8_t>(_value & 1)) {}
+
+    /** \brief The coefficient as an integer, 0 or 1. */
+    constexpr explicit operator int() const noexcept { return value; }
+
+    /** \brief Checks if the coefficient is 1. */
+    constexpr explicit operator bool() const noexcept { return value != 0; }
+
+    constexpr Z2Coefficient& operator+=(const Z2Coefficient _other) noexcept { value ^= _other.value; return *this; }
+    constexpr Z2Coefficient& operator-=(const Z2Coefficient _other) noexcept { value ^= _other.value; return *this; }
+    constexpr Z2Coefficient& operator*=(const Z2Coefficient _other) noexcept { value &= _other.value; return *this; }
+
+    friend constexpr Z2Coefficient operator+(Z2Coefficient _first, const Z2Coefficient _second) noexcept { return _first += _second; }
+    friend constexpr Z2Coefficient operator-(Z2Coefficient _first, const Z2Coefficient _second) noexcept { return _first -= _second; }
+    friend constexpr Z2Coefficient operator*(Z2Coefficient _first, const Z2Coefficient _second) noexcept { return _first *= _second; }
+    friend constexpr Z2Coefficient operator-(const Z2Coefficient _coefficient) noexcept { return _coefficient; }
+
+    friend constexpr bool operator==(const Z2Coefficient _first, const Z2Coefficient _second) noexcept { return _first.value == _second.value; }
+    friend constexpr bool operator!=(const Z2Coefficient _first, const Z2Coefficient _second) noexcept { return _first.value != _second.value; }
+};
+
+/**
+ * \class ZpCoefficient
+ * \brief Coefficients of the finite field Z/pZ.
+ *
+ * The value is kept reduced in [0, p), every constant of the reduction is computed at compile time for the prime:
+ * sums and differences use a branch-free conditional correction, products a Barrett reduction and inverses
+ * a precomputed table for small primes (a Fermat exponentiation otherwise).
+ *
+ * Sums of products can skip the reduction through OSM::DeferredReduction, as done by OSM::SparseAccumulator.
+ *
+ * \tparam _Prime The prime modulus, lower than 2^31.
+ *
+ * \see \link OSM::DeferredReduction \endlink
+ */
+template <uint32_t _Prime>
+class ZpCoefficient {
+
+    /** \brief Trial division primality test, evaluated at compile time. */
+    static constexpr bool isPrime(const uint32_t _number) {
+        if (_number < 2) {
+            return false;
+        }
+
+        for (uint64_t divisor = 2 ; divisor * divisor <= _number ; divisor++) {
+            if (_number % divisor == 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(_Prime < (uint32_t(1) << 31), "The modulus must be lower than 2^31.");
+    static_assert(isPrime(_Prime), "The modulus must be prime.");
+
+public:
+    /** \brief The prime modulus. */
+    static constexpr uint32_t MODULUS = _Prime;
+
+    /** \brief The largest prime whose inverses are stored in a table. */
+    static constexpr uint32_t INVERSE_TABLE_LIMIT = 1 << 12;
+
+private:
+    /** \brief The Barrett factor, floor(2^64 / p). */
+    static constexpr uint64_t BARRETT_FACTOR = ~uint64_t(0) / _Prime;
+
+    /** \brief The inverses table, a single entry when the prime is too large. */
+    struct InverseTable {
+        uint32_t inverses[_Prime <= INVERSE_TABLE_LIMIT ? _Prime : 1];
+
+        constexpr InverseTable() : inverses() {
+            if (_Prime <= INVERSE_TABLE_LIMIT && _Prime > 1) {
+                // inverse(i) = -(p / i) * inverse(p mod i), as p = (p / i) * i + p mod i.
+                inverses[1] = 1;
+                for (uint32_t index = 2 ; index < _Prime ; index++) {
+                    inverses[index] = static_cast<uint32_t>(
+                        (_Prime - uint64_t(_Prime / index) * inverses[_Prime % index] % _Prime) % _Prime
+                    );
+                }
+            }
+        }
+    };
+
+    static constexpr InverseTable INVERSES = InverseTable();
+
+    /** \brief The reduced value. */
+    uint32_t value;
+
+public:
+    /**
+     * \brief Create new ZpCoefficient object.
+     *
+     * Default constructor, the null coefficient.
+     */
+    constexpr ZpCoefficient() noexcept : value(0) {}
+
+    /**
+     * \brief Create new ZpCoefficient object.
+     *
+     * \param[in] _value The integer, reduced modulo p, negative integers included.
+     */
+    constexpr ZpCoefficient(const int _value) noexcept : value(0) {
+        const int64_t remainder = int64_t(_value) % int64_t(_Prime);
+        value = static_cast<uint32_t>(remainder < 0 ? remainder + _Prime : remainder);
+    }
+
+    /**
+     * \brief Create a coefficient from an already reduced value.
+     *
+     * \pre _value is lower than p.
+     *
+     * \param[in] _value The reduced value.
+     *
+     * \return The coefficient.
+     */
+    static constexpr ZpCoefficient fromReduced(const uint32_t _value) noexcept {
+        ZpCoefficient result;
+        result.value = _value;
+        return result;
+    }
+
+    /**
+     * \brief Reduces a 64-bit integer modulo p.
+     *
+     * Barrett reduction, the remainder estimate is at most p too large and corrected without branching.
+     *
+     * \param[in] _value The integer.
+     *
+     * \return The reduced value.
+     */
+    static constexpr uint32_t reduce(const uint64_t _value) noexcept {
+#if defined(__SIZEOF_INT128__)
+        const uint64_t quotient = static_cast<uint64_t>((static_cast<unsigned __int128>(_value) * BARRETT_FACTOR) >> 64);
+        uint64_t remainder = _value - quotient * _Prime;
+        remainder -= _Prime & (uint64_t(0) - uint64_t(remainder >= _Prime));
+        return static_cast<uint32_t>(remainder);
+#else
+        return static_cast<uint32_t>(_value % _Prime);
+#endif
+    }
+
+    /** \brief The reduced value, in [0, p). */
+    constexpr uint32_t reduced() const noexcept { return value; }
+
+    /** \brief The coefficient as an integer, in [0, p). */
+    constexpr explicit operator int() const noexcept { return static_cast<int>(value); }
+
+    /**
+     * \brief Multiplicative inverse.
+     *
+     * \pre The coefficient is not 0.
+     *
+     * \return The inverse, 0 for 0.
+     */
+    constexpr ZpCoefficient inverse() const noexcept {
+        if constexpr (_Prime <= INVERSE_TABLE_LIMIT) {
+            return fromReduced(INVERSES.inverses[value]);
+        } else {
+            // Fermat: a^(p - 2) is the inverse of a.
+            ZpCoefficient result = fromReduced(1);
+            ZpCoefficient base = *this;
+
+            for (uint32_t exponent = _Prime - 2 ; exponent != 0 ; exponent >>= 1) {
+                if (exponent & 1) {
+                    result *= base;
+                }
+                base *= base;
+            }
+
+            return result;
+        }
+    }
+
+    constexpr ZpCoefficient& operator+=(const ZpCoefficient _other) noexcept {
+        const uint32_t sum = value + _other.value;
+        value = sum - (_Prime & (uint32_t(0) - uint32_t(sum >= _Prime)));
+        return *this;
+    }
+
+    constexpr ZpCoefficient& operator-=(const ZpCoefficient _other) noexcept {
+        const uint32_t difference = value - _other.value;
+        value = difference + (_Prime & (uint32_t(0) - uint32_t(value < _other.value)));
+        return *this;
+    }
+
+    constexpr ZpCoefficient& operator*=(const ZpCoefficient _other) noexcept {
+        value = reduce(uint64_t(value) * _other.value);
+        return *this;
+    }
+
+    constexpr ZpCoefficient& operator/=(const ZpCoefficient _other) noexcept {
+        return *this *= _other.inverse();
+    }
+
+    friend constexpr ZpCoefficient operator+(ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first += _second; }
+    friend constexpr ZpCoefficient operator-(ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first -= _second; }
+    friend constexpr ZpCoefficient operator*(ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first *= _second; }
+    friend constexpr ZpCoefficient operator/(ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first /= _second; }
+    friend constexpr ZpCoefficient operator-(const ZpCoefficient _coefficient) noexcept { return ZpCoefficient() - _coefficient; }
+
+    friend constexpr bool operator==(const ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first.value == _second.value; }
+    friend constexpr bool operator!=(const ZpCoefficient _first, const ZpCoefficient _second) noexcept { return _first.value != _second.value; }
+};
+
+/**
+ * \brief Deferred reduction of sums of products.
+ *
+ * Accumulating `sum += a * b` reduces after each product for most coefficient types. The accumulator type of
+ * this trait holds unreduced sums instead, reduced once when read. The generic version is the coefficient type itself.
+ *
+ * \tparam _CoefficientType The chain's coefficient types.
+ *
+ * \see \link OSM::SparseAccumulator \endlink
+ */
+template <typename _CoefficientType>
+struct DeferredReduction {
+    /** \brief The unreduced sum type. */
+    typedef _CoefficientType accumulator_type;
+
+    /** \brief Lift a coefficient to an unreduced sum. */
+    static constexpr accumulator_type lift(const _CoefficientType _value) noexcept { return _value; }
+
+    /** \brief Adds the product of two coefficients to an unreduced sum. */
+    static constexpr void accumulate(accumulator_type &_sum, const _CoefficientType _first, const _CoefficientType _second) noexcept { _sum += _first * _second; }
+
+    /** \brief Adds a coefficient to an unreduced sum. */
+    static constexpr void accumulate(accumulator_type &_sum, const _CoefficientType _value) noexcept { _sum += _value; }
+
+    /** \brief Reduces a sum to a coefficient. */
+    static constexpr _CoefficientType reduce(const accumulator_type _sum) noexcept { return _sum; }
+};
+
+/**
+ * \brief Deferred reduction of sums of products of Z/pZ coefficients.
+ *
+ * Products are summed unreduced in 64 bits, a single modular reduction is only performed when the sum could overflow,
+ * that is after about 2^64 / p^2 products, and when the sum is read.
+ *
+ * \tparam _Prime The prime modulus.
+ */
+template <uint32_t _Prime>
+struct DeferredReduction<ZpCoefficient<_Prime>> {
+    typedef uint64_t accumulator_type;
+
+    /** \brief A sum above this bound may overflow with the next product. */
+    static constexpr uint64_t OVERFLOW_BOUND = ~uint64_t(0) - uint64_t(_Prime - 1) * (_Prime - 1);
+
+    static constexpr accumulator_type lift(const ZpCoefficient<_Prime> _value) noexcept { return _value.reduced(); }
+
+    static constexpr void accumulate(accumulator_type &_sum, const ZpCoefficient<_Prime> _first, const ZpCoefficient<_Prime> _second) noexcept {
+        if (_sum > OVERFLOW_BOUND) {
+            _sum = ZpCoefficient<_Prime>::reduce(_sum);
+        }
+        _sum += uint64_t(_first.reduced()) * _second.reduced();
+    }
+
+    static constexpr void accumulate(accumulator_type &_sum, const ZpCoefficient<_Prime> _value) noexcept {
+        if (_sum > OVERFLOW_BOUND) {
+            _sum = ZpCoefficient<_Prime>::reduce(_sum);
+        }
+        _sum += _value.reduced();
+    }
+
+    static constexpr ZpCoefficient<_Prime> reduce(const accumulator_type _sum) noexcept {
+        return ZpCoefficient<_Prime>::fromReduced(ZpCoefficient<_Prime>::reduce(_sum));
+    }
+};
+
+/**
+ * \brief Exact quotient of two coefficients.
+ *
+ * Used to cancel a pivot: `_dividend - exactQuotient(_dividend, _divisor) * _divisor` is 0.
+ * Fields (OSM::Z2Coefficient, OSM::ZpCoefficient) divide any coefficient by a non zero one.
+ *
+ * \warning Will raise an error if the divisor is 0.
+ *
+ * \param[in] _dividend The coefficient to cancel.
+ * \param[in] _divisor The pivot coefficient.
+ *
+ * \return The quotient.
+ */
+template <typename _CoefficientType>
+_CoefficientType exactQuotient(const _CoefficientType _dividend, const _CoefficientType _divisor) {
+    if (_divisor == _CoefficientType(0)) {
+        throw std::domain_error("Division by a null coefficient.");
+    }
+
+    return _dividend / _divisor;
+}
+
+/**
+ * \brief Exact quotient of two integers.
+ *
+ * \warning Will raise an error if the divisor does not divide the dividend, Z is not a field.
+ * \warning Will raise an error if the quotient overflows int, INT_MIN divided by -1.
+ *
+ * \param[in] _dividend The coefficient to cancel.
+ * \param[in] _divisor The pivot coefficient.
+ *
+ * \return The quotient.
+ */
+inline int exactQuotient(const int _dividend, const int _divisor) {
+    if (_divisor == 0) {
+        throw std::domain_error("The coefficient is not divisible by the pivot.");
+    }
+
+    // INT_MIN / -1 is undefined, the quotient is a negation checked for overflow
+    if (_divisor == -1) {
+        if (_dividend == INT_MIN) {
+            throw std::overflow_error("The quotient overflows the coefficient type.");
+        }
+
+        return -_dividend;
+    }
+
+    if (_dividend % _divisor != 0) {
+        throw std::domain_error("The coefficient is not divisible by the pivot.");
+    }
+
+    return _dividend / _divisor;
+}
+
+/**
+ * \brief Exact quotient of two Z/2Z coefficients.
+ *
+ * \warning Will raise an error if the divisor is 0.
+ *
+ * \param[in] _dividend The coefficient to cancel.
+ * \param[in] _divisor The pivot coefficient.
+ *
+ * \return The quotient, the dividend itself.
+ */
+inline Z2Coefficient exactQuotient(const Z2Coefficient _dividend, const Z2Coefficient _divisor) {
+    if (_divisor == Z2Coefficient(0)) {
+        throw std::domain_error("Division by a null coefficient.");
+    }
+
+    return _dividend;
+}
+
+}
+
+#endif
@@ -0,0 +1,673 @@
+/**
+ * \file DistributedMatrix.hpp
+ * \brief Sparse matrices partitioned in column blocks over MPI processes.
+ *
+ * Define everything for the DistributedMatrix class
+ */
+
+#ifndef __OSM_DISTRIBUTED_MATRIX__
+#define __OSM_DISTRIBUTED_MATRIX__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "Chain.hpp"
+#include "ChainPacket.hpp"
+#include "SparseAccumulator.hpp"
+#include "SparseMatrix.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <mpi.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class DistributedMatrix
+ * \brief Sparse matrix whose chains are partitioned in contiguous blocks across the ranks of an MPI communicator.
+ *
+ * Each rank stores the chains of its block in a local OSM::SparseMatrix, indexed from the first chain of the block.
+ * The chains of other ranks are exchanged as OSM::ChainPacket buffers, a single all-to-all exchange moving any number
+ * of chains. Every method taking part in an exchange is collective: all the ranks of the communicator must call it,
+ * in the same order.
+ *
+ * The product of two column (row) based matrices fetches the left (right) operand chains referenced by the local
+ * chains of the other operand. The reorientation sends each piece of chain to the rank owning the new chain, the
+ * transpose of a matrix with the same chain type is thus `reoriented().transpose()`.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of the distributed chains (default is OSM::COLUMN)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::SparseMatrix \endlink
+ * \see \link OSM::DistributedReduction \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class DistributedMatrix {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "A distributed matrix partitions either columns or rows.");
+
+public:
+    /** \brief The local matrix type, storing the chains of the rank. */
+    typedef SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> LocalMatrix;
+
+    /** \brief The distributed chain type. */
+    typedef Chain<_CoefficientType, _ChainTypeFlag, _StorageType> MatrixChain;
+
+    /** \brief The packet type exchanged between ranks. */
+    typedef ChainPacket<_CoefficientType, _ChainTypeFlag, _StorageType> Packet;
+
+private:
+    /** \brief The communicator of the ranks sharing the matrix. */
+    MPI_Comm communicator;
+
+    /** \brief The rank of the calling process. */
+    int rank;
+
+    /** \brief The number of ranks. */
+    int rankCount;
+
+    /** \brief The number of rows of the matrix. */
+    int rowCount;
+
+    /** \brief The number of columns of the matrix. */
+    int columnCount;
+
+    /** \brief The first chain of each rank, followed by the chain count. */
+    std::vector<int> boundaries;
+
+    /** \brief The chains of the rank, indexed from its first chain. */
+    LocalMatrix local;
+
+public:
+    /**
+     * \brief Create new DistributedMatrix object.
+     *
+     * A null matrix, its chains split in blocks of equal size.
+     *
+     * \warning Will raise an error if a dimension is negative.
+     *
+     * \param[in] _communicator The communicator of the ranks sharing the matrix.
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     */
+    DistributedMatrix(MPI_Comm _communicator, const int _rowCount, const int _columnCount);
+
+    /**
+     * \brief Create new DistributedMatrix object.
+     *
+     * A null matrix, its chains split at given boundaries.
+     *
+     * \warning Will raise an error if a dimension is negative.
+     * \warning Will raise an error if the boundaries are not rankCount + 1 non decreasing values from 0 to the chain count.
+     *
+     * \param[in] _communicator The communicator of the ranks sharing the matrix.
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _boundaries The first chain of each rank, followed by the chain count.
+     */
+    DistributedMatrix(MPI_Comm _communicator, const int _rowCount, const int _columnCount, const std::vector<int> &_boundaries);
+
+    /**
+     * \brief Splits the chains of a matrix held by one rank across all the ranks. Collective.
+     *
+     * \param[in] _communicator The communicator of the ranks sharing the matrix.
+     * \param[in] _matrix The matrix, only read on the root rank.
+     * \param[in] _root The rank holding the matrix (default is 0).
+     *
+     * \return The distributed matrix, in blocks of equal size.
+     */
+    static DistributedMatrix scatter(MPI_Comm _communicator, const LocalMatrix &_matrix, const int _root = 0);
+
+    /**
+     * \brief Gathers the whole matrix on one rank. Collective.
+     *
+     * \param[in] _root The rank receiving the matrix (default is 0).
+     *
+     * \return The matrix on the root rank, an empty matrix on the others.
+     */
+    LocalMatrix gather(const int _root = 0) const;
+
+    /**
+     * \brief Splits a number of chains in blocks of equal size.
+     *
+     * \param[in] _chainCount The number of chains.
+     * \param[in] _rankCount The number of ranks.
+     *
+     * \return The first chain of each rank, followed by the chain count.
+     */
+    static std::vector<int> uniformBoundaries(const int _chainCount, const int _rankCount);
+
+    /**
+     * \brief Get a chain of the rank.
+     *
+     * \warning Will raise an error if the chain is not stored by the rank.
+     *
+     * \param[in] _index The global chain index.
+     *
+     * \return A view on the chain.
+     */
+    ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> operator[](const int _index) const;
+
+    /**
+     * \brief Set a chain of the rank.
+     *
+     * \warning Will raise an error if the chain is not stored by the rank.
+     *
+     * \param[in] _index The global chain index.
+     * \param[in] _chain The new chain, or a view on it.
+     */
+    void setChain(const int _index, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain);
+
+    /**
+     * \brief Fetches chains stored by other ranks. Collective.
+     *
+     * \param[in] _indexes The global indexes of the chains needed by the rank, the ones it stores are ignored.
+     *
+     * \return The fetched chains by global index.
+     */
+    std::unordered_map<int, MatrixChain> fetchChains(const std::vector<int> &_indexes) const;
+
+    /**
+     * \brief Sends one packet to each rank and receives the packets sent to this one. Collective.
+     *
+     * \warning Will raise an error if there is not one packet per rank.
+     * \warning Will raise an error if the rank sends or receives 2 GiB or more.
+     *
+     * \param[in] _packets The packet sent to each rank, may be empty.
+     *
+     * \return The received records, by increasing sending rank, to be read with OSM::ChainPacket::decode.
+     */
+    std::vector<char> exchange(const std::vector<Packet> &_packets) const;
+
+    /**
+     * \brief Reorients the matrix, its chains partitioned across the ranks by the other dimension. Collective.
+     *
+     * \warning Will raise an error if the boundaries are not rankCount + 1 non decreasing values from 0 to the new chain count.
+     *
+     * \param[in] _boundaries The first new chain of each rank, followed by the new chain count (default is blocks of equal size).
+     *
+     * \return The same matrix distributed by rows if it was by columns, and conversely.
+     */
+    DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> reoriented(const std::vector<int> &_boundaries = std::vector<int>()) const;
+
+    /**
+     * \brief Transposes the matrix, the local chains changing of type without any exchange.
+     *
+     * \return The transposed matrix, distributed by rows if the matrix is distributed by columns, and conversely.
+     */
+    DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> transpose() const;
+
+    /**
+     * \brief Get the total number of non null coefficients. Collective.
+     *
+     * \return The number of entries over all the ranks.
+     */
+    uint64_t getEntryCount() const;
+
+    /**
+     * \brief Distributed matrix product. Collective.
+     *
+     * The result is distributed as the right operand for column based matrices, as the left one for row based matrices.
+     * The chains of each rank are computed on the thread pool of its local matrix.
+     *
+     * \warning Will raise an error if the dimensions or the communicators sizes do not match.
+     *
+     * \param[in] _first The left operand.
+     * \param[in] _second The right operand.
+     *
+     * \return The product.
+     */
+    friend DistributedMatrix operator*(const DistributedMatrix &_first, const DistributedMatrix &_second) { return multiply(_first, _second); }
+
+    /** \brief Get the local matrix, the chains of the rank indexed from its first chain. */
+    const LocalMatrix& getLocal() const noexcept { return local; }
+
+    /** \brief Get the local matrix, the chains of the rank indexed from its first chain. */
+    LocalMatrix& getLocal() noexcept { return local; }
+
+    /** \brief Get the communicator of the ranks sharing the matrix. */
+    MPI_Comm getCommunicator() const noexcept { return communicator; }
+
+    /** \brief Get the rank of the calling process. */
+    int getRank() const noexcept { return rank; }
+
+    /** \brief Get the number of ranks. */
+    int getRankCount() const noexcept { return rankCount; }
+
+    /** \brief Get the number of rows of the matrix. */
+    int getRowCount() const noexcept { return rowCount; }
+
+    /** \brief Get the number of columns of the matrix. */
+    int getColumnCount() const noexcept { return columnCount; }
+
+    /** \brief Get the number of chains of the matrix. */
+    int getChainCount() const noexcept { return _ChainTypeFlag == COLUMN ? columnCount : rowCount; }
+
+    /** \brief Get the first chain of each rank, followed by the chain count. */
+    const std::vector<int>& getBoundaries() const noexcept { return boundaries; }
+
+    /** \brief Get the first chain stored by the rank. */
+    int getFirstChain() const noexcept { return boundaries[rank]; }
+
+    /** \brief Get the chain after the last one stored by the rank. */
+    int getLastChain() const noexcept { return boundaries[rank + 1]; }
+
+    /** \brief Checks if a chain is stored by the rank. */
+    bool isLocal(const int _index) const noexcept { return _index >= getFirstChain() && _index < getLastChain(); }
+
+    /**
+     * \brief Get the rank storing a chain.
+     *
+     * \warning Will raise an error if the index is out of the matrix.
+     *
+     * \param[in] _index The global chain index.
+     *
+     * \return The rank storing the chain.
+     */
+    int getOwner(const int _index) const;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class DistributedMatrix;
+
+    template <typename _CT, typename _ST>
+    friend class DistributedReduction;
+
+private:
+    /** \brief Computes the product of two distributed matrices. */
+    static DistributedMatrix multiply(const DistributedMatrix &_first, const DistributedMatrix &_second);
+
+    /** \brief Checks the boundaries of a partition. */
+    static void checkBoundaries(const std::vector<int> &_boundaries, const int _chainCount, const int _rankCount);
+
+    /** \brief Exchanges one array of values with each rank, the received arrays are concatenated by sending rank. */
+    template <typename _Type>
+    std::vector<_Type> exchangeValues(const std::vector<std::vector<_Type>> &_values, std::vector<std::size_t> &_offsets) const;
+
+    /** \brief Exchanges byte buffers, the received buffers are concatenated by sending rank, with their offsets. */
+    std::vector<char> exchangeBytes(const std::vector<const char*> &_data, const std::vector<std::size_t> &_sizes, std::vector<std::size_t> &_offsets) const;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::DistributedMatrix(MPI_Comm _communicator, const int _rowCount, const int _columnCount) :
+    DistributedMatrix(_communicator, _rowCount, _columnCount, std::vector<int>()) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::DistributedMatrix(MPI_Comm _communicator, const int _rowCount, const int _columnCount, const std::vector<int> &_boundaries) :
+    communicator(_communicator),
+    rowCount(_rowCount),
+    columnCount(_columnCount) {
+    if (_rowCount < 0 || _columnCount < 0) {
+        throw std::invalid_argument("Matrix dimensions must be non negative.");
+    }
+
+    MPI_Comm_rank(communicator, &rank);
+    MPI_Comm_size(communicator, &rankCount);
+
+    if (_boundaries.empty()) {
+        boundaries = uniformBoundaries(getChainCount(), rankCount);
+    } else {
+        checkBoundaries(_boundaries, getChainCount(), rankCount);
+        boundaries = _boundaries;
+    }
+
+    const int localCount = getLastChain() - getFirstChain();
+    local = _ChainTypeFlag == COLUMN ? LocalMatrix(rowCount, localCount) : LocalMatrix(localCount, columnCount);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::vector<int> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::uniformBoundaries(const int _chainCount, const int _rankCount) {
+    std::vector<int> result(_rankCount + 1);
+
+    for (int rank = 0 ; rank <= _rankCount ; rank++) {
+        result[rank] = static_cast<int>(static_cast<int64_t>(_chainCount) * rank / _rankCount);
+    }
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::checkBoundaries(const std::vector<int> &_boundaries, const int _chainCount, const int _rankCount) {
+    if (static_cast<int>(_boundaries.size()) != _rankCount + 1 || _boundaries.front() != 0 || _boundaries.back() != _chainCount) {
+        throw std::invalid_argument("The boundaries must go from 0 to the chain count, one block per rank.");
+    }
+
+    for (int rank = 0 ; rank < _rankCount ; rank++) {
+        if (_boundaries[rank] > _boundaries[rank + 1]) {
+            throw std::invalid_argument("The boundaries must be non decreasing.");
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+int DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getOwner(const int _index) const {
+    if (_index < 0 || _index >= getChainCount()) {
+        throw std::out_of_range("Chain index out of the distributed matrix.");
+    }
+
+    // The owner is the last rank whose block begins at or before the index, empty blocks are skipped
+    return std::upper_bound(boundaries.begin(), boundaries.end(), _index) - boundaries.begin() - 1;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    if (!isLocal(_index)) {
+        throw std::out_of_range("Chain not stored by this rank.");
+    }
+
+    return local.chains[_index - getFirstChain()];
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::setChain(const int _index, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) {
+    if (!isLocal(_index)) {
+        throw std::out_of_range("Chain not stored by this rank.");
+    }
+
+    if constexpr (_ChainTypeFlag == COLUMN) {
+        local.setColumn(_index - getFirstChain(), _chain);
+    } else {
+        local.setRow(_index - getFirstChain(), _chain);
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::vector<char> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::exchangeBytes(const std::vector<const char*> &_data, const std::vector<std::size_t> &_sizes, std::vector<std::size_t> &_offsets) const {
+    std::vector<uint64_t> sentSizes(_sizes.begin(), _sizes.end());
+    std::vector<uint64_t> receivedSizes(rankCount);
+
+    MPI_Alltoall(sentSizes.data(), 1, MPI_UINT64_T, receivedSizes.data(), 1, MPI_UINT64_T, communicator);
+
+    std::vector<int> sentCounts(rankCount), sentOffsets(rankCount), receivedCounts(rankCount), receivedOffsets(rankCount);
+    uint64_t sentTotal = 0;
+    uint64_t receivedTotal = 0;
+
+    _offsets.assign(rankCount + 1, 0);
+    for (int other = 0 ; other < rankCount ; other++) {
+        sentCounts[other] = static_cast<int>(sentSizes[other]);
+        sentOffsets[other] = static_cast<int>(sentTotal);
+        receivedCounts[other] = static_cast<int>(receivedSizes[other]);
+        receivedOffsets[other] = static_cast<int>(receivedTotal);
+
+        sentTotal += sentSizes[other];
+        receivedTotal += receivedSizes[other];
+        _offsets[other + 1] = receivedTotal;
+    }
+
+    // Checked by every rank before any of them reaches the exchange, so that none of them is left waiting
+    int overflow = sentTotal > uint64_t(INT_MAX) || receivedTotal > uint64_t(INT_MAX);
+    MPI_Allreduce(MPI_IN_PLACE, &overflow, 1, MPI_INT, MPI_LOR, communicator);
+    if (overflow) {
+        throw std::length_error("A rank cannot exchange 2 GiB or more at once.");
+    }
+
+    std::vector<char> sent(sentTotal);
+    for (int other = 0 ; other < rankCount ; other++) {
+        if (_sizes[other] != 0) {
+            std::memcpy(sent.data() + sentOffsets[other], _data[other], _sizes[other]);
+        }
+    }
+
+    std::vector<char> received(receivedTotal);
+    MPI_Alltoallv(sent.data(), sentCounts.data(), sentOffsets.data(), MPI_BYTE, received.data(), receivedCounts.data(), receivedOffsets.data(), MPI_BYTE, communicator);
+
+    return received;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _Type>
+std::vector<_Type> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::exchangeValues(const std::vector<std::vector<_Type>> &_values, std::vector<std::size_t> &_offsets) const {
+    std::vector<const char*> data(rankCount);
+    std::vector<std::size_t> sizes(rankCount);
+
+    for (int other = 0 ; other < rankCount ; other++) {
+        data[other] = reinterpret_cast<const char*>(_values[other].data());
+        sizes[other] = _values[other].size() * sizeof(_Type);
+    }
+
+    const std::vector<char> bytes = exchangeBytes(data, sizes, _offsets);
+    std::vector<_Type> result(bytes.size() / sizeof(_Type));
+
+    if (!bytes.empty()) {
+        std::memcpy(static_cast<void*>(result.data()), bytes.data(), bytes.size());
+    }
+    for (std::size_t &offset : _offsets) {
+        offset /= sizeof(_Type);
+    }
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::vector<char> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::exchange(const std::vector<Packet> &_packets) const {
+    if (static_cast<int>(_packets.size()) != rankCount) {
+        throw std::invalid_argument("One packet must be given for each rank.");
+    }
+
+    std::vector<const char*> data(rankCount);
+    std::vector<std::size_t> sizes(rankCount);
+    std::vector<std::size_t> offsets;
+
+    for (int other = 0 ; other < rankCount ; other++) {
+        data[other] = _packets[other].getBytes().data();
+        sizes[other] = _packets[other].size();
+    }
+
+    return exchangeBytes(data, sizes, offsets);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::unordered_map<int, typename DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::MatrixChain> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::fetchChains(const std::vector<int> &_indexes) const {
+    std::vector<std::vector<int>> requests(rankCount);
+    std::vector<int> indexes(_indexes);
+
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+    for (int index : indexes) {
+        const int owner = getOwner(index);
+
+        if (owner != rank) {
+            requests[owner].push_back(index);
+        }
+    }
+
+    // Each rank learns which of its chains are requested, then answers every rank with a single packet
+    std::vector<std::size_t> offsets;
+    const std::vector<int> requested = exchangeValues(requests, offsets);
+    std::vector<Packet> answers(rankCount);
+
+    for (int other = 0 ; other < rankCount ; other++) {
+        for (std::size_t request = offsets[other] ; request < offsets[other + 1] ; request++) {
+            answers[other].append(requested[request], local.chains[requested[request] - getFirstChain()]);
+        }
+    }
+
+    const std::vector<char> received = exchange(answers);
+    const int chainSize = _ChainTypeFlag == COLUMN ? rowCount : columnCount;
+    std::unordered_map<int, MatrixChain> result;
+
+    Packet::decode(received.data(), received.data() + received.size(), [&](const int _index) -> MatrixChain& {
+        return result.emplace(_index, MatrixChain(chainSize)).first->second;
+    });
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::scatter(MPI_Comm _communicator, const LocalMatrix &_matrix, const int _root) {
+    int rank;
+    int dimensions[2] = {_matrix.getRowCount(), _matrix.getColumnCount()};
+
+    MPI_Comm_rank(_communicator, &rank);
+    MPI_Bcast(dimensions, 2, MPI_INT, _root, _communicator);
+
+    DistributedMatrix result(_communicator, dimensions[0], dimensions[1]);
+    std::vector<Packet> packets(result.rankCount);
+
+    if (rank == _root) {
+        for (int other = 0 ; other < result.rankCount ; other++) {
+            for (int index = result.boundaries[other] ; index < result.boundaries[other + 1] ; index++) {
+                packets[other].append(index, _matrix.chains[index]);
+            }
+        }
+    }
+
+    const std::vector<char> received = result.exchange(packets);
+    Packet::decode(received.data(), received.data() + received.size(), [&](const int _index) -> MatrixChain& {
+        return result.local.chains[_index - result.getFirstChain()];
+    });
+    result.local.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::LocalMatrix DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::gather(const int _root) const {
+    std::vector<Packet> packets(rankCount);
+
+    for (int index = getFirstChain() ; index < getLastChain() ; index++) {
+        packets[_root].append(index, local.chains[index - getFirstChain()]);
+    }
+
+    const std::vector<char> received = exchange(packets);
+
+    if (rank != _root) {
+        return LocalMatrix(0, 0);
+    }
+
+    LocalMatrix result(rowCount, columnCount);
+    Packet::decode(received.data(), received.data() + received.size(), [&](const int _index) -> MatrixChain& {
+        return result.chains[_index];
+    });
+    result.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::reoriented(const std::vector<int> &_boundaries) const {
+    DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> result(communicator, rowCount, columnCount, _boundaries);
+    typedef typename DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>::Packet TransposedPacket;
+    typedef typename DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>::MatrixChain TransposedChain;
+
+    // The local pieces of the new chains, indexed from the first chain of the rank
+    const SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> pieces = local.reoriented();
+    std::vector<TransposedPacket> packets(rankCount);
+
+    for (int other = 0 ; other < rankCount ; other++) {
+        for (int index = result.boundaries[other] ; index < result.boundaries[other + 1] ; index++) {
+            if (pieces.chains[index].size() != 0) {
+                packets[other].append(index, pieces.chains[index], getFirstChain());
+            }
+        }
+    }
+
+    // The pieces arrive by increasing sending rank, their indexes are increasing and append in order
+    const std::vector<char> received = result.exchange(packets);
+    TransposedPacket::decode(received.data(), received.data() + received.size(), [&](const int _index) -> TransposedChain& {
+        return result.local.chains[_index - result.getFirstChain()];
+    });
+    result.local.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::transpose() const {
+    DistributedMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> result(communicator, columnCount, rowCount, boundaries);
+
+    result.local = local.transpose();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+uint64_t DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getEntryCount() const {
+    uint64_t count = 0;
+
+    for (const MatrixChain &chain : local.chains) {
+        count += chain.size();
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_UINT64_T, MPI_SUM, communicator);
+
+    return count;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> DistributedMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::multiply(const DistributedMatrix &_first, const DistributedMatrix &_second) {
+    if (_first.columnCount != _second.rowCount) {
+        throw std::invalid_argument("Matrices dimensions do not match.");
+    }
+
+    if (_first.rankCount != _second.rankCount) {
+        throw std::invalid_argument("Matrices must be distributed over the same ranks.");
+    }
+
+    // Each outer chain combines the inner chains of its entries, the result is distributed as the outer operand
+    const DistributedMatrix &inner = _ChainTypeFlag == COLUMN ? _first : _second;
+    const DistributedMatrix &outer = _ChainTypeFlag == COLUMN ? _second : _first;
+    DistributedMatrix result(outer.communicator, _first.rowCount, _second.columnCount, outer.boundaries);
+
+    std::vector<int> needed;
+    for (const MatrixChain &chain : outer.local.chains) {
+        for (typename MatrixChain::const_iterator it = chain.cbegin() ; it != chain.cend() ; ++it) {
+            if (!inner.isLocal(it->first)) {
+                needed.push_back(it->first);
+            }
+        }
+    }
+
+    const std::unordered_map<int, MatrixChain> fetched = inner.fetchChains(needed);
+    const int chainSize = _ChainTypeFlag == COLUMN ? result.rowCount : result.columnCount;
+    const std::size_t chainCount = outer.local.chains.size();
+    ThreadPool *pool = outer.local.getThreadPool();
+
+    std::vector<std::size_t> weights(chainCount, 0);
+
+    for (std::size_t index = 0 ; index < chainCount ; index++) {
+        const MatrixChain &chain = outer.local.chains[index];
+
+        for (typename MatrixChain::const_iterator it = chain.cbegin() ; it != chain.cend() ; ++it) {
+            weights[index] += inner.isLocal(it->first) ? inner.local.chains[it->first - inner.getFirstChain()].size() : fetched.at(it->first).size();
+        }
+    }
+
+    std::vector<SparseAccumulator<_CoefficientType>> accumulators(pool != nullptr ? pool->size() : 1);
+
+    ThreadPool::forEachWeighted(pool, weights, [&](const std::size_t _index, const std::size_t _worker) {
+        if (weights[_index] == 0) {
+            return;
+        }
+
+        SparseAccumulator<_CoefficientType> &accumulator = accumulators[_worker];
+        if (accumulator.size() != chainSize) {
+            accumulator.resize(chainSize);
+        }
+
+        const MatrixChain &chain = outer.local.chains[_index];
+        for (typename MatrixChain::const_iterator it = chain.cbegin() ; it != chain.cend() ; ++it) {
+            const MatrixChain &innerChain = inner.isLocal(it->first) ? inner.local.chains[it->first - inner.getFirstChain()] : fetched.at(it->first);
+
+            accumulator.addScaled(innerChain, it->second);
+        }
+
+        accumulator.flush(result.local.chains[_index].chainData);
+    });
+
+    result.local.rebuildChainStates();
+
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,436 @@
+/**
+ * \file DistributedReduction.hpp
+ * \brief Column reduction of distributed boundary matrices.
+ *
+ * Define everything for the DistributedReduction class
+ */
+
+#ifndef __OSM_DISTRIBUTED_REDUCTION__
+#define __OSM_DISTRIBUTED_REDUCTION__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "Chain.hpp"
+#include "DistributedMatrix.hpp"
+#include "PoolAllocator.hpp"
+#include "Reduction.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <mpi.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class DistributedReduction
+ * \brief Persistent homology reduction of a boundary matrix distributed by columns.
+ *
+ * The chunk reduction of OSM::ColumnReduction, each rank being a chunk whose rows are the indexes of its columns:
+ * - Local phase: each rank reduces its columns by decreasing dimension with clearing, only with its own columns
+ *   while their pivot lies in its rows. Such a column is paired for good and its birth is cleared.
+ * - Compression: the rows of the local deaths, gathered as a bit set, are removed from every remaining column.
+ * - Global phase: by decreasing dimension, each unpaired column travels to the rank owning its pivot row, which
+ *   reduces it with the reducers of its rows until its pivot leaves them or it is paired there. A reducer found with
+ *   a greater index than the column is swapped with it, so that columns are only combined with earlier ones. Every
+ *   round moves the columns to a lower rank, a dimension takes at most rankCount rounds.
+ *
+ * The columns travel as OSM::ChainPacket buffers, in one all-to-all exchange per round.
+ *
+ * \warning The matrix is modified. The paired columns of the local phase are reduced in place and miss the removed
+ * rows, the columns of the global phase are left empty as they moved to the ranks of their pivots.
+ *
+ * \pre The matrix stores no null coefficient.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::DistributedMatrix \endlink
+ * \see \link OSM::ColumnReduction \endlink
+ */
+template <typename _CoefficientType, typename _StorageType>
+class DistributedReduction {
+
+public:
+    /** \brief The reduced matrix type. */
+    typedef DistributedMatrix<_CoefficientType, COLUMN, _StorageType> Matrix;
+
+    /** \brief The column type. */
+    typedef Chain<_CoefficientType, COLUMN, _StorageType> MatrixChain;
+
+private:
+    /** \brief The dimension of each column, empty if unknown. */
+    std::vector<int> dimensions;
+
+    /** \brief For each row of the rank, the reduced column having it as pivot, -1 if none. */
+    std::vector<int> pivots;
+
+    /** \brief The first row of the rank in the last reduction. */
+    int firstRow;
+
+    /** \brief The number of exchange rounds of the last global phase. */
+    std::size_t roundCount;
+
+public:
+    /**
+     * \brief Create new DistributedReduction object.
+     *
+     * Default constructor, every column is considered of the same dimension and nothing is cleared across dimensions.
+     */
+    DistributedReduction() : firstRow(0), roundCount(0) {}
+
+    /**
+     * \brief Create new DistributedReduction object.
+     *
+     * \warning Will raise an error if a dimension is negative.
+     *
+     * \param[in] _dimensions The dimension of each column, the same on every rank.
+     */
+    explicit DistributedReduction(const std::vector<int> &_dimensions);
+
+    /**
+     * \brief Reduces a distributed boundary matrix and computes its persistence pairs. Collective.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     * \warning Will raise an error if dimensions are given and their number is not the number of columns.
+     * \warning Will raise an error if a pivot cannot be cancelled over the coefficients.
+     *
+     * \param[in,out] _matrix The boundary matrix, modified.
+     *
+     * \return The persistence pairs and the essential classes, on every rank.
+     */
+    PersistenceDiagram reduce(Matrix &_matrix);
+
+    /**
+     * \brief Get the pivot table of the last reduction, for the rows of the rank.
+     *
+     * \warning Will raise an error if the row is not one of the rank in the last reduced matrix.
+     *
+     * \param[in] _row The row index.
+     *
+     * \return The reduced column having the row as pivot, -1 if none.
+     */
+    int getPivot(const int _row) const;
+
+    /** \brief Get the number of exchange rounds of the last global phase. */
+    std::size_t getRoundCount() const noexcept { return roundCount; }
+
+private:
+    /**
+     * \brief Reduces a column with the earlier reducers of the rank while its pivot lies in its rows.
+     *
+     * \param[in] _index The index of the column, only the reducers of lower index are added.
+     * \param[in,out] _column The column.
+     * \param[in] _local The local matrix.
+     * \param[in] _settled The reducers received from other ranks, by pivot row.
+     *
+     * \return The pivot of the reduced column, -1 if it is null.
+     */
+    int reduceColumn(const int _index, MatrixChain &_column, const typename Matrix::LocalMatrix &_local, const std::unordered_map<int, std::pair<int, MatrixChain>> &_settled) const;
+
+    /**
+     * \brief Removes the rows of the deaths from a column.
+     *
+     * \param[in,out] _column The column.
+     * \param[in] _deaths The bit set of the deaths.
+     */
+    static void compressColumn(MatrixChain &_column, const std::vector<uint64_t> &_deaths);
+
+    /**
+     * \brief Orders columns by decreasing dimension, by index order without dimensions.
+     *
+     * \param[in] _first The first column.
+     * \param[in] _last The column after the last one.
+     *
+     * \return The columns indexes, by filtration order inside a dimension.
+     */
+    std::vector<int> columnsByDimension(const int _first, const int _last) const;
+
+    /** \brief Get the dimension of a column, 0 without dimensions. */
+    int dimension(const int _column) const noexcept { return dimensions.empty() ? 0 : dimensions[_column]; }
+};
+
+template <typename _CoefficientType, typename _StorageType>
+DistributedReduction<_CoefficientType, _StorageType>::DistributedReduction(const std::vector<int> &_dimensions) :
+    dimensions(_dimensions),
+    firstRow(0),
+    roundCount(0) {
+    for (int dimension : dimensions) {
+        if (dimension < 0) {
+            throw std::invalid_argument("Dimensions must be non negative.");
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _StorageType>
+PersistenceDiagram DistributedReduction<_CoefficientType, _StorageType>::reduce(Matrix &_matrix) {
+    const int size = _matrix.getColumnCount();
+
+    if (_matrix.getRowCount() != size) {
+        throw std::invalid_argument("A boundary matrix must be square.");
+    }
+
+    if (!dimensions.empty() && static_cast<int>(dimensions.size()) != size) {
+        throw std::invalid_argument("The dimensions must be as many as the columns.");
+    }
+
+    typename Matrix::LocalMatrix &local = _matrix.local;
+    const int first = _matrix.getFirstChain();
+    const int last = _matrix.getLastChain();
+
+    firstRow = first;
+    roundCount = 0;
+    pivots.assign(last - first, -1);
+
+    std::vector<char> cleared(last - first, false);
+    std::vector<char> paired(last - first, false);
+    const std::unordered_map<int, std::pair<int, MatrixChain>> noReducer;
+
+    // Local phase, the rank only reads and claims the pivots of its own rows
+    for (int column : columnsByDimension(first, last)) {
+        if (cleared[column - first]) {
+            continue;
+        }
+
+        const int pivot = reduceColumn(column, local.chains[column - first], local, noReducer);
+
+        if (pivot >= first) {
+            pivots[pivot - first] = column;
+            paired[column - first] = true;
+
+            local.chains[pivot - first] = MatrixChain(size);
+            cleared[pivot - first] = true;
+        }
+    }
+
+    // Compression, the rows of the local deaths can never be pivots
+    std::vector<uint64_t> deaths((size + 63) / 64, 0);
+    for (int column = first ; column < last ; column++) {
+        if (paired[column - first]) {
+            deaths[column / 64] |= uint64_t(1) << (column % 64);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, deaths.data(), deaths.size(), MPI_UINT64_T, MPI_BOR, _matrix.communicator);
+
+    for (int column = first ; column < last ; column++) {
+        if (!cleared[column - first] && local.chains[column - first].size() != 0) {
+            compressColumn(local.chains[column - first], deaths);
+        }
+    }
+
+    // Global phase, by decreasing dimension, the columns travel to the ranks of their pivots
+    int maximalDimension = 0;
+    for (int column = 0 ; column < static_cast<int>(dimensions.size()) ; column++) {
+        maximalDimension = std::max(maximalDimension, dimensions[column]);
+    }
+
+    std::unordered_map<int, std::pair<int, MatrixChain>> settled;
+    std::vector<std::pair<int, MatrixChain>> moving;
+
+    for (int reduced = maximalDimension ; reduced >= 0 ; reduced--) {
+        moving.clear();
+
+        for (int column = first ; column < last ; column++) {
+            if (dimension(column) == reduced && !cleared[column - first] && !paired[column - first] && local.chains[column - first].size() != 0) {
+                moving.emplace_back(column, std::move(local.chains[column - first]));
+                local.chains[column - first] = MatrixChain(size);
+            }
+        }
+
+        while (true) {
+            uint64_t movingCount = moving.size();
+            MPI_Allreduce(MPI_IN_PLACE, &movingCount, 1, MPI_UINT64_T, MPI_SUM, _matrix.communicator);
+
+            if (movingCount == 0) {
+                break;
+            }
+            roundCount++;
+
+            std::vector<typename Matrix::Packet> packets(_matrix.rankCount);
+            for (const std::pair<int, MatrixChain> &column : moving) {
+                packets[_matrix.getOwner(column.second.lastIndex())].append(column.first, column.second);
+            }
+
+            const std::vector<char> received = _matrix.exchange(packets);
+            std::vector<std::pair<int, MatrixChain>> arrivals;
+
+            Matrix::Packet::decode(received.data(), received.data() + received.size(), [&](const int _index) -> MatrixChain& {
+                arrivals.emplace_back(_index, MatrixChain(size));
+                return arrivals.back().second;
+            });
+
+            std::sort(arrivals.begin(), arrivals.end(), [](const std::pair<int, MatrixChain> &_first, const std::pair<int, MatrixChain> &_second) {
+                return _first.first < _second.first;
+            });
+            moving.clear();
+
+            for (std::pair<int, MatrixChain> &arrival : arrivals) {
+                int column = arrival.first;
+                MatrixChain chain = std::move(arrival.second);
+
+                while (true) {
+                    const int pivot = reduceColumn(column, chain, local, settled);
+
+                    if (pivot < 0) {
+                        break;
+                    } else if (pivot < first) {
+                        moving.emplace_back(column, std::move(chain));
+                        break;
+                    }
+
+                    const int reducer = pivots[pivot - first];
+
+                    if (reducer < 0) {
+                        pivots[pivot - first] = column;
+                        settled.emplace(pivot, std::pair<int, MatrixChain>(column, std::move(chain)));
+
+                        local.chains[pivot - first] = MatrixChain(size);
+                        cleared[pivot - first] = true;
+                        break;
+                    }
+
+                    // A later reducer received from another rank, the earlier column replaces it and the reducer moves on
+                    std::pair<int, MatrixChain> &later = settled.at(pivot);
+                    std::swap(later.first, column);
+                    std::swap(later.second, chain);
+                    pivots[pivot - first] = later.first;
+                }
+            }
+        }
+    }
+
+    local.rebuildChainStates();
+    ChainPool::releaseAll();
+
+    // Every rank gets the pairs of every row, by increasing birth
+    std::vector<int> localPairs;
+    for (int row = first ; row < last ; row++) {
+        if (pivots[row - first] >= 0) {
+            localPairs.push_back(row);
+            localPairs.push_back(pivots[row - first]);
+        }
+    }
+
+    int localCount = localPairs.size();
+    std::vector<int> counts(_matrix.rankCount);
+    std::vector<int> offsets(_matrix.rankCount, 0);
+
+    MPI_Allgather(&localCount, 1, MPI_INT, counts.data(), 1, MPI_INT, _matrix.communicator);
+    for (int rank = 1 ; rank < _matrix.rankCount ; rank++) {
+        offsets[rank] = offsets[rank - 1] + counts[rank - 1];
+    }
+
+    std::vector<int> allPairs(offsets.back() + counts.back());
+    MPI_Allgatherv(localPairs.data(), localCount, MPI_INT, allPairs.data(), counts.data(), offsets.data(), MPI_INT, _matrix.communicator);
+
+    PersistenceDiagram diagram;
+    std::vector<char> inPair(size, false);
+
+    for (std::size_t pair = 0 ; pair < allPairs.size() ; pair += 2) {
+        diagram.pairs.push_back(PersistencePair{allPairs[pair], allPairs[pair + 1]});
+        inPair[allPairs[pair]] = true;
+        inPair[allPairs[pair + 1]] = true;
+    }
+
+    for (int column = 0 ; column < size ; column++) {
+        if (!inPair[column]) {
+            diagram.essentials.push_back(column);
+        }
+    }
+
+    return diagram;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+int DistributedReduction<_CoefficientType, _StorageType>::getPivot(const int _row) const {
+    if (_row < firstRow || _row >= firstRow + static_cast<int>(pivots.size())) {
+        throw std::out_of_range("Row index out of the rows of this rank.");
+    }
+
+    return pivots[_row - firstRow];
+}
+
+template <typename _CoefficientType, typename _StorageType>
+int DistributedReduction<_CoefficientType, _StorageType>::reduceColumn(const int _index, MatrixChain &_column, const typename Matrix::LocalMatrix &_local, const std::unordered_map<int, std::pair<int, MatrixChain>> &_settled) const {
+    int pivot = _column.lastIndex();
+
+    while (pivot >= firstRow && pivot < firstRow + static_cast<int>(pivots.size())) {
+        const int reducer = pivots[pivot - firstRow];
+
+        if (reducer < 0 || reducer > _index) {
+            break;
+        }
+
+        // The reducers of the local phase are stored in place, the ones of the global phase were received
+        const typename std::unordered_map<int, std::pair<int, MatrixChain>>::const_iterator it = _settled.find(pivot);
+        const MatrixChain &reducerColumn = it != _settled.end() ? it->second.second : _local.chains[reducer - firstRow];
+
+        const _CoefficientType factor = exactQuotient(static_cast<const MatrixChain&>(_column)[pivot], static_cast<const MatrixChain&>(reducerColumn)[pivot]);
+        _column.addScaled(-factor, reducerColumn);
+
+        pivot = _column.lastIndex();
+    }
+
+    return pivot;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void DistributedReduction<_CoefficientType, _StorageType>::compressColumn(MatrixChain &_column, const std::vector<uint64_t> &_deaths) {
+    bool compressible = false;
+    for (typename MatrixChain::const_iterator it = _column.cbegin() ; it != _column.cend() && !compressible ; ++it) {
+        compressible = (_deaths[it->first / 64] >> (it->first % 64)) & 1;
+    }
+
+    if (!compressible) {
+        return;
+    }
+
+    MatrixChain compressed(_column.getUpperBound());
+    for (typename MatrixChain::const_iterator it = _column.cbegin() ; it != _column.cend() ; ++it) {
+        if (!((_deaths[it->first / 64] >> (it->first % 64)) & 1)) {
+            compressed[it->first] = it->second;
+        }
+    }
+
+    _column = std::move(compressed);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+std::vector<int> DistributedReduction<_CoefficientType, _StorageType>::columnsByDimension(const int _first, const int _last) const {
+    std::vector<int> order(_last - _first);
+
+    if (dimensions.empty()) {
+        for (int column = _first ; column < _last ; column++) {
+            order[column - _first] = column;
+        }
+        return order;
+    }
+
+    int maximalDimension = 0;
+    for (int column = _first ; column < _last ; column++) {
+        maximalDimension = std::max(maximalDimension, dimensions[column]);
+    }
+
+    std::vector<std::size_t> offsets(maximalDimension + 2, 0);
+    for (int column = _first ; column < _last ; column++) {
+        offsets[maximalDimension - dimensions[column] + 1]++;
+    }
+    for (std::size_t bucket = 1 ; bucket < offsets.size() ; bucket++) {
+        offsets[bucket] += offsets[bucket - 1];
+    }
+
+    for (int column = _first ; column < _last ; column++) {
+        order[offsets[maximalDimension - dimensions[column]]++] = column;
+    }
+
+    return order;
+}
+
+}
+
+#endif
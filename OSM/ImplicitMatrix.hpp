@@ -0,0 +1,336 @@
+/**
+ * \file ImplicitMatrix.hpp
+ * \brief Boundary matrices whose chains are generated on demand and kept in an LRU cache.
+ *
+ * Define everything for the ImplicitMatrix class
+ */
+
+#ifndef __OSM_IMPLICIT_MATRIX__
+#define __OSM_IMPLICIT_MATRIX__
+
+
+#include "SparseMatrix.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class ImplicitMatrix
+ * \brief Sparse matrix whose chains are generated on demand, the most recently used ones being cached.
+ *
+ * A generator fills each requested chain, for instance with the boundary of a simplex computed from its index, so the
+ * matrix is never stored. The generated chains are kept in a least recently used cache bounded by a number of entries,
+ * since the chains reducing a column tend to be requested again by the next columns.
+ *
+ * Chains are returned as shared pointers which keep them alive after their eviction. Lookups are thread-safe, the
+ * generator may be called concurrently by several threads when the matrix is shared.
+ *
+ * \see \link OSM::ColumnReduction::reduce \endlink
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of the generated chains (default is OSM::COLUMN)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ImplicitMatrix {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "An implicit matrix generates either columns or rows.");
+
+public:
+    typedef Chain<_CoefficientType, _ChainTypeFlag, _StorageType> MatrixChain;
+    typedef std::shared_ptr<const MatrixChain> ChainHandle;
+
+    /** \brief Fills the empty chain of the given index. */
+    typedef std::function<void(const int, MatrixChain&)> Generator;
+
+    /** \brief The default number of cached entries. */
+    static constexpr std::size_t DEFAULT_CACHE_CAPACITY = std::size_t(1) << 20;
+
+private:
+    /** \brief A cached chain and its position in the recency list. */
+    struct CacheSlot {
+        ChainHandle chain;
+        std::list<int>::iterator position;
+    };
+
+    /** \brief The number of rows. */
+    int rowCount;
+
+    /** \brief The number of columns. */
+    int columnCount;
+
+    /** \brief The chain generator. */
+    Generator generator;
+
+    /** \brief The maximal number of cached entries. */
+    std::size_t cacheCapacity;
+
+    /** \brief Guards the cache and its counters. */
+    mutable std::mutex mutex;
+
+    /** \brief The cached chain indexes, the most recently used first. */
+    mutable std::list<int> recency;
+
+    /** \brief The cached chains. */
+    mutable std::unordered_map<int, CacheSlot> cache;
+
+    /** \brief The number of cached entries. */
+    mutable std::size_t cachedEntries;
+
+    /** \brief The number of lookups served by the cache. */
+    mutable uint64_t hitCount;
+
+    /** \brief The number of lookups which generated their chain. */
+    mutable uint64_t missCount;
+
+    /** \brief The number of chains evicted from the cache. */
+    mutable uint64_t evictionCount;
+
+public:
+    /**
+     * \brief Create new ImplicitMatrix object.
+     *
+     * \warning Will raise an error if the dimensions are negative or the generator is empty.
+     *
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _generator The chain generator, called with the chain index and an empty chain to fill.
+     * \param[in] _cacheCapacity The maximal number of cached entries (default is DEFAULT_CACHE_CAPACITY).
+     */
+    ImplicitMatrix(const int _rowCount, const int _columnCount, Generator _generator, const std::size_t _cacheCapacity = DEFAULT_CACHE_CAPACITY);
+
+    ImplicitMatrix(const ImplicitMatrix &) = delete;
+    ImplicitMatrix& operator=(const ImplicitMatrix &) = delete;
+
+    /**
+     * \brief Get a chain, from the cache or from the generator.
+     *
+     * A chain of more entries than the cache capacity is returned without being cached.
+     *
+     * \warning Will raise an error if the index is out of the matrix.
+     *
+     * \param[in] _index The chain index.
+     *
+     * \return The chain, kept alive by the handle.
+     */
+    ChainHandle operator[](const int _index) const;
+
+    /**
+     * \brief Generates a chain, bypassing the cache.
+     *
+     * Used by the passes visiting every chain once, which would only evict the hot chains.
+     *
+     * \warning Will raise an error if the index is out of the matrix.
+     *
+     * \param[in] _index The chain index.
+     *
+     * \return The generated chain.
+     */
+    MatrixChain generate(const int _index) const;
+
+    /**
+     * \brief Generates every chain into an explicit matrix, bypassing the cache.
+     *
+     * \param[in] _threadPool The pool generating the chains in parallel, may be null (default is null).
+     *
+     * \return The explicit matrix.
+     */
+    SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> materialize(ThreadPool *_threadPool = nullptr) const;
+
+    /** \brief Get the number of rows. */
+    int getRowCount() const noexcept { return rowCount; }
+
+    /** \brief Get the number of columns. */
+    int getColumnCount() const noexcept { return columnCount; }
+
+    /** \brief Get the number of chains. */
+    int getChainCount() const noexcept { return _ChainTypeFlag == COLUMN ? columnCount : rowCount; }
+
+    /** \brief Get the maximal number of cached entries. */
+    std::size_t getCacheCapacity() const noexcept { return cacheCapacity; }
+
+    /** \brief Set the maximal number of cached entries, evicting the least recently used chains beyond it. */
+    void setCacheCapacity(const std::size_t _cacheCapacity);
+
+    /** \brief Removes every chain from the cache, the counters are kept. */
+    void clearCache();
+
+    /** \brief Get the number of cached entries. */
+    std::size_t getCachedEntryCount() const;
+
+    /** \brief Get the number of lookups served by the cache. */
+    uint64_t getHitCount() const;
+
+    /** \brief Get the number of lookups which generated their chain. */
+    uint64_t getMissCount() const;
+
+    /** \brief Get the number of chains evicted from the cache. */
+    uint64_t getEvictionCount() const;
+
+private:
+    /** \brief Raises an error if the chain index is out of the matrix. */
+    void checkChainIndex(const int _index) const;
+
+    /** \brief Evicts the least recently used chains until the cache fits its capacity, the lock being held. */
+    void evict() const;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::ImplicitMatrix(const int _rowCount, const int _columnCount, Generator _generator, const std::size_t _cacheCapacity) :
+    rowCount(_rowCount),
+    columnCount(_columnCount),
+    generator(std::move(_generator)),
+    cacheCapacity(_cacheCapacity),
+    cachedEntries(0),
+    hitCount(0),
+    missCount(0),
+    evictionCount(0) {
+    if (_rowCount < 0 || _columnCount < 0) {
+        throw std::invalid_argument("Matrix dimensions must be non negative.");
+    }
+
+    if (!generator) {
+        throw std::invalid_argument("An implicit matrix needs a chain generator.");
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::checkChainIndex(const int _index) const {
+    if (_index < 0 || _index >= getChainCount()) {
+        throw std::out_of_range("Chain index out of the matrix.");
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::MatrixChain ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::generate(const int _index) const {
+    checkChainIndex(_index);
+
+    MatrixChain chain(_ChainTypeFlag == COLUMN ? rowCount : columnCount);
+    generator(_index, chain);
+
+    return chain;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::ChainHandle ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    checkChainIndex(_index);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        typename std::unordered_map<int, CacheSlot>::iterator slot = cache.find(_index);
+
+        if (slot != cache.end()) {
+            recency.splice(recency.begin(), recency, slot->second.position);
+            hitCount++;
+
+            return slot->second.chain;
+        }
+
+        missCount++;
+    }
+
+    // The generator runs unlocked, two threads missing the same chain both generate it
+    ChainHandle chain = std::make_shared<const MatrixChain>(generate(_index));
+
+    if (chain->size() <= cacheCapacity) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (cache.find(_index) == cache.end()) {
+            recency.push_front(_index);
+            cache.emplace(_index, CacheSlot{chain, recency.begin()});
+            cachedEntries += chain->size();
+            evict();
+        }
+    }
+
+    return chain;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::evict() const {
+    while (cachedEntries > cacheCapacity) {
+        typename std::unordered_map<int, CacheSlot>::iterator slot = cache.find(recency.back());
+
+        cachedEntries -= slot->second.chain->size();
+        cache.erase(slot);
+        recency.pop_back();
+        evictionCount++;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::materialize(ThreadPool *_threadPool) const {
+    SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> result(rowCount, columnCount);
+    result.setThreadPool(_threadPool);
+
+    // The generation cost is unknown, every chain weighs the same
+    const std::vector<std::size_t> weights(getChainCount(), 1);
+
+    ThreadPool::forEachWeighted(_threadPool, weights, [&](const std::size_t _index, const std::size_t) {
+        generator(_index, result.chains[_index]);
+    });
+
+    result.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::setCacheCapacity(const std::size_t _cacheCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    cacheCapacity = _cacheCapacity;
+    evict();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::clearCache() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    cache.clear();
+    recency.clear();
+    cachedEntries = 0;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::size_t ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getCachedEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return cachedEntries;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+uint64_t ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return hitCount;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+uint64_t ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return missCount;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+uint64_t ImplicitMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getEvictionCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return evictionCount;
+}
+
+}
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * \file IndexSet.hpp
+ * \brief Immutable index sets used to remove or keep batches of chain indexes.
+ *
+ * Define everything for the IndexSet class
+ */
+
+#ifndef __OSM_INDEX_SET__
+#define __OSM_INDEX_SET__
+
+
+#include "__base.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class IndexSet
+ * \brief Immutable set of indexes in a range, stored as a bitmask with rank prefixes.
+ *
+ * Used to remove or keep batches of indexes from chains and matrices: the new index of a kept index is obtained in
+ * constant time from the number of set bits before it, so all chains are compacted in a single pass each.
+ */
+class IndexSet {
+
+private:
+    /** \brief The bitmask, bit i of word i / 64 is set if index i is in the set. */
+    std::vector<uint64_t> words;
+
+    /** \brief The number of set bits before each word. */
+    std::vector<int> ranks;
+
+    /** \brief The size of the range, indexes are in [0, rangeSize). */
+    int rangeSize;
+
+    /** \brief The number of indexes in the set. */
+    int indexCount;
+
+public:
+    /**
+     * \brief Create new IndexSet object.
+     *
+     * Default constructor, an empty set on an empty range.
+     */
+    IndexSet();
+
+    /**
+     * \brief Create new IndexSet object.
+     *
+     * Indexes out of the range are ignored, duplicates are allowed and the indexes need not be sorted.
+     *
+     * \param[in] _rangeSize The size of the range.
+     * \param[in] _indexes The indexes in the set.
+     */
+    IndexSet(const int _rangeSize, const std::vector<int> &_indexes);
+
+    /**
+     * \brief Create new IndexSet object.
+     *
+     * Indexes out of the range are ignored, duplicates are allowed and the indexes need not be sorted.
+     *
+     * \param[in] _rangeSize The size of the range.
+     * \param[in] _indexes The indexes in the set.
+     * \param[in] _count The number of indexes.
+     */
+    IndexSet(const int _rangeSize, const int *_indexes, const std::size_t _count);
+
+    /**
+     * \brief Create new IndexSet object from a bitmask.
+     *
+     * Bit i % 64 of word i / 64 tells if index i is in the set, bits beyond the range are ignored.
+     *
+     * \param[in] _rangeSize The size of the range.
+     * \param[in] _mask The bitmask, missing words are null.
+     */
+    IndexSet(const int _rangeSize, const std::vector<uint64_t> &_mask);
+
+    /** \brief Get the size of the range. */
+    int getRangeSize() const noexcept { return rangeSize; }
+
+    /** \brief Number of indexes in the set. */
+    int size() const noexcept { return indexCount; }
+
+    /** \brief Checks if the set is empty. */
+    bool empty() const noexcept { return indexCount == 0; }
+
+    /** \brief Checks if an index is in the set, false out of the range. */
+    bool contains(const int _index) const noexcept;
+
+    /** \brief Number of indexes of the set lower than the given index. */
+    int rank(const int _index) const noexcept;
+
+    /**
+     * \brief New index of an index once the set is removed.
+     *
+     * Indexes beyond the range are shifted by the set size.
+     *
+     * \param[in] _index The index.
+     *
+     * \return The shifted index, -1 if it is in the set.
+     */
+    int removedIndex(const int _index) const noexcept;
+
+    /**
+     * \brief New index of an index once only the set is kept.
+     *
+     * \param[in] _index The index.
+     *
+     * \return The index among the kept ones, -1 if it is not in the set.
+     */
+    int keptIndex(const int _index) const noexcept;
+
+    /**
+     * \brief The set of the indexes of the range not in this one.
+     *
+     * \return The complement.
+     */
+    IndexSet complement() const;
+
+    /**
+     * \brief Get the indexes of the set, sorted.
+     *
+     * \return The indexes.
+     */
+    std::vector<int> indexes() const;
+
+private:
+    /**
+     * \brief Clears the bits beyond the range and computes the rank prefixes.
+     */
+    void finalize();
+};
+
+inline IndexSet::IndexSet() : ranks(1, 0), rangeSize(0), indexCount(0) {}
+
+inline IndexSet::IndexSet(const int _rangeSize, const std::vector<int> &_indexes) : IndexSet(_rangeSize, _indexes.data(), _indexes.size()) {}
+
+inline IndexSet::IndexSet(const int _rangeSize, const int *_indexes, const std::size_t _count) :
+    words((std::max(_rangeSize, 0) + 63) / 64, 0),
+    rangeSize(std::max(_rangeSize, 0)),
+    indexCount(0) {
+    for (std::size_t position = 0 ; position < _count ; position++) {
+        if (_indexes[position] >= 0 && _indexes[position] < rangeSize) {
+            words[_indexes[position] / 64] |= uint64_t(1) << (_indexes[position] % 64);
+        }
+    }
+
+    finalize();
+}
+
+inline IndexSet::IndexSet(const int _rangeSize, const std::vector<uint64_t> &_mask) :
+    words((std::max(_rangeSize, 0) + 63) / 64, 0),
+    rangeSize(std::max(_rangeSize, 0)),
+    indexCount(0) {
+    for (std::size_t word = 0 ; word < words.size() && word < _mask.size() ; word++) {
+        words[word] = _mask[word];
+    }
+
+    finalize();
+}
+
+inline bool IndexSet::contains(const int _index) const noexcept {
+    if (_index < 0 || _index >= rangeSize) {
+        return false;
+    }
+
+    return (words[_index / 64] >> (_index % 64) & 1) != 0;
+}
+
+inline int IndexSet::rank(const int _index) const noexcept {
+    if (_index <= 0) {
+        return 0;
+    }
+    if (_index >= rangeSize) {
+        return indexCount;
+    }
+
+    const uint64_t lowerBits = words[_index / 64] & ((uint64_t(1) << (_index % 64)) - 1);
+
+    return ranks[_index / 64] + populationCount(lowerBits);
+}
+
+inline int IndexSet::removedIndex(const int _index) const noexcept {
+    return contains(_index) ? -1 : _index - rank(_index);
+}
+
+inline int IndexSet::keptIndex(const int _index) const noexcept {
+    return contains(_index) ? rank(_index) : -1;
+}
+
+inline IndexSet IndexSet::complement() const {
+    std::vector<uint64_t> mask(words.size());
+
+    for (std::size_t word = 0 ; word < words.size() ; word++) {
+        mask[word] = ~words[word];
+    }
+
+    return IndexSet(rangeSize, mask);
+}
+
+inline std::vector<int> IndexSet::indexes() const {
+    std::vector<int> result;
+    result.reserve(indexCount);
+
+    for (std::size_t word = 0 ; word < words.size() ; word++) {
+        for (uint64_t bits = words[word] ; bits != 0 ; bits &= bits - 1) {
+            result.push_back(word * 64 + countTrailingZeros(bits));
+        }
+    }
+
+    return result;
+}
+
+inline void IndexSet::finalize() {
+    if (rangeSize % 64 != 0) {
+        words.back() &= (uint64_t(1) << (rangeSize % 64)) - 1;
+    }
+
+    ranks.assign(words.size() + 1, 0);
+    for (std::size_t word = 0 ; word < words.size() ; word++) {
+        ranks[word + 1] = ranks[word] + populationCount(words[word]);
+    }
+
+    indexCount = ranks.back();
+}
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * \file Instrumentation.hpp
+ * \brief Counter and tracing policies for the hot paths of the reductions.
+ *
+ * Define everything for the instrumentation policies
+ */
+
+#ifndef __OSM_INSTRUMENTATION__
+#define __OSM_INSTRUMENTATION__
+
+
+#include "__base.hpp"
+#include <chrono>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \brief The counters collected by an instrumented reduction on one thread.
+ *
+ * Aligned on a cache line, so that the workers never share the line of their counters.
+ *
+ * \see \link OSM::CountingInstrumentation \endlink
+ */
+struct alignas(64) ReductionCounters {
+    /** \brief The number of chain additions. */
+    uint64_t chainAdditions = 0;
+
+    /** \brief The number of entries the chain additions created, net of the entries they cancelled. */
+    uint64_t fillIn = 0;
+
+    /** \brief The number of entries the chain additions cancelled, net of the entries they created. */
+    uint64_t cancellations = 0;
+
+    /** \brief The number of chain additions which changed the capacity of the column: reallocations or rehashes. */
+    uint64_t reallocations = 0;
+
+    /** \brief The number of columns paired without any chain addition, their pivot having no reducer yet. */
+    uint64_t emergentPairs = 0;
+
+    /** \brief Adds the counters of another thread. */
+    ReductionCounters& operator+=(const ReductionCounters &_other) noexcept {
+        chainAdditions += _other.chainAdditions;
+        fillIn += _other.fillIn;
+        cancellations += _other.cancellations;
+        reallocations += _other.reallocations;
+        emergentPairs += _other.emergentPairs;
+
+        return *this;
+    }
+};
+
+/**
+ * \brief The statistics of the last matrix reduced by an instrumented reduction.
+ *
+ * \see \link OSM::ColumnReduction::getStatistics \endlink
+ */
+struct ReductionStatistics {
+    /** \brief The number of bins of the size histogram. */
+    static constexpr std::size_t HISTOGRAM_SIZE = 33;
+
+    /** \brief The sum of the counters of every worker. */
+    ReductionCounters total;
+
+    /** \brief The counters of each worker of the thread pool, a single one for a sequential reduction. */
+    std::vector<ReductionCounters> workers;
+
+    /** \brief The size of each reduced column minus its size before the reduction. */
+    std::vector<int> columnFillIn;
+
+    /** \brief The number of pairs found by the apparent pair shortcut, whose columns were skipped. */
+    uint64_t apparentPairs = 0;
+
+    /** \brief The reduced column sizes, bin 0 counts the null columns and bin b the sizes in [2^(b-1), 2^b). */
+    uint64_t sizeHistogram[HISTOGRAM_SIZE] = {};
+
+    /** \brief Counts a reduced column size in the histogram. */
+    void recordSize(const std::size_t _size) noexcept {
+        const std::size_t bin = _size == 0 ? 0 : 64 - countLeadingZeros(uint64_t(_size));
+
+        sizeHistogram[bin < HISTOGRAM_SIZE ? bin : HISTOGRAM_SIZE - 1]++;
+    }
+};
+
+/**
+ * \brief The default instrumentation policy, which collects nothing.
+ *
+ * Every hook is compiled out, an uninstrumented reduction runs exactly the same code as before instrumentation existed.
+ */
+struct NoInstrumentation {
+    /** \brief Whether the counters and the scoped timings are collected. */
+    static constexpr bool ENABLED = false;
+
+    /** \brief Receives the duration of a scope, never called. */
+    static void trace(const char *, const uint64_t) noexcept {}
+};
+
+/**
+ * \brief Instrumentation policy collecting the reduction counters.
+ *
+ * Derive from it and hide trace to forward the scoped timings to a tracing backend:
+ *
+ *     struct Traced : OSM::CountingInstrumentation {
+ *         static void trace(const char *_scope, const uint64_t _nanoseconds) { backend.record(_scope, _nanoseconds); }
+ *     };
+ *     OSM::ColumnReduction<OSM::Z2Coefficient, OSM::Z2Storage, Traced> reduction(dimensions);
+ *
+ * trace may be called concurrently by the workers of a thread pool.
+ */
+struct CountingInstrumentation {
+    /** \brief Whether the counters and the scoped timings are collected. */
+    static constexpr bool ENABLED = true;
+
+    /**
+     * \brief Receives the duration of a scope, ignored by default.
+     *
+     * \param[in] _scope The scope name, a string literal.
+     * \param[in] _nanoseconds The wall-clock duration of the scope.
+     */
+    static void trace(const char *_scope, const uint64_t _nanoseconds) noexcept { (void)_scope; (void)_nanoseconds; }
+};
+
+/**
+ * \class ScopedTrace
+ * \brief Times its own lifetime and reports it to the instrumentation policy, empty when instrumentation is disabled.
+ *
+ * \tparam _Instrumentation The instrumentation policy.
+ */
+template <typename _Instrumentation, bool _Enabled = _Instrumentation::ENABLED>
+class ScopedTrace {
+
+public:
+    explicit ScopedTrace(const char *) noexcept {}
+};
+
+template <typename _Instrumentation>
+class ScopedTrace<_Instrumentation, true> {
+
+    /** \brief The scope name. */
+    const char *scope;
+
+    /** \brief The beginning of the scope. */
+    std::chrono::steady_clock::time_point begin;
+
+public:
+    explicit ScopedTrace(const char *_scope) noexcept : scope(_scope), begin(std::chrono::steady_clock::now()) {}
+
+    ScopedTrace(const ScopedTrace &) = delete;
+    ScopedTrace& operator=(const ScopedTrace &) = delete;
+
+    ~ScopedTrace() {
+        _Instrumentation::trace(scope, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,269 @@
+/**
+ * \file LazyChain.hpp
+ * \brief Heap-based chain accumulating many additions before merging them.
+ *
+ * Define everything for the LazyChain class
+ */
+
+#ifndef __OSM_LAZY_CHAIN__
+#define __OSM_LAZY_CHAIN__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "Chain.hpp"
+#include "ChainView.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class LazyChain
+ * \brief Chain accumulating its additions lazily, in a heap of pending entries.
+ *
+ * Adding a chain only pushes its entries on a max-heap ordered by index, the entries sharing an index are summed when
+ * they reach the top. Querying the last index consolidates the top entries until a non null sum is found, the rest of
+ * the heap is left untouched. A column reduced against many reducers thus pays a logarithmic cost per added entry,
+ * instead of merging the whole column at each addition.
+ *
+ * The heap is fully consolidated once it holds more than twice the entries of the last consolidation, which bounds
+ * its memory by the number of distinct indexes. Converting back to an OSM::Chain consolidates every entry.
+ *
+ * This pays off over OSM::SortedStorage chains, whose additions merge the whole chain. A dense OSM::Z2Storage chain
+ * already adds in place, in linear time in the size of the added chain.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The storage policy of the converted chains (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::Chain \endlink
+ * \see \link OSM::ColumnReduction::setLazyAccumulation \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class LazyChain {
+
+public:
+    /** \brief The regular chain type. */
+    typedef Chain<_CoefficientType, _ChainTypeFlag, _StorageType> RegularChain;
+
+    /** \brief The number of pending entries below which the heap is never consolidated. */
+    static constexpr std::size_t MINIMAL_CONSOLIDATION_SIZE = 64;
+
+private:
+    /** \brief A pending entry, its index and its coefficient. */
+    typedef std::pair<int, _CoefficientType> Entry;
+
+    /** \brief The pending entries, a max-heap on the index, mutable since consolidating the top changes no value. */
+    mutable std::vector<Entry> heap;
+
+    /** \brief The number of entries after the last full consolidation. */
+    std::size_t consolidatedSize;
+
+    /** \brief The upper bound of the converted chains. */
+    int upperBound;
+
+public:
+    /**
+     * \brief Create new LazyChain object.
+     *
+     * Default constructor, initialize an empty chain of upper bound 128.
+     */
+    LazyChain() : consolidatedSize(0), upperBound(128) {}
+
+    /**
+     * \brief Create new LazyChain object.
+     *
+     * \param[in] _chainSize The upper bound of the chain.
+     */
+    explicit LazyChain(const int _chainSize) : consolidatedSize(0), upperBound(_chainSize) {}
+
+    /**
+     * \brief Create new LazyChain object.
+     *
+     * \param[in] _chain The chain whose entries are the initial entries.
+     */
+    explicit LazyChain(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain);
+
+    /**
+     * \brief Replaces the entries by the ones of a chain, keeping the allocated heap.
+     *
+     * \param[in] _chain The chain.
+     */
+    void assign(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain);
+
+    /**
+     * \brief Adds a scaled chain, by pushing its entries.
+     *
+     * \param[in] _lambda The factor applied to the chain.
+     * \param[in] _other The chain to add.
+     *
+     * \return A reference to the modified chain.
+     */
+    LazyChain& addScaled(const _CoefficientType _lambda, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_other);
+
+    /**
+     * \brief Get the last non null index, consolidating the top of the heap.
+     *
+     * \return The greatest index whose coefficients do not sum to zero, -1 if the chain is null.
+     */
+    int lastIndex() const;
+
+    /**
+     * \brief Get the coefficient of the last non null index.
+     *
+     * \return The consolidated coefficient of the last index, 0 if the chain is null.
+     */
+    _CoefficientType lastCoefficient() const;
+
+    /** \brief Get the number of pending entries, an upper bound of the number of non null coefficients. */
+    std::size_t pendingCount() const noexcept { return heap.size(); }
+
+    /** \brief Get the upper bound of the chain. */
+    int getUpperBound() const noexcept { return upperBound; }
+
+    /**
+     * \brief Sums the entries sharing an index and removes the null ones.
+     */
+    void consolidate();
+
+    /**
+     * \brief Converts the lazy chain into a regular chain.
+     *
+     * \return The chain of the consolidated entries.
+     */
+    RegularChain toChain() const;
+
+    /** \brief Removes every entry, keeping the allocated heap. */
+    void clear() noexcept { heap.clear(); consolidatedSize = 0; }
+
+private:
+    /** \brief Heap order, the greatest index on top. */
+    static bool lowerIndex(const Entry &_first, const Entry &_second) noexcept { return _first.first < _second.first; }
+
+    /**
+     * \brief Sorts the entries by increasing index, sums the entries sharing an index and removes the null ones.
+     *
+     * \param[in,out] _entries The entries.
+     */
+    static void merge(std::vector<Entry> &_entries);
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::LazyChain(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) :
+    consolidatedSize(0),
+    upperBound(_chain.getUpperBound()) {
+    assign(_chain);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::assign(const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_chain) {
+    upperBound = _chain.getUpperBound();
+    heap.clear();
+    heap.reserve(_chain.size());
+
+    for (typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+        heap.emplace_back(it->first, it->second);
+    }
+
+    std::make_heap(heap.begin(), heap.end(), lowerIndex);
+    consolidatedSize = heap.size();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>& LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::addScaled(const _CoefficientType _lambda, const ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> &_other) {
+    for (typename ChainView<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator it = _other.cbegin() ; it != _other.cend() ; ++it) {
+        heap.emplace_back(it->first, _lambda * it->second);
+        std::push_heap(heap.begin(), heap.end(), lowerIndex);
+    }
+
+    if (heap.size() > std::max(2 * consolidatedSize, MINIMAL_CONSOLIDATION_SIZE)) {
+        consolidate();
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+int LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::lastIndex() const {
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), lowerIndex);
+        Entry top = heap.back();
+        heap.pop_back();
+
+        while (!heap.empty() && heap.front().first == top.first) {
+            top.second += heap.front().second;
+
+            std::pop_heap(heap.begin(), heap.end(), lowerIndex);
+            heap.pop_back();
+        }
+
+        // The consolidated entry goes back on top, the next query finds it alone
+        if (top.second != _CoefficientType(0)) {
+            heap.push_back(top);
+            std::push_heap(heap.begin(), heap.end(), lowerIndex);
+
+            return top.first;
+        }
+    }
+
+    return -1;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+_CoefficientType LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::lastCoefficient() const {
+    if (lastIndex() < 0) {
+        return _CoefficientType(0);
+    }
+
+    return heap.front().second;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::merge(std::vector<Entry> &_entries) {
+    std::sort(_entries.begin(), _entries.end(), lowerIndex);
+
+    std::size_t write = 0;
+    for (std::size_t read = 0 ; read < _entries.size() ; ) {
+        Entry entry = _entries[read++];
+
+        while (read < _entries.size() && _entries[read].first == entry.first) {
+            entry.second += _entries[read++].second;
+        }
+
+        if (entry.second != _CoefficientType(0)) {
+            _entries[write++] = entry;
+        }
+    }
+
+    _entries.resize(write);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::consolidate() {
+    merge(heap);
+    std::make_heap(heap.begin(), heap.end(), lowerIndex);
+    consolidatedSize = heap.size();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::RegularChain LazyChain<_CoefficientType, _ChainTypeFlag, _StorageType>::toChain() const {
+    std::vector<Entry> entries(heap);
+    merge(entries);
+
+    RegularChain result(upperBound);
+    result.chainData.reserve(entries.size());
+
+    for (const Entry &entry : entries) {
+        result.chainData.append(entry.first, entry.second);
+    }
+
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,737 @@
+/**
+ * \file MappedMatrix.hpp
+ * \brief Binary matrix file format and read-only memory-mapped matrices.
+ *
+ * Define everything for the MappedMatrix class and the binary matrix file format
+ */
+
+#ifndef __OSM_MAPPED_MATRIX__
+#define __OSM_MAPPED_MATRIX__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "SparseMatrix.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \brief Header of the binary matrix files, the first 64 bytes of the file.
+ *
+ * The header is followed by the chainCount + 1 offsets of the chains (64-bit), the indexes of the entries (32-bit,
+ * sorted in each chain, padded to 8 bytes) and the coefficients of the entries (coefficientSize bytes each, none for
+ * OSM::Z2Coefficient). This is the compressed sparse column layout for OSM::COLUMN matrices and the compressed sparse
+ * row layout for OSM::ROW matrices. All values are in the byte order of the machine that wrote the file.
+ *
+ * \see \link OSM::MappedMatrix \endlink
+ */
+struct BinaryMatrixHeader {
+    /** \brief The file signature, OSM::BinaryMatrixHeader::MAGIC. */
+    char magic[8];
+
+    /** \brief The format version, OSM::BinaryMatrixHeader::VERSION. */
+    uint32_t version;
+
+    /** \brief The type of the stored chains, OSM::COLUMN or OSM::ROW. */
+    uint32_t chainType;
+
+    /** \brief The coefficient type code, see OSM::BinaryCoefficient. */
+    uint32_t coefficientCode;
+
+    /** \brief The number of bytes of each stored coefficient. */
+    uint32_t coefficientSize;
+
+    /** \brief The modulus of the coefficients, 0 for integers. */
+    uint64_t modulus;
+
+    /** \brief The number of rows of the matrix. */
+    int64_t rowCount;
+
+    /** \brief The number of columns of the matrix. */
+    int64_t columnCount;
+
+    /** \brief The number of stored chains. */
+    uint64_t chainCount;
+
+    /** \brief The number of stored entries. */
+    uint64_t entryCount;
+
+    /** \brief The file signature. */
+    static constexpr char MAGIC[8] = {'O', 'S', 'M', 'M', 'A', 'T', 'R', 'X'};
+
+    /** \brief The current format version. */
+    static constexpr uint32_t VERSION = 1;
+
+    /**
+     * \brief Byte position of the indexes in a file.
+     *
+     * \param[in] _chainCount The number of chains.
+     */
+    static constexpr std::size_t indexesPosition(const uint64_t _chainCount) noexcept { return 64 + (_chainCount + 1) * sizeof(uint64_t); }
+
+    /**
+     * \brief Byte position of the coefficients in a file, after the padded indexes.
+     *
+     * \param[in] _chainCount The number of chains.
+     * \param[in] _entryCount The number of entries.
+     */
+    static constexpr std::size_t coefficientsPosition(const uint64_t _chainCount, const uint64_t _entryCount) noexcept {
+        return indexesPosition(_chainCount) + (_entryCount * sizeof(int32_t) + 7) / 8 * 8;
+    }
+
+    /**
+     * \brief Header of a file storing a matrix.
+     *
+     * \tparam _CoefficientType The chain's coefficient types.
+     * \tparam _ChainTypeFlag The type of the stored chains, OSM::COLUMN or OSM::ROW.
+     *
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _entryCount The number of entries.
+     *
+     * \return The header.
+     */
+    template <typename _CoefficientType, int _ChainTypeFlag>
+    static BinaryMatrixHeader create(const int _rowCount, const int _columnCount, const uint64_t _entryCount) noexcept;
+};
+
+static_assert(sizeof(BinaryMatrixHeader) == 64, "The binary matrix header must be 64 bytes.");
+
+/**
+ * \brief Describes how a coefficient type is stored in binary matrix files.
+ *
+ * Coefficients are stored as their object representation. Unknown trivially copyable types get the code 0 and are
+ * only checked by size when loaded.
+ *
+ * \tparam _CoefficientType The chain's coefficient types.
+ */
+template <typename _CoefficientType>
+struct BinaryCoefficient {
+    static constexpr uint32_t code = 0;
+    static constexpr uint32_t size = sizeof(_CoefficientType);
+    static constexpr uint64_t modulus = 0;
+};
+
+template <>
+struct BinaryCoefficient<ZCoefficient> {
+    static constexpr uint32_t code = 1;
+    static constexpr uint32_t size = sizeof(ZCoefficient);
+    static constexpr uint64_t modulus = 0;
+};
+
+template <>
+struct BinaryCoefficient<Z2Coefficient> {
+    static constexpr uint32_t code = 2;
+    static constexpr uint32_t size = 0;
+    static constexpr uint64_t modulus = 2;
+};
+
+template <uint32_t _Prime>
+struct BinaryCoefficient<ZpCoefficient<_Prime>> {
+    static constexpr uint32_t code = 3;
+    static constexpr uint32_t size = sizeof(ZpCoefficient<_Prime>);
+    static constexpr uint64_t modulus = _Prime;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+BinaryMatrixHeader BinaryMatrixHeader::create(const int _rowCount, const int _columnCount, const uint64_t _entryCount) noexcept {
+    BinaryMatrixHeader header;
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.chainType = _ChainTypeFlag;
+    header.coefficientCode = BinaryCoefficient<_CoefficientType>::code;
+    header.coefficientSize = BinaryCoefficient<_CoefficientType>::size;
+    header.modulus = BinaryCoefficient<_CoefficientType>::modulus;
+    header.rowCount = _rowCount;
+    header.columnCount = _columnCount;
+    header.chainCount = _ChainTypeFlag == COLUMN ? _columnCount : _rowCount;
+    header.entryCount = _entryCount;
+
+    return header;
+}
+
+/**
+ * \class MappedMatrix
+ * \brief Read-only sparse matrix mapped from a binary matrix file.
+ *
+ * The file is mapped with mmap and the chains are read in place: loading only checks the header and the chain
+ * offsets, so a matrix of several gigabytes is usable at once, its pages are read on demand and shared between the
+ * processes mapping the same file. The indexes are checked when the matrix is copied by toSparseMatrix.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ *
+ * \see \link OSM::BinaryMatrixHeader \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag>
+class MappedMatrix {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "Mapped matrices store either columns or rows.");
+    static_assert(std::is_trivially_copyable<_CoefficientType>::value, "Mapped coefficients must be trivially copyable.");
+
+public:
+    /**
+     * \class MappedChain
+     * \brief Read-only view on a chain of a mapped matrix.
+     */
+    class MappedChain {
+
+    public:
+        /**
+         * \class const_iterator
+         * \brief Iterator over the (index, coefficient) entries of the chain, by increasing index.
+         */
+        class const_iterator {
+
+        public:
+            typedef std::pair<int, _CoefficientType> value_type;
+            typedef value_type reference;
+            typedef typename SortedStorage<_CoefficientType>::template ArrowProxy<value_type> pointer;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::forward_iterator_tag iterator_category;
+
+        private:
+            /** \brief The current index. */
+            const int32_t *index;
+
+            /** \brief The current coefficient, null for OSM::Z2Coefficient. */
+            const _CoefficientType *coefficient;
+
+        public:
+            const_iterator() noexcept : index(nullptr), coefficient(nullptr) {}
+            const_iterator(const int32_t *_index, const _CoefficientType *_coefficient) noexcept : index(_index), coefficient(_coefficient) {}
+
+            reference operator*() const noexcept { return value_type(*index, coefficient == nullptr ? _CoefficientType(1) : *coefficient); }
+            pointer operator->() const noexcept { return pointer{**this}; }
+
+            const_iterator& operator++() noexcept { ++index; if (coefficient != nullptr) { ++coefficient; } return *this; }
+            const_iterator operator++(int) noexcept { const_iterator copy = *this; ++(*this); return copy; }
+
+            bool operator==(const const_iterator &_other) const noexcept { return index == _other.index; }
+            bool operator!=(const const_iterator &_other) const noexcept { return index != _other.index; }
+        };
+
+    private:
+        /** \brief The sorted indexes of the chain. */
+        const int32_t *indexes;
+
+        /** \brief The coefficients of the chain, null for OSM::Z2Coefficient. */
+        const _CoefficientType *coefficients;
+
+        /** \brief The number of entries of the chain. */
+        std::size_t entryCount;
+
+        /** \brief The chain boundary. */
+        int upperBound;
+
+    public:
+        MappedChain(const int32_t *_indexes, const _CoefficientType *_coefficients, const std::size_t _entryCount, const int _upperBound) noexcept :
+            indexes(_indexes), coefficients(_coefficients), entryCount(_entryCount), upperBound(_upperBound) {}
+
+        /**
+         * \brief Get a coefficient from the chain, by binary search.
+         *
+         * \param[in] _index The coefficient index.
+         *
+         * \return The coefficient, null if it is not stored.
+         */
+        _CoefficientType operator[](const int _index) const noexcept;
+
+        /** \brief Constant iterator to the beginning of the chain. */
+        const_iterator begin() const noexcept { return const_iterator(indexes, coefficients); }
+
+        /** \brief Constant iterator to the ending of the chain. */
+        const_iterator end() const noexcept { return const_iterator(indexes + entryCount, coefficients == nullptr ? nullptr : coefficients + entryCount); }
+
+        /** \brief Number of coefficients stored in the chain. */
+        std::size_t size() const noexcept { return entryCount; }
+
+        /** \brief Greatest index stored in the chain, -1 if null. */
+        int lastIndex() const noexcept { return entryCount == 0 ? -1 : indexes[entryCount - 1]; }
+
+        /** \brief Get the chain boundary. */
+        int getUpperBound() const noexcept { return upperBound; }
+    };
+
+private:
+    /** \brief The mapped file, null if nothing is mapped. */
+    void *mapping;
+
+    /** \brief The size of the mapped file. */
+    std::size_t mappingSize;
+
+    /** \brief The header at the beginning of the mapped file. */
+    const BinaryMatrixHeader *header;
+
+    /** \brief The chainCount + 1 chain offsets. */
+    const uint64_t *offsets;
+
+    /** \brief The indexes of all entries. */
+    const int32_t *indexes;
+
+    /** \brief The coefficients of all entries, null for OSM::Z2Coefficient. */
+    const _CoefficientType *coefficients;
+
+public:
+    /**
+     * \brief Create new MappedMatrix object.
+     *
+     * Maps a binary matrix file, the stored chain type and coefficient type must match the template arguments.
+     *
+     * \param[in] _path The path of the file.
+     *
+     * \throws std::runtime_error If the file cannot be opened or mapped.
+     * \throws std::invalid_argument If the file is not a binary matrix of this type.
+     */
+    explicit MappedMatrix(const std::string &_path);
+
+    MappedMatrix(const MappedMatrix &_otherToCopy) = delete;
+    MappedMatrix& operator=(const MappedMatrix &_otherToCopy) = delete;
+
+    /**
+     * \brief Create new MappedMatrix object by moving another one, which no longer maps anything.
+     *
+     * \param[in] _otherToMove The matrix to move.
+     */
+    MappedMatrix(MappedMatrix &&_otherToMove) noexcept;
+
+    /**
+     * \brief Assign by moving another matrix, which no longer maps anything.
+     *
+     * \param[in] _otherToMove The matrix to move.
+     *
+     * \return The reference to the modified matrix.
+     */
+    MappedMatrix& operator=(MappedMatrix &&_otherToMove) noexcept;
+
+    /** \brief Unmaps the file. */
+    ~MappedMatrix();
+
+    /**
+     * \brief Writes a matrix in the binary matrix format.
+     *
+     * The chains of map storages are sorted on the fly, the others are written as they are stored.
+     *
+     * \param[in] _matrix The matrix to write.
+     * \param[in] _path The path of the file, overwritten if it exists.
+     *
+     * \throws std::runtime_error If the file cannot be written.
+     */
+    template <typename _StorageType>
+    static void write(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix, const std::string &_path);
+
+    /**
+     * \brief Get a chain from the mapped matrix.
+     *
+     * \warning The matrix will perform boundary check.
+     *
+     * \param[in] _index The chain index.
+     *
+     * \return The view on the chain, valid as long as the matrix maps the file.
+     */
+    MappedChain operator[](const int _index) const;
+
+    /**
+     * \brief Get a coefficient of the mapped matrix.
+     *
+     * \param[in] _row The row index.
+     * \param[in] _column The column index.
+     *
+     * \return The coefficient, null if it is not stored.
+     */
+    _CoefficientType getCoefficient(const int _row, const int _column) const;
+
+    /**
+     * \brief Copies the mapped matrix in a SparseMatrix.
+     *
+     * \return The matrix.
+     *
+     * \throws std::invalid_argument If the indexes of a chain are not increasing or out of the chain bounds.
+     */
+    template <typename _StorageType = typename DefaultStorage<_CoefficientType>::type>
+    SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> toSparseMatrix() const;
+
+    /**
+     * \brief Asks the system to read the pages of a range of chains ahead.
+     *
+     * \param[in] _first The first chain index.
+     * \param[in] _last The chain index after the last one.
+     */
+    void prefetch(const int _first, const int _last) const noexcept;
+
+    /**
+     * \brief Releases the pages of a range of chains from the process.
+     *
+     * The pages stay in the system cache and are read again on the next access, so a pass over the chains that
+     * releases each block once processed keeps the resident memory bounded.
+     *
+     * \param[in] _first The first chain index.
+     * \param[in] _last The chain index after the last one.
+     */
+    void release(const int _first, const int _last) const noexcept;
+
+    /** \brief Get the number of rows of the matrix. */
+    int getRowCount() const noexcept { return header == nullptr ? 0 : header->rowCount; }
+
+    /** \brief Get the number of columns of the matrix. */
+    int getColumnCount() const noexcept { return header == nullptr ? 0 : header->columnCount; }
+
+    /** \brief Get the number of chains of the matrix. */
+    int getChainCount() const noexcept { return header == nullptr ? 0 : header->chainCount; }
+
+    /** \brief Get the number of stored coefficients of the matrix. */
+    std::size_t getEntryCount() const noexcept { return header == nullptr ? 0 : header->entryCount; }
+
+    /** \brief Checks if the matrix is column-based. */
+    bool isColumnMajor() const noexcept { return _ChainTypeFlag == COLUMN; }
+
+    /** \brief Checks if the matrix is row-based. */
+    bool isRowMajor() const noexcept { return _ChainTypeFlag == ROW; }
+
+private:
+    /** \brief Unmaps the file, if any. */
+    void unmap() noexcept;
+
+    /**
+     * \brief Gives an advice on the pages of the indexes and coefficients of a range of chains.
+     *
+     * \param[in] _first The first chain index.
+     * \param[in] _last The chain index after the last one.
+     * \param[in] _advice The madvise advice.
+     */
+    void advise(const int _first, const int _last, const int _advice) const noexcept;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+_CoefficientType MappedMatrix<_CoefficientType, _ChainTypeFlag>::MappedChain::operator[](const int _index) const noexcept {
+    const int32_t *position = std::lower_bound(indexes, indexes + entryCount, _index);
+
+    if (position == indexes + entryCount || *position != _index) {
+        return _CoefficientType(0);
+    }
+
+    return coefficients == nullptr ? _CoefficientType(1) : coefficients[position - indexes];
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MappedMatrix<_CoefficientType, _ChainTypeFlag>::MappedMatrix(const std::string &_path) :
+    mapping(nullptr),
+    mappingSize(0),
+    header(nullptr),
+    offsets(nullptr),
+    indexes(nullptr),
+    coefficients(nullptr) {
+    const int descriptor = open(_path.c_str(), O_RDONLY);
+
+    if (descriptor < 0) {
+        throw std::runtime_error("Cannot open matrix file " + _path + ".");
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("Cannot read the size of matrix file " + _path + ".");
+    }
+
+    if (static_cast<std::size_t>(status.st_size) < sizeof(BinaryMatrixHeader)) {
+        close(descriptor);
+        throw std::invalid_argument("File " + _path + " is too small to be a binary matrix.");
+    }
+
+    mappingSize = status.st_size;
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("Cannot map matrix file " + _path + ".");
+    }
+
+    const BinaryMatrixHeader *fileHeader = static_cast<const BinaryMatrixHeader*>(mapping);
+    const char *error = nullptr;
+
+    if (std::memcmp(fileHeader->magic, BinaryMatrixHeader::MAGIC, sizeof(BinaryMatrixHeader::MAGIC)) != 0) {
+        error = " is not a binary matrix.";
+    } else if (fileHeader->version != BinaryMatrixHeader::VERSION) {
+        error = " has an unsupported version or byte order.";
+    } else if (fileHeader->chainType != static_cast<uint32_t>(_ChainTypeFlag)) {
+        error = " does not store the requested chain type.";
+    } else if (fileHeader->coefficientCode != BinaryCoefficient<_CoefficientType>::code
+            || fileHeader->coefficientSize != BinaryCoefficient<_CoefficientType>::size
+            || fileHeader->modulus != BinaryCoefficient<_CoefficientType>::modulus) {
+        error = " does not store the requested coefficient type.";
+    } else if (fileHeader->rowCount < 0 || fileHeader->rowCount > std::numeric_limits<int>::max()
+            || fileHeader->columnCount < 0 || fileHeader->columnCount > std::numeric_limits<int>::max()
+            || fileHeader->chainCount != static_cast<uint64_t>(_ChainTypeFlag == COLUMN ? fileHeader->columnCount : fileHeader->rowCount)) {
+        error = " has invalid dimensions.";
+    } else if (fileHeader->chainCount >= (mappingSize - sizeof(BinaryMatrixHeader)) / sizeof(uint64_t)) {
+        error = " is truncated.";
+    } else {
+        // Each term is bounded before being multiplied, so that crafted counts cannot wrap the positions around.
+        const std::size_t remaining = mappingSize - BinaryMatrixHeader::indexesPosition(fileHeader->chainCount);
+
+        if (fileHeader->entryCount > remaining / (sizeof(int32_t) + fileHeader->coefficientSize)
+                || BinaryMatrixHeader::coefficientsPosition(fileHeader->chainCount, fileHeader->entryCount) + fileHeader->entryCount * fileHeader->coefficientSize > mappingSize) {
+            error = " is truncated.";
+        }
+    }
+
+    if (error == nullptr) {
+        const char *bytes = static_cast<const char*>(mapping);
+
+        header = fileHeader;
+        offsets = reinterpret_cast<const uint64_t*>(bytes + sizeof(BinaryMatrixHeader));
+        indexes = reinterpret_cast<const int32_t*>(bytes + BinaryMatrixHeader::indexesPosition(header->chainCount));
+
+        if (BinaryCoefficient<_CoefficientType>::size != 0) {
+            coefficients = reinterpret_cast<const _CoefficientType*>(bytes + BinaryMatrixHeader::coefficientsPosition(header->chainCount, header->entryCount));
+        }
+
+        if (offsets[0] != 0 || offsets[header->chainCount] != header->entryCount) {
+            error = " has invalid chain offsets.";
+        }
+
+        for (uint64_t chain = 0 ; error == nullptr && chain < header->chainCount ; chain++) {
+            if (offsets[chain + 1] < offsets[chain]) {
+                error = " has invalid chain offsets.";
+            }
+        }
+    }
+
+    if (error != nullptr) {
+        unmap();
+        throw std::invalid_argument("File " + _path + error);
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MappedMatrix<_CoefficientType, _ChainTypeFlag>::MappedMatrix(MappedMatrix &&_otherToMove) noexcept :
+    mapping(_otherToMove.mapping),
+    mappingSize(_otherToMove.mappingSize),
+    header(_otherToMove.header),
+    offsets(_otherToMove.offsets),
+    indexes(_otherToMove.indexes),
+    coefficients(_otherToMove.coefficients) {
+    _otherToMove.mapping = nullptr;
+    _otherToMove.unmap();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MappedMatrix<_CoefficientType, _ChainTypeFlag>& MappedMatrix<_CoefficientType, _ChainTypeFlag>::operator=(MappedMatrix &&_otherToMove) noexcept {
+    if (&_otherToMove == this) {
+        return *this;
+    }
+
+    unmap();
+
+    mapping = _otherToMove.mapping;
+    mappingSize = _otherToMove.mappingSize;
+    header = _otherToMove.header;
+    offsets = _otherToMove.offsets;
+    indexes = _otherToMove.indexes;
+    coefficients = _otherToMove.coefficients;
+
+    _otherToMove.mapping = nullptr;
+    _otherToMove.unmap();
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MappedMatrix<_CoefficientType, _ChainTypeFlag>::~MappedMatrix() {
+    unmap();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+template <typename _StorageType>
+void MappedMatrix<_CoefficientType, _ChainTypeFlag>::write(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix, const std::string &_path) {
+    const int chainCount = _ChainTypeFlag == COLUMN ? _matrix.getColumnCount() : _matrix.getRowCount();
+
+    std::vector<uint64_t> chainOffsets(chainCount + 1, 0);
+    for (int index = 0 ; index < chainCount ; index++) {
+        chainOffsets[index + 1] = chainOffsets[index] + _matrix.chains[index].size();
+    }
+
+    const BinaryMatrixHeader fileHeader = BinaryMatrixHeader::create<_CoefficientType, _ChainTypeFlag>(_matrix.getRowCount(), _matrix.getColumnCount(), chainOffsets.back());
+
+    std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot create matrix file " + _path + ".");
+    }
+
+    file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    file.write(reinterpret_cast<const char*>(chainOffsets.data()), chainOffsets.size() * sizeof(uint64_t));
+
+    const auto byIndex = [](const std::pair<int, _CoefficientType> &_first, const std::pair<int, _CoefficientType> &_second) {
+        return _first.first < _second.first;
+    };
+
+    std::vector<std::pair<int, _CoefficientType>> entries;
+    std::vector<int32_t> chainIndexes;
+    std::vector<_CoefficientType> chainCoefficients;
+
+    // The coefficients follow all the indexes, they are written in a second pass over the chains.
+    for (int pass = 0 ; pass < (BinaryCoefficient<_CoefficientType>::size == 0 ? 1 : 2) ; pass++) {
+        for (int index = 0 ; index < chainCount ; index++) {
+            entries.assign(_matrix.chains[index].cbegin(), _matrix.chains[index].cend());
+
+            if (!std::is_sorted(entries.begin(), entries.end(), byIndex)) {
+                std::sort(entries.begin(), entries.end(), byIndex);
+            }
+
+            if (pass == 0) {
+                chainIndexes.clear();
+                for (const std::pair<int, _CoefficientType> &entry : entries) {
+                    chainIndexes.push_back(entry.first);
+                }
+                file.write(reinterpret_cast<const char*>(chainIndexes.data()), chainIndexes.size() * sizeof(int32_t));
+            } else {
+                chainCoefficients.clear();
+                for (const std::pair<int, _CoefficientType> &entry : entries) {
+                    chainCoefficients.push_back(entry.second);
+                }
+                file.write(reinterpret_cast<const char*>(chainCoefficients.data()), chainCoefficients.size() * sizeof(_CoefficientType));
+            }
+        }
+
+        if (pass == 0) {
+            const char padding[8] = {0};
+            file.write(padding, BinaryMatrixHeader::coefficientsPosition(chainCount, fileHeader.entryCount) - BinaryMatrixHeader::indexesPosition(chainCount) - fileHeader.entryCount * sizeof(int32_t));
+        }
+    }
+
+    if (!file.flush()) {
+        throw std::runtime_error("Cannot write matrix file " + _path + ".");
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+typename MappedMatrix<_CoefficientType, _ChainTypeFlag>::MappedChain MappedMatrix<_CoefficientType, _ChainTypeFlag>::operator[](const int _index) const {
+    if (_index < 0 || _index >= getChainCount()) {
+        throw std::out_of_range("Chain index out of matrix bounds.");
+    }
+
+    const uint64_t begin = offsets[_index];
+    const uint64_t end = offsets[_index + 1];
+
+    return MappedChain(
+        indexes + begin,
+        coefficients == nullptr ? nullptr : coefficients + begin,
+        end - begin,
+        _ChainTypeFlag == COLUMN ? getRowCount() : getColumnCount()
+    );
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+_CoefficientType MappedMatrix<_CoefficientType, _ChainTypeFlag>::getCoefficient(const int _row, const int _column) const {
+    if (_row < 0 || _row >= getRowCount() || _column < 0 || _column >= getColumnCount()) {
+        throw std::out_of_range("Coefficient index out of matrix bounds.");
+    }
+
+    if constexpr (_ChainTypeFlag == COLUMN) {
+        return (*this)[_column][_row];
+    } else {
+        return (*this)[_row][_column];
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+template <typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> MappedMatrix<_CoefficientType, _ChainTypeFlag>::toSparseMatrix() const {
+    SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> result(getRowCount(), getColumnCount());
+
+    for (int index = 0 ; index < getChainCount() ; index++) {
+        const MappedChain chain = (*this)[index];
+        _StorageType &storage = result.chains[index].chainData;
+
+        int previous = -1;
+
+        storage.reserve(chain.size());
+        for (typename MappedChain::const_iterator it = chain.begin() ; it != chain.end() ; ++it) {
+            // The storages rely on increasing indexes in their bounds, which the file cannot guarantee.
+            if (it->first <= previous || it->first >= chain.getUpperBound()) {
+                throw std::invalid_argument("Chain " + std::to_string(index) + " of the mapped matrix has unsorted or out of bounds indexes.");
+            }
+
+            storage.append(it->first, it->second);
+            previous = it->first;
+        }
+    }
+
+    result.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MappedMatrix<_CoefficientType, _ChainTypeFlag>::prefetch(const int _first, const int _last) const noexcept {
+    advise(_first, _last, MADV_WILLNEED);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MappedMatrix<_CoefficientType, _ChainTypeFlag>::release(const int _first, const int _last) const noexcept {
+    advise(_first, _last, MADV_DONTNEED);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MappedMatrix<_CoefficientType, _ChainTypeFlag>::advise(const int _first, const int _last, const int _advice) const noexcept {
+    const int first = std::max(_first, 0);
+    const int last = std::min(_last, getChainCount());
+
+    if (first >= last) {
+        return;
+    }
+
+    const uint64_t begin = offsets[first];
+    const uint64_t end = offsets[last];
+    const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+
+    const auto adviseRange = [&](const void *_begin, const void *_end) {
+        const uintptr_t alignedBegin = reinterpret_cast<uintptr_t>(_begin) / pageSize * pageSize;
+        const uintptr_t alignedEnd = reinterpret_cast<uintptr_t>(_end);
+
+        if (alignedEnd > alignedBegin) {
+            madvise(reinterpret_cast<void*>(alignedBegin), alignedEnd - alignedBegin, _advice);
+        }
+    };
+
+    adviseRange(indexes + begin, indexes + end);
+    if (coefficients != nullptr) {
+        adviseRange(coefficients + begin, coefficients + end);
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MappedMatrix<_CoefficientType, _ChainTypeFlag>::unmap() noexcept {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    offsets = nullptr;
+    indexes = nullptr;
+    coefficients = nullptr;
+}
+
+}
+
+#endif
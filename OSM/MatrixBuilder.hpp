@@ -0,0 +1,415 @@
+/**
+ * \file MatrixBuilder.hpp
+ * \brief Chain by chain construction of binary matrix files, for matrices larger than memory.
+ *
+ * Define everything for the MatrixBuilder class
+ */
+
+#ifndef __OSM_MATRIX_BUILDER__
+#define __OSM_MATRIX_BUILDER__
+
+
+#include "__base.hpp"
+#include "MappedMatrix.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class MatrixBuilder
+ * \brief Streaming chain by chain writer of binary matrix files.
+ *
+ * The chains are given in increasing order, for instance by a filtration generator, and only the current block of
+ * entries is kept in memory: the indexes are written in place in the output file and the coefficients are spilled
+ * to a side file, appended to the output when the matrix is finished. The memory used is bounded by the block size
+ * whatever the size of the matrix, which is then mapped with OSM::MappedMatrix.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ *
+ * \see \link OSM::MappedMatrix \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag>
+class MatrixBuilder {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "Built matrices store either columns or rows.");
+
+public:
+    /** \brief The default number of entries buffered before being written. */
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = std::size_t(1) << 20;
+
+private:
+    /** \brief The path of the output file. */
+    std::string path;
+
+    /** \brief The path of the side file storing the coefficients until the matrix is finished. */
+    std::string coefficientsPath;
+
+    /** \brief The output file descriptor, -1 once finished. */
+    int descriptor;
+
+    /** \brief The side file descriptor, -1 if there is no coefficient to store or once finished. */
+    int coefficientsDescriptor;
+
+    /** \brief The number of rows of the matrix. */
+    int rowCount;
+
+    /** \brief The number of columns of the matrix. */
+    int columnCount;
+
+    /** \brief The number of entries buffered before being written. */
+    std::size_t blockSize;
+
+    /** \brief The index of the chain being built. */
+    int chainIndex;
+
+    /** \brief The greatest index of the chain being built, -1 if it is empty. */
+    int lastIndex;
+
+    /** \brief The number of entries added. */
+    uint64_t entryCount;
+
+    /** \brief The number of entries written. */
+    uint64_t writtenEntryCount;
+
+    /** \brief The number of chain offsets written. */
+    uint64_t writtenOffsetCount;
+
+    /** \brief The buffered indexes. */
+    std::vector<int32_t> indexBuffer;
+
+    /** \brief The buffered coefficients. */
+    std::vector<_CoefficientType> coefficientBuffer;
+
+    /** \brief The buffered chain offsets. */
+    std::vector<uint64_t> offsetBuffer;
+
+public:
+    /**
+     * \brief Create new MatrixBuilder object.
+     *
+     * \param[in] _path The path of the output file, overwritten if it exists.
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _blockSize The number of entries buffered before being written.
+     *
+     * \throws std::runtime_error If the files cannot be created.
+     */
+    MatrixBuilder(const std::string &_path, const int _rowCount, const int _columnCount, const std::size_t _blockSize = DEFAULT_BLOCK_SIZE);
+
+    MatrixBuilder(const MatrixBuilder &_otherToCopy) = delete;
+    MatrixBuilder& operator=(const MatrixBuilder &_otherToCopy) = delete;
+
+    /**
+     * \brief Closes the files, removing them if the matrix was not finished.
+     */
+    ~MatrixBuilder();
+
+    /**
+     * \brief Adds an entry to the chain being built.
+     *
+     * Null coefficients are ignored.
+     *
+     * \param[in] _index The entry index, greater than the previous index of the chain.
+     * \param[in] _coefficient The entry coefficient.
+     *
+     * \throws std::out_of_range If all chains are built or the index is out of the chain.
+     * \throws std::invalid_argument If the index is not greater than the previous one.
+     */
+    void addEntry(const int _index, const _CoefficientType _coefficient);
+
+    /**
+     * \brief Ends the chain being built, the next entries go to the next chain.
+     *
+     * \throws std::out_of_range If all chains are built.
+     */
+    void endChain();
+
+    /**
+     * \brief Adds the entries of a chain to the chain being built and ends it.
+     *
+     * Works with any chain type iterated by (index, coefficient) pairs, the entries are sorted if needed.
+     *
+     * \param[in] _chain The chain.
+     *
+     * \throws std::out_of_range If all chains are built or an index is out of the chain.
+     */
+    template <typename _Chain>
+    void addChain(const _Chain &_chain);
+
+    /**
+     * \brief Writes the remaining chains as empty ones and completes the file.
+     *
+     * The matrix can then be loaded with OSM::MappedMatrix, and reduced once copied with OSM::MappedMatrix::toSparseMatrix.
+     *
+     * \throws std::runtime_error If the file cannot be written.
+     */
+    void finish();
+
+    /** \brief Get the index of the chain being built. */
+    int getChainIndex() const noexcept { return chainIndex; }
+
+    /** \brief Get the number of entries added. */
+    uint64_t getEntryCount() const noexcept { return entryCount; }
+
+    /** \brief Checks if the file is complete. */
+    bool isFinished() const noexcept { return descriptor < 0; }
+
+private:
+    /** \brief Get the number of chains of the matrix. */
+    int chainCount() const noexcept { return _ChainTypeFlag == COLUMN ? columnCount : rowCount; }
+
+    /** \brief Writes the buffered entries and offsets. */
+    void flush();
+
+    /**
+     * \brief Writes bytes at a position of a file.
+     *
+     * \param[in] _descriptor The file descriptor.
+     * \param[in] _data The bytes.
+     * \param[in] _size The number of bytes.
+     * \param[in] _position The position in the file.
+     *
+     * \throws std::runtime_error If the bytes cannot be written.
+     */
+    void writeAt(const int _descriptor, const void *_data, const std::size_t _size, const uint64_t _position) const;
+
+    /** \brief Closes the files. */
+    void close() noexcept;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MatrixBuilder<_CoefficientType, _ChainTypeFlag>::MatrixBuilder(const std::string &_path, const int _rowCount, const int _columnCount, const std::size_t _blockSize) :
+    path(_path),
+    coefficientsPath(_path + ".coefficients"),
+    descriptor(-1),
+    coefficientsDescriptor(-1),
+    rowCount(_rowCount),
+    columnCount(_columnCount),
+    blockSize(std::max<std::size_t>(_blockSize, 1)),
+    chainIndex(0),
+    lastIndex(-1),
+    entryCount(0),
+    writtenEntryCount(0),
+    writtenOffsetCount(0) {
+    if (_rowCount < 0 || _columnCount < 0) {
+        throw std::invalid_argument("Matrix dimensions must be positive.");
+    }
+
+    descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) {
+        throw std::runtime_error("Cannot create matrix file " + path + ".");
+    }
+
+    if (BinaryCoefficient<_CoefficientType>::size != 0) {
+        coefficientsDescriptor = open(coefficientsPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if (coefficientsDescriptor < 0) {
+            close();
+            unlink(path.c_str());
+            throw std::runtime_error("Cannot create coefficients file " + coefficientsPath + ".");
+        }
+    }
+
+    indexBuffer.reserve(blockSize);
+    offsetBuffer.push_back(0);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+MatrixBuilder<_CoefficientType, _ChainTypeFlag>::~MatrixBuilder() {
+    if (!isFinished()) {
+        close();
+        unlink(path.c_str());
+    }
+
+    if (BinaryCoefficient<_CoefficientType>::size != 0) {
+        unlink(coefficientsPath.c_str());
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::addEntry(const int _index, const _CoefficientType _coefficient) {
+    if (isFinished() || chainIndex >= chainCount()) {
+        throw std::out_of_range("All chains of the matrix are built.");
+    }
+    if (_index < 0 || _index >= (_ChainTypeFlag == COLUMN ? rowCount : columnCount)) {
+        throw std::out_of_range("Entry index out of chain bounds.");
+    }
+    if (_index <= lastIndex) {
+        throw std::invalid_argument("Entry indexes must be increasing.");
+    }
+
+    if (_coefficient == _CoefficientType(0)) {
+        return;
+    }
+
+    indexBuffer.push_back(_index);
+    if (BinaryCoefficient<_CoefficientType>::size != 0) {
+        coefficientBuffer.push_back(_coefficient);
+    }
+
+    lastIndex = _index;
+    entryCount++;
+
+    if (indexBuffer.size() >= blockSize) {
+        flush();
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::endChain() {
+    if (isFinished() || chainIndex >= chainCount()) {
+        throw std::out_of_range("All chains of the matrix are built.");
+    }
+
+    chainIndex++;
+    lastIndex = -1;
+    offsetBuffer.push_back(entryCount);
+
+    if (offsetBuffer.size() >= blockSize) {
+        flush();
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+template <typename _Chain>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::addChain(const _Chain &_chain) {
+    std::vector<std::pair<int, _CoefficientType>> entries;
+
+    for (typename _Chain::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+        entries.emplace_back(it->first, it->second);
+    }
+
+    const auto byIndex = [](const std::pair<int, _CoefficientType> &_first, const std::pair<int, _CoefficientType> &_second) {
+        return _first.first < _second.first;
+    };
+
+    if (!std::is_sorted(entries.begin(), entries.end(), byIndex)) {
+        std::sort(entries.begin(), entries.end(), byIndex);
+    }
+
+    for (const std::pair<int, _CoefficientType> &entry : entries) {
+        addEntry(entry.first, entry.second);
+    }
+
+    endChain();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::finish() {
+    if (isFinished()) {
+        return;
+    }
+
+    while (chainIndex < chainCount()) {
+        chainIndex++;
+        offsetBuffer.push_back(entryCount);
+
+        if (offsetBuffer.size() >= blockSize) {
+            flush();
+        }
+    }
+
+    flush();
+
+    const uint64_t indexesEnd = BinaryMatrixHeader::indexesPosition(chainCount()) + entryCount * sizeof(int32_t);
+    const uint64_t coefficientsBegin = BinaryMatrixHeader::coefficientsPosition(chainCount(), entryCount);
+    const char padding[8] = {0};
+
+    writeAt(descriptor, padding, coefficientsBegin - indexesEnd, indexesEnd);
+
+    if (coefficientsDescriptor >= 0) {
+        std::vector<char> chunk(blockSize * sizeof(_CoefficientType));
+        const uint64_t coefficientsSize = entryCount * sizeof(_CoefficientType);
+
+        for (uint64_t copied = 0 ; copied < coefficientsSize ; ) {
+            const ssize_t readSize = pread(coefficientsDescriptor, chunk.data(), std::min<uint64_t>(chunk.size(), coefficientsSize - copied), copied);
+
+            if (readSize <= 0) {
+                if (readSize < 0 && errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Cannot read coefficients file " + coefficientsPath + ".");
+            }
+
+            writeAt(descriptor, chunk.data(), readSize, coefficientsBegin + copied);
+            copied += readSize;
+        }
+    }
+
+    // The header is written last, an interrupted build never looks like a valid matrix.
+    const BinaryMatrixHeader header = BinaryMatrixHeader::create<_CoefficientType, _ChainTypeFlag>(rowCount, columnCount, entryCount);
+    writeAt(descriptor, &header, sizeof(header), 0);
+
+    close();
+
+    if (BinaryCoefficient<_CoefficientType>::size != 0) {
+        unlink(coefficientsPath.c_str());
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::flush() {
+    if (!indexBuffer.empty()) {
+        writeAt(descriptor, indexBuffer.data(), indexBuffer.size() * sizeof(int32_t), BinaryMatrixHeader::indexesPosition(chainCount()) + writtenEntryCount * sizeof(int32_t));
+    }
+
+    if (!coefficientBuffer.empty()) {
+        writeAt(coefficientsDescriptor, coefficientBuffer.data(), coefficientBuffer.size() * sizeof(_CoefficientType), writtenEntryCount * sizeof(_CoefficientType));
+    }
+
+    if (!offsetBuffer.empty()) {
+        writeAt(descriptor, offsetBuffer.data(), offsetBuffer.size() * sizeof(uint64_t), sizeof(BinaryMatrixHeader) + writtenOffsetCount * sizeof(uint64_t));
+    }
+
+    writtenEntryCount += indexBuffer.size();
+    writtenOffsetCount += offsetBuffer.size();
+    indexBuffer.clear();
+    coefficientBuffer.clear();
+    offsetBuffer.clear();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::writeAt(const int _descriptor, const void *_data, const std::size_t _size, const uint64_t _position) const {
+    const char *bytes = static_cast<const char*>(_data);
+
+    for (std::size_t written = 0 ; written < _size ; ) {
+        const ssize_t writeSize = pwrite(_descriptor, bytes + written, _size - written, _position + written);
+
+        if (writeSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Cannot write matrix file " + path + ".");
+        }
+
+        written += writeSize;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag>
+void MatrixBuilder<_CoefficientType, _ChainTypeFlag>::close() noexcept {
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    if (coefficientsDescriptor >= 0) {
+        ::close(coefficientsDescriptor);
+    }
+
+    descriptor = -1;
+    coefficientsDescriptor = -1;
+}
+
+}
+
+#endif
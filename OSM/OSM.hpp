@@ -13,7 +13,33 @@
 #define __OPTIMISED_SPARSED_MATRIX__
 
 #include "__base.hpp"
+#include "Coefficient.hpp"
+#include "SmallVector.hpp"
+#include "PoolAllocator.hpp"
+#include "IndexSet.hpp"
+#include "Permutation.hpp"
+#include "Storage.hpp"
+#include "ChainExpression.hpp"
+#include "ChainView.hpp"
 #include "Chain.hpp"
+#include "LazyChain.hpp"
+#include "SparseAccumulator.hpp"
+#include "SparseKernels.hpp"
+#include "ThreadPool.hpp"
 #include "SparseMatrix.hpp"
+#include "ReorientedView.hpp"
+#include "ImplicitMatrix.hpp"
+#include "Instrumentation.hpp"
+#include "Reduction.hpp"
+#include "Reordering.hpp"
+#include "SmithNormalForm.hpp"
+#include "MappedMatrix.hpp"
+#include "ChainPacket.hpp"
+#include "MatrixBuilder.hpp"
+
+#if defined(OSM_WITH_MPI)
+#include "DistributedMatrix.hpp"
+#include "DistributedReduction.hpp"
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,287 @@
+/**
+ * \file Permutation.hpp
+ * \brief Permutations of chain and entry indexes.
+ *
+ * Define everything for the Permutation class
+ */
+
+#ifndef __OSM_PERMUTATION__
+#define __OSM_PERMUTATION__
+
+
+#include "__base.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class Permutation
+ * \brief Permutation of the indexes of a range, stored with its inverse.
+ *
+ * The image of an index is its new index once permuted, the preimage of a new index is the index it comes from. Both
+ * maps are kept so that results computed on a permuted matrix translate back in constant time per index.
+ *
+ * \see \link OSM::SparseMatrix::permuted \endlink
+ */
+class Permutation {
+
+private:
+    /** \brief The new index of each index. */
+    std::vector<int> images;
+
+    /** \brief The index each new index comes from. */
+    std::vector<int> preimages;
+
+public:
+    /**
+     * \brief Create new Permutation object.
+     *
+     * Default constructor, the permutation of an empty range.
+     */
+    Permutation() = default;
+
+    /**
+     * \brief Create new Permutation object.
+     *
+     * The identity of the range.
+     *
+     * \warning Will raise an error if the size is negative.
+     *
+     * \param[in] _size The size of the range.
+     */
+    explicit Permutation(const int _size);
+
+    /**
+     * \brief Create a permutation from the new index of each index.
+     *
+     * \warning Will raise an error if the images are not a permutation of the range.
+     *
+     * \param[in] _images The new index of each index.
+     *
+     * \return The permutation.
+     */
+    static Permutation fromImages(const std::vector<int> &_images);
+
+    /**
+     * \brief Create a permutation from an ordering of the indexes.
+     *
+     * \warning Will raise an error if the order is not a permutation of the range.
+     *
+     * \param[in] _order The indexes by new index, the index placed first comes first.
+     *
+     * \return The permutation.
+     */
+    static Permutation fromOrder(const std::vector<int> &_order);
+
+    /** \brief Get the size of the range. */
+    int size() const noexcept { return images.size(); }
+
+    /** \brief New index of an index, unchecked. */
+    int operator()(const int _index) const noexcept { return images[_index]; }
+
+    /**
+     * \brief Get the new index of an index.
+     *
+     * \warning Will raise an error if the index is out of the range.
+     *
+     * \param[in] _index The index.
+     *
+     * \return The new index.
+     */
+    int image(const int _index) const;
+
+    /**
+     * \brief Get the index a new index comes from.
+     *
+     * \warning Will raise an error if the index is out of the range.
+     *
+     * \param[in] _index The new index.
+     *
+     * \return The original index.
+     */
+    int preimage(const int _index) const;
+
+    /** \brief Get the new index of each index. */
+    const std::vector<int>& getImages() const noexcept { return images; }
+
+    /** \brief Get the index each new index comes from, the ordering of the indexes. */
+    const std::vector<int>& getPreimages() const noexcept { return preimages; }
+
+    /** \brief Checks if every index is its own image. */
+    bool isIdentity() const noexcept;
+
+    /** \brief Get the inverse permutation, exchanging images and preimages. */
+    Permutation inverse() const;
+
+    /**
+     * \brief Compose two permutations.
+     *
+     * \warning Will raise an error if the ranges differ.
+     *
+     * \param[in] _first The permutation applied first.
+     *
+     * \return The permutation applying _first then this one.
+     */
+    Permutation operator*(const Permutation &_first) const;
+
+    /**
+     * \brief Moves the value of each index to its new index.
+     *
+     * \warning Will raise an error if the vector size is not the range size.
+     *
+     * \param[in] _values The values by index, the dimensions of the columns for instance.
+     *
+     * \return The values by new index.
+     */
+    template <typename _Type>
+    std::vector<_Type> permute(const std::vector<_Type> &_values) const;
+
+    /**
+     * \brief Moves the value of each new index back to its original index.
+     *
+     * \warning Will raise an error if the vector size is not the range size.
+     *
+     * \param[in] _values The values by new index, computed on a permuted matrix for instance.
+     *
+     * \return The values by original index.
+     */
+    template <typename _Type>
+    std::vector<_Type> restore(const std::vector<_Type> &_values) const;
+
+private:
+    /** \brief Computes one map from the other, checking it is a permutation. */
+    static void invert(const std::vector<int> &_map, std::vector<int> &_inverse);
+};
+
+inline Permutation::Permutation(const int _size) {
+    if (_size < 0) {
+        throw std::invalid_argument("A permutation size must be non negative.");
+    }
+
+    images.resize(_size);
+    for (int index = 0 ; index < _size ; index++) {
+        images[index] = index;
+    }
+    preimages = images;
+}
+
+inline void Permutation::invert(const std::vector<int> &_map, std::vector<int> &_inverse) {
+    const int size = _map.size();
+    _inverse.assign(size, -1);
+
+    for (int index = 0 ; index < size ; index++) {
+        const int target = _map[index];
+
+        if (target < 0 || target >= size || _inverse[target] >= 0) {
+            throw std::invalid_argument("The indexes are not a permutation of the range.");
+        }
+
+        _inverse[target] = index;
+    }
+}
+
+inline Permutation Permutation::fromImages(const std::vector<int> &_images) {
+    Permutation result;
+    result.images = _images;
+    invert(result.images, result.preimages);
+
+    return result;
+}
+
+inline Permutation Permutation::fromOrder(const std::vector<int> &_order) {
+    Permutation result;
+    result.preimages = _order;
+    invert(result.preimages, result.images);
+
+    return result;
+}
+
+inline int Permutation::image(const int _index) const {
+    if (_index < 0 || _index >= size()) {
+        throw std::out_of_range("Index out of the permutation range.");
+    }
+
+    return images[_index];
+}
+
+inline int Permutation::preimage(const int _index) const {
+    if (_index < 0 || _index >= size()) {
+        throw std::out_of_range("Index out of the permutation range.");
+    }
+
+    return preimages[_index];
+}
+
+inline bool Permutation::isIdentity() const noexcept {
+    for (int index = 0 ; index < size() ; index++) {
+        if (images[index] != index) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline Permutation Permutation::inverse() const {
+    Permutation result;
+    result.images = preimages;
+    result.preimages = images;
+
+    return result;
+}
+
+inline Permutation Permutation::operator*(const Permutation &_first) const {
+    if (_first.size() != size()) {
+        throw std::invalid_argument("Composed permutations must have the same range.");
+    }
+
+    Permutation result;
+    result.images.resize(size());
+    result.preimages.resize(size());
+
+    for (int index = 0 ; index < size() ; index++) {
+        result.images[index] = images[_first.images[index]];
+        result.preimages[result.images[index]] = index;
+    }
+
+    return result;
+}
+
+template <typename _Type>
+std::vector<_Type> Permutation::permute(const std::vector<_Type> &_values) const {
+    if (static_cast<int>(_values.size()) != size()) {
+        throw std::invalid_argument("The values must be as many as the permuted indexes.");
+    }
+
+    std::vector<_Type> result;
+    result.reserve(_values.size());
+
+    for (int index : preimages) {
+        result.push_back(_values[index]);
+    }
+
+    return result;
+}
+
+template <typename _Type>
+std::vector<_Type> Permutation::restore(const std::vector<_Type> &_values) const {
+    if (static_cast<int>(_values.size()) != size()) {
+        throw std::invalid_argument("The values must be as many as the permuted indexes.");
+    }
+
+    std::vector<_Type> result;
+    result.reserve(_values.size());
+
+    for (int index : images) {
+        result.push_back(_values[index]);
+    }
+
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * \file PoolAllocator.hpp
+ * \brief Pooled allocation of chain storage blocks.
+ *
+ * Define everything for the ChainPool and PoolAllocator classes
+ */
+
+#ifndef __OSM_POOL_ALLOCATOR__
+#define __OSM_POOL_ALLOCATOR__
+
+
+#include "__base.hpp"
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdint.h>
+
+
+namespace OSM {
+
+/**
+ * \class ChainPool
+ * \brief Thread-local caches of freed blocks, recycled by the chain storages using OSM::PoolAllocator.
+ *
+ * Blocks are rounded up to a power of two and a freed block is pushed on the free list of its size class in the cache
+ * of the freeing thread, so eliminations recycling chains of similar sizes never go through the global allocator, nor
+ * take any lock. Each thread caches at most MAXIMAL_CACHED_BYTES, the blocks freed beyond are given back directly.
+ *
+ * The cached blocks are released in bulk by release for the calling thread, and by releaseAll for every thread, each
+ * other thread releasing its cache on its next use of the pool.
+ */
+class ChainPool {
+
+public:
+    /** \brief The smallest block size, blocks are at least big enough to hold a free list link. */
+    static constexpr std::size_t MINIMAL_BLOCK_SIZE = 16;
+
+    /** \brief The biggest pooled block size, bigger blocks always go through the global allocator. */
+    static constexpr std::size_t MAXIMAL_BLOCK_SIZE = std::size_t(1) << 16;
+
+    /** \brief The number of bytes each thread may keep in its cache. */
+    static constexpr std::size_t MAXIMAL_CACHED_BYTES = std::size_t(1) << 24;
+
+private:
+    /** \brief The number of size classes, from MINIMAL_BLOCK_SIZE to MAXIMAL_BLOCK_SIZE. */
+    static constexpr std::size_t CLASS_COUNT = 13;
+
+    /** \brief A cached block, linked to the next cached block of the same size class. */
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    /** \brief The free lists of a thread. */
+    struct ThreadCache {
+        /** \brief The first cached block of each size class. */
+        FreeBlock *heads[CLASS_COUNT] = {};
+
+        /** \brief The number of cached bytes. */
+        std::size_t cachedBytes = 0;
+
+        /** \brief The value of the release generation when the cache was last released. */
+        uint64_t generation = 0;
+
+        /** \brief Gives the cached blocks back to the global allocator. */
+        void clear() noexcept;
+
+        /** \brief Releases the cache if releaseAll was called since the last release. */
+        void synchronize() noexcept;
+
+        ~ThreadCache();
+    };
+
+public:
+    /**
+     * \brief Allocates a block of at least the given size.
+     *
+     * \param[in] _size The size in bytes.
+     *
+     * \return The block, aligned for any fundamental type.
+     *
+     * \throws std::bad_alloc If the global allocator fails.
+     */
+    static void* allocate(const std::size_t _size);
+
+    /**
+     * \brief Gives back a block returned by allocate.
+     *
+     * \param[in] _block The block.
+     * \param[in] _size The size given to allocate.
+     */
+    static void deallocate(void *_block, const std::size_t _size) noexcept;
+
+    /**
+     * \brief Gives the blocks cached by the calling thread back to the global allocator.
+     */
+    static void release() noexcept;
+
+    /**
+     * \brief Gives the blocks cached by every thread back to the global allocator.
+     *
+     * The calling thread releases its cache immediately, the others on their next allocation or deallocation.
+     */
+    static void releaseAll() noexcept;
+
+    /**
+     * \brief Get the number of bytes cached by the calling thread.
+     *
+     * \return The cached bytes.
+     */
+    static std::size_t getCachedBytes() noexcept;
+
+private:
+    /**
+     * \brief Get the size class of a block size.
+     *
+     * \param[in] _size The size in bytes, at most MAXIMAL_BLOCK_SIZE.
+     *
+     * \return The size class, the block size being MINIMAL_BLOCK_SIZE shifted by it.
+     */
+    static inline std::size_t sizeClass(const std::size_t _size) noexcept;
+
+    /** \brief Get the cache of the calling thread, null once the thread cache was destroyed. */
+    static inline ThreadCache* localCache() noexcept;
+
+    /** \brief The release generation, incremented by releaseAll. */
+    static inline std::atomic<uint64_t>& releaseGeneration() noexcept;
+};
+
+/**
+ * \class PoolAllocator
+ * \brief Stateless allocator recycling blocks through the thread-local caches of OSM::ChainPool.
+ *
+ * Use it as the allocator of OSM::SortedStorage or OSM::MapStorage so that the chains of a matrix recycle the blocks
+ * freed by the eliminations running on the same thread.
+ *
+ * \tparam _Type The allocated type.
+ */
+template <typename _Type>
+class PoolAllocator {
+
+public:
+    typedef _Type value_type;
+    typedef std::true_type is_always_equal;
+
+    /** \brief Over-aligned types can not be served by the pool. */
+    static constexpr bool POOLED = alignof(_Type) <= alignof(std::max_align_t);
+
+    PoolAllocator() noexcept = default;
+
+    template <typename _OtherType>
+    PoolAllocator(const PoolAllocator<_OtherType> &) noexcept {}
+
+    /**
+     * \brief Allocates an array.
+     *
+     * \param[in] _count The number of elements.
+     *
+     * \return The uninitialized array.
+     *
+     * \throws std::bad_array_new_length If the array size overflows.
+     * \throws std::bad_alloc If the global allocator fails.
+     */
+    _Type* allocate(const std::size_t _count);
+
+    /**
+     * \brief Gives back an array returned by allocate.
+     *
+     * \param[in] _array The array.
+     * \param[in] _count The number of elements given to allocate.
+     */
+    void deallocate(_Type *_array, const std::size_t _count) noexcept;
+};
+
+template <typename _Type, typename _OtherType>
+constexpr bool operator==(const PoolAllocator<_Type> &, const PoolAllocator<_OtherType> &) noexcept {
+    return true;
+}
+
+template <typename _Type, typename _OtherType>
+constexpr bool operator!=(const PoolAllocator<_Type> &, const PoolAllocator<_OtherType> &) noexcept {
+    return false;
+}
+
+inline void ChainPool::ThreadCache::clear() noexcept {
+    for (std::size_t sizeClass = 0 ; sizeClass < CLASS_COUNT ; sizeClass++) {
+        while (heads[sizeClass] != nullptr) {
+            FreeBlock *block = heads[sizeClass];
+            heads[sizeClass] = block->next;
+            ::operator delete(block);
+        }
+    }
+
+    cachedBytes = 0;
+}
+
+inline void ChainPool::ThreadCache::synchronize() noexcept {
+    const uint64_t current = releaseGeneration().load(std::memory_order_relaxed);
+
+    if (generation != current) {
+        clear();
+        generation = current;
+    }
+}
+
+inline ChainPool::ThreadCache::~ThreadCache() {
+    clear();
+}
+
+inline std::size_t ChainPool::sizeClass(const std::size_t _size) noexcept {
+    if (_size <= MINIMAL_BLOCK_SIZE) {
+        return 0;
+    }
+
+    return 64 - countLeadingZeros(uint64_t(_size - 1)) - 4;
+}
+
+inline ChainPool::ThreadCache* ChainPool::localCache() noexcept {
+    // The flag is trivially destructible, so it stays readable by the thread local objects destroyed after the cache.
+    static thread_local bool destroyed = false;
+    struct Guard {
+        ThreadCache cache;
+        ~Guard() { destroyed = true; }
+    };
+    static thread_local Guard guard;
+
+    return destroyed ? nullptr : &guard.cache;
+}
+
+inline std::atomic<uint64_t>& ChainPool::releaseGeneration() noexcept {
+    static std::atomic<uint64_t> generation(0);
+
+    return generation;
+}
+
+inline void* ChainPool::allocate(const std::size_t _size) {
+    if (_size > MAXIMAL_BLOCK_SIZE) {
+        return ::operator new(_size);
+    }
+
+    const std::size_t blockClass = sizeClass(_size);
+    ThreadCache *cache = localCache();
+
+    if (cache != nullptr) {
+        cache->synchronize();
+
+        FreeBlock *block = cache->heads[blockClass];
+        if (block != nullptr) {
+            cache->heads[blockClass] = block->next;
+            cache->cachedBytes -= MINIMAL_BLOCK_SIZE << blockClass;
+
+            return block;
+        }
+    }
+
+    return ::operator new(MINIMAL_BLOCK_SIZE << blockClass);
+}
+
+inline void ChainPool::deallocate(void *_block, const std::size_t _size) noexcept {
+    if (_block == nullptr) {
+        return;
+    }
+
+    ThreadCache *cache = _size <= MAXIMAL_BLOCK_SIZE ? localCache() : nullptr;
+
+    if (cache != nullptr) {
+        cache->synchronize();
+
+        const std::size_t blockClass = sizeClass(_size);
+        const std::size_t blockSize = MINIMAL_BLOCK_SIZE << blockClass;
+
+        if (cache->cachedBytes + blockSize <= MAXIMAL_CACHED_BYTES) {
+            FreeBlock *block = static_cast<FreeBlock*>(_block);
+            block->next = cache->heads[blockClass];
+            cache->heads[blockClass] = block;
+            cache->cachedBytes += blockSize;
+
+            return;
+        }
+    }
+
+    ::operator delete(_block);
+}
+
+inline void ChainPool::release() noexcept {
+    ThreadCache *cache = localCache();
+
+    if (cache != nullptr) {
+        cache->clear();
+    }
+}
+
+inline void ChainPool::releaseAll() noexcept {
+    releaseGeneration().fetch_add(1, std::memory_order_relaxed);
+
+    ThreadCache *cache = localCache();
+
+    if (cache != nullptr) {
+        cache->synchronize();
+    }
+}
+
+inline std::size_t ChainPool::getCachedBytes() noexcept {
+    ThreadCache *cache = localCache();
+
+    return cache != nullptr ? cache->cachedBytes : 0;
+}
+
+template <typename _Type>
+_Type* PoolAllocator<_Type>::allocate(const std::size_t _count) {
+    if (_count > std::numeric_limits<std::size_t>::max() / sizeof(_Type)) {
+        throw std::bad_array_new_length();
+    }
+
+    if constexpr (POOLED) {
+        return static_cast<_Type*>(ChainPool::allocate(_count * sizeof(_Type)));
+    } else {
+        return std::allocator<_Type>().allocate(_count);
+    }
+}
+
+template <typename _Type>
+void PoolAllocator<_Type>::deallocate(_Type *_array, const std::size_t _count) noexcept {
+    if constexpr (POOLED) {
+        ChainPool::deallocate(_array, _count * sizeof(_Type));
+    } else {
+        std::allocator<_Type>().deallocate(_array, _count);
+    }
+}
+
+}
+
+#endif
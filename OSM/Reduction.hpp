@@ -0,0 +1,982 @@
+/**
+ * \file Reduction.hpp
+ * \brief Persistent homology column reduction with clearing, compression and parallel chunks.
+ *
+ * Define everything for the ColumnReduction class
+ */
+
+#ifndef __OSM_REDUCTION__
+#define __OSM_REDUCTION__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include "Chain.hpp"
+#include "LazyChain.hpp"
+#include "SparseMatrix.hpp"
+#include "ImplicitMatrix.hpp"
+#include "Instrumentation.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \brief The optimizations of the column reduction.
+ *
+ * \see \link OSM::ColumnReduction \endlink
+ */
+enum ReductionOptimization {
+    /** \brief Plain left-to-right reduction. */
+    NO_OPTIMIZATION,
+
+    /** \brief Reduces by decreasing dimension and clears the column of each birth, which would reduce to zero. */
+    CLEARING,
+
+    /** \brief Reduces by increasing dimension and removes the rows of the deaths, which can never be pivots. */
+    COMPRESSION
+};
+
+/**
+ * \brief A persistence pair, the indexes of the columns creating and destroying a class.
+ */
+struct PersistencePair {
+    /** \brief The column creating the class, the pivot row of the death column. */
+    int birth;
+
+    /** \brief The column destroying the class. */
+    int death;
+};
+
+/**
+ * \brief The result of a column reduction.
+ */
+struct PersistenceDiagram {
+    /** \brief The persistence pairs, by increasing birth. */
+    std::vector<PersistencePair> pairs;
+
+    /** \brief The columns creating a class never destroyed, by increasing index. */
+    std::vector<int> essentials;
+};
+
+/**
+ * \class ColumnReduction
+ * \brief Standard persistent homology reduction of a boundary matrix.
+ *
+ * Reduces the columns of a square column-based boundary matrix, ordered by filtration, until no two columns share
+ * the same pivot (their greatest row index). Each column is reduced by adding multiples of the previously reduced
+ * columns found in the pivot table (row to reduced column), with the fused OSM::SparseMatrix::addScaledChain.
+ *
+ * Given the dimension of each column, two optimizations are available:
+ * - OSM::CLEARING processes the dimensions from the highest one, when column j gets pivot i the column i is a birth
+ *   and is cleared without being reduced.
+ * - OSM::COMPRESSION processes the dimensions from the lowest one, the rows of the deaths of the lower dimension are
+ *   removed from each column before reducing it.
+ *
+ * Given a thread pool, the matrix is reduced in chunks: the columns are split in contiguous chunks reduced in parallel,
+ * each column only with the columns of its chunk while its pivot lies in the chunk. Such a column is paired for good, since
+ * no lower chunk column can reach this pivot, and its birth is cleared. The remaining global columns are compressed in
+ * parallel, then reduced sequentially in dimension order with clearing. A chunk only claims the pivots of its own
+ * rows, the pivot table is an atomic array shared without lock.
+ *
+ * With the apparent pair shortcut, the pairs readable from the chain structure are found first in a single parallel
+ * pass: column j makes an apparent pair with its pivot i when j is the first column having row i. Column j is already
+ * reduced and is skipped, it is only kept as the reducer of pivot i, and column i is cleared. Boundary matrices of
+ * Vietoris-Rips filtrations resolve most of their columns this way.
+ *
+ * With lazy accumulation, a column having a reducer is reduced as an OSM::LazyChain: the reducers are pushed on a heap
+ * consolidated only at the pivot, and the column is merged once at the end. This pays off on the columns reduced
+ * against many reducers, such as the high dimensional columns of a Vietoris-Rips filtration.
+ *
+ * Given OSM::CountingInstrumentation or a policy derived from it, the reduction counts the chain additions and their
+ * fill-in per worker, the fill-in per column and the histogram of the reduced column sizes, and times its phases.
+ * OSM::NoInstrumentation compiles everything out.
+ *
+ * An OSM::ImplicitMatrix is reduced without ever being stored: each column is generated when processed, and only the
+ * columns the reduction modified are kept as reducers, the others are generated again through the matrix cache when
+ * needed. This reduction is sequential, the chunks need the columns in place.
+ *
+ * \warning The matrix is reduced in place. With OSM::COMPRESSION or in chunks, the reduced columns miss the removed rows, the pairs are still exact.
+ *
+ * \pre The matrix stores no null coefficient.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ * \tparam _Instrumentation The instrumentation policy (default is OSM::NoInstrumentation)
+ *
+ * \see \link OSM::SparseMatrix \endlink
+ * \see \link OSM::PersistenceDiagram \endlink
+ */
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+class ColumnReduction {
+
+public:
+    /** \brief The reduced matrix type. */
+    typedef SparseMatrix<_CoefficientType, COLUMN, _StorageType> Matrix;
+
+    /** \brief The implicit matrix type, generating its columns. */
+    typedef ImplicitMatrix<_CoefficientType, COLUMN, _StorageType> Implicit;
+
+private:
+    /**
+     * \brief The columns of an implicit matrix seen by the reduction, the stored reduced column or the generated one.
+     */
+    struct ImplicitColumns {
+        /** \brief The implicit matrix. */
+        const Implicit &matrix;
+
+        /** \brief The columns modified by the reduction. */
+        const std::unordered_map<int, typename Matrix::MatrixChain> &reduced;
+
+        /** \brief Keeps the last generated column alive while it is read. */
+        mutable typename Implicit::ChainHandle holder;
+
+        ChainView<_CoefficientType, COLUMN, _StorageType> operator[](const int _index) const {
+            const typename std::unordered_map<int, typename Matrix::MatrixChain>::const_iterator it = reduced.find(_index);
+            if (it != reduced.end()) {
+                return it->second;
+            }
+
+            holder = matrix[_index];
+            return *holder;
+        }
+    };
+
+    /** \brief The dimension of each column, empty if unknown. */
+    std::vector<int> dimensions;
+
+    /** \brief The optimization used. */
+    ReductionOptimization optimization;
+
+    /** \brief For each row, the reduced column having it as pivot, -1 if none. */
+    std::vector<std::atomic<int>> pivots;
+
+    /** \brief The pool reducing the chunks, the one of the matrix if null. */
+    ThreadPool *threadPool;
+
+    /** \brief Whether the apparent pairs are found before the reduction. */
+    bool apparentPairShortcut;
+
+    /** \brief Whether the columns are reduced as lazy chains. */
+    bool lazyAccumulation;
+
+    /** \brief The apparent pairs of the last reduction, by increasing death. */
+    std::vector<PersistencePair> apparentPairs;
+
+    /** \brief Whether each column was resolved by an apparent pair of the last reduction. */
+    std::vector<char> resolved;
+
+    /** \brief The statistics of the last reduction, left empty without instrumentation. */
+    ReductionStatistics statistics;
+
+public:
+    /**
+     * \brief Create new ColumnReduction object.
+     *
+     * Default constructor, a plain reduction without optimization.
+     */
+    ColumnReduction();
+
+    /**
+     * \brief Create new ColumnReduction object.
+     *
+     * \param[in] _dimensions The dimension of each column.
+     * \param[in] _optimization The optimization to use (default is OSM::CLEARING).
+     */
+    explicit ColumnReduction(const std::vector<int> &_dimensions, const ReductionOptimization _optimization = CLEARING);
+
+    /**
+     * \brief Reduces a boundary matrix and computes its persistence pairs.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     * \warning Will raise an error if an optimization is used and the number of dimensions is not the number of columns.
+     * \warning Will raise an error if a pivot cannot be cancelled over the coefficients.
+     *
+     * \param[in,out] _matrix The boundary matrix, reduced in place.
+     *
+     * \return The persistence pairs and the essential classes.
+     */
+    PersistenceDiagram reduce(Matrix &_matrix);
+
+    /**
+     * \brief Reduces an implicit boundary matrix and computes its persistence pairs.
+     *
+     * The columns are generated in the reduction order, the ones left unchanged by the reduction are never stored.
+     * The apparent pairs are found in parallel given a thread pool, the reduction itself is sequential.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     * \warning Will raise an error if an optimization is used and the number of dimensions is not the number of columns.
+     * \warning Will raise an error if a pivot cannot be cancelled over the coefficients.
+     *
+     * \param[in] _matrix The implicit boundary matrix, whose generator must be thread safe given a thread pool.
+     *
+     * \return The persistence pairs and the essential classes.
+     *
+     * \see \link OSM::ImplicitMatrix \endlink
+     */
+    PersistenceDiagram reduce(const Implicit &_matrix);
+
+    /**
+     * \brief Get the pivot table of the last reduction.
+     *
+     * \warning Will raise an error if the row is out of the last reduced matrix.
+     *
+     * \param[in] _row The row index.
+     *
+     * \return The reduced column having the row as pivot, -1 if none.
+     */
+    int getPivot(const int _row) const;
+
+    /**
+     * \brief Set the thread pool used to reduce the matrix in chunks.
+     *
+     * \param[in] _threadPool The pool to use, null to use the one of the matrix.
+     *
+     * \see \link OSM::ThreadPool \endlink
+     */
+    void setThreadPool(ThreadPool *_threadPool) noexcept { threadPool = _threadPool; }
+
+    /** \brief Get the thread pool used to reduce the matrix in chunks. */
+    ThreadPool* getThreadPool() const noexcept { return threadPool; }
+
+    /** \brief Get the optimization used. */
+    ReductionOptimization getOptimization() const noexcept { return optimization; }
+
+    /**
+     * \brief Set whether the apparent pairs are found and skipped before the reduction.
+     *
+     * \param[in] _enabled Whether to use the shortcut, disabled by default.
+     */
+    void setApparentPairShortcut(const bool _enabled) noexcept { apparentPairShortcut = _enabled; }
+
+    /** \brief Checks if the apparent pairs are found and skipped before the reduction. */
+    bool hasApparentPairShortcut() const noexcept { return apparentPairShortcut; }
+
+    /**
+     * \brief Set whether the columns are reduced as lazy chains.
+     *
+     * Worth it over sorted storages for columns reduced against hundreds of reducers, slower on short reductions.
+     * The fill-in counters of a lazily reduced column are its net size change, its additions cause no reallocation.
+     *
+     * \param[in] _enabled Whether to accumulate the reducers lazily, disabled by default.
+     *
+     * \see \link OSM::LazyChain \endlink
+     */
+    void setLazyAccumulation(const bool _enabled) noexcept { lazyAccumulation = _enabled; }
+
+    /** \brief Checks if the columns are reduced as lazy chains. */
+    bool hasLazyAccumulation() const noexcept { return lazyAccumulation; }
+
+    /** \brief Get the apparent pairs of the last reduction, empty without the shortcut. */
+    const std::vector<PersistencePair>& getApparentPairs() const noexcept { return apparentPairs; }
+
+    /**
+     * \brief Finds the apparent pairs of a boundary matrix.
+     *
+     * Column j and its pivot i make an apparent pair when no column before j has row i, so that no reduction can
+     * ever change the pivot of column j. The first column of each row is found in parallel, given a pool.
+     *
+     * \param[in] _matrix The boundary matrix.
+     * \param[in] _threadPool The pool to use, may be null (default is null).
+     *
+     * \return The apparent pairs, by increasing death.
+     */
+    static std::vector<PersistencePair> findApparentPairs(const Matrix &_matrix, ThreadPool *_threadPool = nullptr);
+
+    /**
+     * \brief Finds the apparent pairs of an implicit boundary matrix.
+     *
+     * Each column is generated once, without going through the matrix cache.
+     *
+     * \param[in] _matrix The implicit boundary matrix, whose generator must be thread safe given a thread pool.
+     * \param[in] _threadPool The pool to use, may be null (default is null).
+     *
+     * \return The apparent pairs, by increasing death.
+     */
+    static std::vector<PersistencePair> findApparentPairs(const Implicit &_matrix, ThreadPool *_threadPool = nullptr);
+
+    /**
+     * \brief Get the statistics of the last reduction.
+     *
+     * The fill-in of an implicit matrix column is measured against its generated column.
+     *
+     * \return The statistics, empty unless the instrumentation policy is enabled.
+     *
+     * \see \link OSM::CountingInstrumentation \endlink
+     */
+    const ReductionStatistics& getStatistics() const noexcept { return statistics; }
+
+private:
+    /**
+     * \brief Reduces the matrix on the calling thread.
+     *
+     * \param[in,out] _matrix The matrix.
+     */
+    void reduceSequentially(Matrix &_matrix);
+
+    /**
+     * \brief Reduces the matrix in chunks of columns, in parallel.
+     *
+     * \param[in,out] _matrix The matrix.
+     * \param[in] _pool The pool to use.
+     */
+    void reduceInChunks(Matrix &_matrix, ThreadPool &_pool);
+
+    /**
+     * \brief Finds the apparent pairs given access to the columns.
+     *
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _weights The cost of reading each column.
+     * \param[in] _column Gives the column of an index, by reference or by value.
+     * \param[in] _threadPool The pool to use, may be null.
+     *
+     * \return The apparent pairs, by increasing death.
+     */
+    template <typename _ColumnAccess>
+    static std::vector<PersistencePair> findApparentPairs(const int _rowCount, const std::vector<std::size_t> &_weights, const _ColumnAccess &_column, ThreadPool *_threadPool);
+
+    /**
+     * \brief Reduces a column against the pivot table, as a lazy chain with lazy accumulation.
+     *
+     * Stops as soon as the pivot is lower than the given row.
+     *
+     * \param[in,out] _column The column.
+     * \param[in] _columns The reducers, the matrix or the columns of an implicit matrix.
+     * \param[in] _worker The index of the calling worker, whose counters are updated.
+     * \param[in] _lowestPivot The lowest pivot that may be cancelled (default is 0).
+     *
+     * \return The pivot of the reduced column, -1 if it is null.
+     */
+    template <typename _Columns>
+    int reduceColumn(typename Matrix::MatrixChain &_column, const _Columns &_columns, const std::size_t _worker, const int _lowestPivot = 0);
+
+    /**
+     * \brief Adds the reducers to a column until its pivot has none.
+     *
+     * \param[in,out] _column The column, a regular or a lazy chain.
+     * \param[in] _columns The reducers.
+     * \param[in] _worker The index of the calling worker, whose counters are updated.
+     * \param[in] _lowestPivot The lowest pivot that may be cancelled.
+     *
+     * \return The pivot of the reduced column, -1 if it is null.
+     */
+    template <typename _Column, typename _Columns>
+    int addReducers(_Column &_column, const _Columns &_columns, const std::size_t _worker, const int _lowestPivot);
+
+    /**
+     * \brief Removes the rows of the deaths from a column.
+     *
+     * \param[in,out] _column The column.
+     * \param[in] _deaths Whether each row is the index of a death.
+     */
+    static void compressColumn(typename Matrix::MatrixChain &_column, const std::vector<char> &_deaths);
+
+    /**
+     * \brief Orders columns by dimension, by index order without dimensions.
+     *
+     * \param[in] _first The first column.
+     * \param[in] _last The column after the last one.
+     * \param[in] _increasing Whether the lowest dimension comes first.
+     *
+     * \return The columns indexes, by filtration order inside a dimension.
+     */
+    std::vector<int> columnsByDimension(const int _first, const int _last, const bool _increasing) const;
+};
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::ColumnReduction() : optimization(NO_OPTIMIZATION), threadPool(nullptr), apparentPairShortcut(false), lazyAccumulation(false) {}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::ColumnReduction(const std::vector<int> &_dimensions, const ReductionOptimization _optimization) :
+    dimensions(_dimensions),
+    optimization(_optimization),
+    threadPool(nullptr),
+    apparentPairShortcut(false),
+    lazyAccumulation(false) {
+    for (int dimension : dimensions) {
+        if (dimension < 0) {
+            throw std::invalid_argument("Dimensions must be non negative.");
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+PersistenceDiagram ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::reduce(Matrix &_matrix) {
+    const int size = _matrix.getColumnCount();
+
+    if (_matrix.getRowCount() != size) {
+        throw std::invalid_argument("A boundary matrix must be square.");
+    }
+
+    if (optimization != NO_OPTIMIZATION && static_cast<int>(dimensions.size()) != size) {
+        throw std::invalid_argument("The optimizations need the dimension of each column.");
+    }
+
+    pivots = std::vector<std::atomic<int>>(size);
+    for (std::atomic<int> &pivot : pivots) {
+        pivot.store(-1, std::memory_order_relaxed);
+    }
+
+    const ScopedTrace<_Instrumentation> trace("reduction");
+    ThreadPool *pool = threadPool != nullptr ? threadPool : _matrix.getThreadPool();
+    const bool chunked = pool != nullptr && pool->size() > 1;
+
+    if constexpr (_Instrumentation::ENABLED) {
+        statistics = ReductionStatistics();
+        statistics.workers.resize(chunked ? pool->size() : 1);
+        statistics.columnFillIn.resize(size);
+
+        for (int column = 0 ; column < size ; column++) {
+            statistics.columnFillIn[column] = -static_cast<int>(_matrix.chains[column].size());
+        }
+    }
+
+    // The apparent births are cleared, as they would reduce to zero
+    apparentPairs.clear();
+    resolved.assign(size, false);
+
+    if (apparentPairShortcut) {
+        apparentPairs = findApparentPairs(_matrix, pool);
+
+        for (const PersistencePair &pair : apparentPairs) {
+            pivots[pair.birth].store(pair.death, std::memory_order_relaxed);
+            resolved[pair.death] = true;
+
+            _matrix.chains[pair.birth] = typename Matrix::MatrixChain(size);
+            _matrix.updateChainState(pair.birth, true);
+        }
+    }
+
+    if (chunked) {
+        reduceInChunks(_matrix, *pool);
+    } else {
+        reduceSequentially(_matrix);
+    }
+
+    if constexpr (_Instrumentation::ENABLED) {
+        for (const ReductionCounters &counters : statistics.workers) {
+            statistics.total += counters;
+        }
+        statistics.apparentPairs = apparentPairs.size();
+
+        for (int column = 0 ; column < size ; column++) {
+            statistics.columnFillIn[column] += static_cast<int>(_matrix.chains[column].size());
+            statistics.recordSize(_matrix.chains[column].size());
+        }
+    }
+
+    // The blocks freed by the eliminations are only worth caching while a reduction runs.
+    ChainPool::releaseAll();
+
+    PersistenceDiagram diagram;
+    const Matrix &matrix = _matrix;
+
+    for (int row = 0 ; row < size ; row++) {
+        const int death = pivots[row].load(std::memory_order_relaxed);
+
+        if (death >= 0) {
+            diagram.pairs.push_back(PersistencePair{row, death});
+        } else if (matrix[row].size() == 0) {
+            diagram.essentials.push_back(row);
+        }
+    }
+
+    return diagram;
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+PersistenceDiagram ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::reduce(const Implicit &_matrix) {
+    const int size = _matrix.getColumnCount();
+
+    if (_matrix.getRowCount() != size) {
+        throw std::invalid_argument("A boundary matrix must be square.");
+    }
+
+    if (optimization != NO_OPTIMIZATION && static_cast<int>(dimensions.size()) != size) {
+        throw std::invalid_argument("The optimizations need the dimension of each column.");
+    }
+
+    pivots = std::vector<std::atomic<int>>(size);
+    for (std::atomic<int> &pivot : pivots) {
+        pivot.store(-1, std::memory_order_relaxed);
+    }
+
+    const ScopedTrace<_Instrumentation> trace("reduction");
+
+    if constexpr (_Instrumentation::ENABLED) {
+        statistics = ReductionStatistics();
+        statistics.workers.resize(1);
+        statistics.columnFillIn.assign(size, 0);
+    }
+
+    // The cleared columns and the columns reduced to zero, which the matrix cannot tell once reduced
+    std::vector<char> cleared(size, false);
+    std::vector<char> deaths(size, false);
+    std::vector<char> zero(size, false);
+
+    apparentPairs.clear();
+    resolved.assign(size, false);
+
+    if (apparentPairShortcut) {
+        apparentPairs = findApparentPairs(_matrix, threadPool);
+
+        for (const PersistencePair &pair : apparentPairs) {
+            pivots[pair.birth].store(pair.death, std::memory_order_relaxed);
+            resolved[pair.death] = true;
+            cleared[pair.birth] = true;
+            deaths[pair.death] = true;
+        }
+    }
+
+    std::vector<int> order(size);
+    if (optimization == NO_OPTIMIZATION) {
+        for (int column = 0 ; column < size ; column++) {
+            order[column] = column;
+        }
+    } else {
+        order = columnsByDimension(0, size, optimization == COMPRESSION);
+    }
+
+    std::unordered_map<int, typename Matrix::MatrixChain> reducedColumns;
+    const ImplicitColumns columns{_matrix, reducedColumns, nullptr};
+
+    {
+        const ScopedTrace<_Instrumentation> trace("reduction.sequential");
+
+        for (int column : order) {
+            if (cleared[column]) {
+                if constexpr (_Instrumentation::ENABLED) {
+                    statistics.recordSize(0);
+                }
+                continue;
+            }
+
+            typename Matrix::MatrixChain working = *_matrix[column];
+            const std::size_t generatedSize = working.size();
+            const int initialPivot = working.lastIndex();
+
+            if (optimization == COMPRESSION) {
+                // An apparent death is still compressed, since it reduces the columns sharing its pivot
+                compressColumn(working, deaths);
+            }
+
+            bool modified = working.size() != generatedSize;
+            int pivot = initialPivot;
+
+            if (!resolved[column]) {
+                pivot = reduceColumn(working, columns, 0);
+                modified = modified || pivot != initialPivot;
+
+                if (pivot >= 0) {
+                    pivots[pivot].store(column, std::memory_order_relaxed);
+
+                    if (optimization == CLEARING) {
+                        cleared[pivot] = true;
+                    } else if (optimization == COMPRESSION) {
+                        deaths[column] = true;
+                    }
+                } else {
+                    zero[column] = true;
+                }
+            }
+
+            if constexpr (_Instrumentation::ENABLED) {
+                statistics.columnFillIn[column] = static_cast<int>(working.size()) - static_cast<int>(generatedSize);
+                statistics.recordSize(working.size());
+            }
+
+            // A column keeping its pivot without losing an entry is its own generated column, read through the cache
+            if (modified && pivot >= 0) {
+                reducedColumns.emplace(column, std::move(working));
+            }
+        }
+    }
+
+    if constexpr (_Instrumentation::ENABLED) {
+        statistics.total = statistics.workers[0];
+        statistics.apparentPairs = apparentPairs.size();
+    }
+
+    reducedColumns.clear();
+    ChainPool::releaseAll();
+
+    PersistenceDiagram diagram;
+
+    for (int row = 0 ; row < size ; row++) {
+        const int death = pivots[row].load(std::memory_order_relaxed);
+
+        if (death >= 0) {
+            diagram.pairs.push_back(PersistencePair{row, death});
+        } else if (zero[row]) {
+            diagram.essentials.push_back(row);
+        }
+    }
+
+    return diagram;
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+std::vector<PersistencePair> ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::findApparentPairs(const Matrix &_matrix, ThreadPool *_threadPool) {
+    std::vector<std::size_t> weights(_matrix.getColumnCount());
+    for (std::size_t column = 0 ; column < weights.size() ; column++) {
+        weights[column] = _matrix.chains[column].size();
+    }
+
+    return findApparentPairs(_matrix.getRowCount(), weights, [&](const int _index) -> const typename Matrix::MatrixChain& { return _matrix.chains[_index]; }, _threadPool);
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+std::vector<PersistencePair> ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::findApparentPairs(const Implicit &_matrix, ThreadPool *_threadPool) {
+    const std::vector<std::size_t> weights(_matrix.getColumnCount(), 1);
+
+    return findApparentPairs(_matrix.getRowCount(), weights, [&](const int _index) { return _matrix.generate(_index); }, _threadPool);
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+template <typename _ColumnAccess>
+std::vector<PersistencePair> ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::findApparentPairs(const int _rowCount, const std::vector<std::size_t> &_weights, const _ColumnAccess &_column, ThreadPool *_threadPool) {
+    const ScopedTrace<_Instrumentation> trace("reduction.apparent");
+    const int size = _weights.size();
+    std::vector<std::atomic<int>> firstColumns(_rowCount);
+    std::vector<int> lastRows(size);
+
+    for (std::atomic<int> &firstColumn : firstColumns) {
+        firstColumn.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+    }
+
+    ThreadPool::forEachWeighted(_threadPool, _weights, [&](const std::size_t _index, const std::size_t) {
+        const int column = _index;
+        const typename Matrix::MatrixChain &chain = _column(column);
+
+        for (typename Matrix::MatrixChain::const_iterator it = chain.cbegin() ; it != chain.cend() ; ++it) {
+            std::atomic<int> &firstColumn = firstColumns[it->first];
+            int current = firstColumn.load(std::memory_order_relaxed);
+
+            while (column < current && !firstColumn.compare_exchange_weak(current, column, std::memory_order_relaxed)) {}
+        }
+        lastRows[column] = chain.lastIndex();
+    });
+
+    std::vector<PersistencePair> pairs;
+    for (int column = 0 ; column < size ; column++) {
+        const int pivot = lastRows[column];
+
+        if (pivot >= 0 && pivot < column && firstColumns[pivot].load(std::memory_order_relaxed) == column) {
+            pairs.push_back(PersistencePair{pivot, column});
+        }
+    }
+
+    return pairs;
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+int ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::getPivot(const int _row) const {
+    if (_row < 0 || _row >= static_cast<int>(pivots.size())) {
+        throw std::out_of_range("Row index out of the reduced matrix.");
+    }
+
+    return pivots[_row].load(std::memory_order_relaxed);
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+void ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::reduceSequentially(Matrix &_matrix) {
+    const ScopedTrace<_Instrumentation> trace("reduction.sequential");
+    const int size = _matrix.getColumnCount();
+
+    if (optimization == CLEARING) {
+        std::vector<char> cleared(size, false);
+
+        for (const PersistencePair &pair : apparentPairs) {
+            cleared[pair.birth] = true;
+        }
+
+        for (int column : columnsByDimension(0, size, false)) {
+            if (cleared[column] || resolved[column]) {
+                continue;
+            }
+
+            const int pivot = reduceColumn(_matrix.chains[column], _matrix, 0);
+            _matrix.updateChainState(column, pivot < 0);
+
+            if (pivot >= 0) {
+                pivots[pivot].store(column, std::memory_order_relaxed);
+
+                _matrix.chains[pivot] = typename Matrix::MatrixChain(size);
+                _matrix.updateChainState(pivot, true);
+                cleared[pivot] = true;
+            }
+        }
+    } else if (optimization == COMPRESSION) {
+        std::vector<char> deaths(size, false);
+
+        for (const PersistencePair &pair : apparentPairs) {
+            deaths[pair.death] = true;
+        }
+
+        for (int column : columnsByDimension(0, size, true)) {
+            // An apparent death is still compressed, since it reduces the columns sharing its pivot
+            compressColumn(_matrix.chains[column], deaths);
+            if (resolved[column]) {
+                _matrix.updateChainState(column, _matrix.chains[column].size() == 0);
+                continue;
+            }
+
+            const int pivot = reduceColumn(_matrix.chains[column], _matrix, 0);
+            _matrix.updateChainState(column, pivot < 0);
+
+            if (pivot >= 0) {
+                pivots[pivot].store(column, std::memory_order_relaxed);
+                deaths[column] = true;
+            }
+        }
+    } else {
+        for (int column = 0 ; column < size ; column++) {
+            if (resolved[column]) {
+                continue;
+            }
+
+            const int pivot = reduceColumn(_matrix.chains[column], _matrix, 0);
+            _matrix.updateChainState(column, pivot < 0);
+
+            if (pivot >= 0) {
+                pivots[pivot].store(column, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+void ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::reduceInChunks(Matrix &_matrix, ThreadPool &_pool) {
+    const int size = _matrix.getColumnCount();
+    std::vector<std::size_t> weights(size);
+
+    for (int column = 0 ; column < size ; column++) {
+        weights[column] = _matrix.chains[column].size() + 1;
+    }
+
+    const std::vector<std::size_t> boundaries = ThreadPool::balancedChunks(weights, 4 * _pool.size());
+    std::vector<char> cleared(size, false);
+    std::vector<char> deaths(size, false);
+
+    for (const PersistencePair &pair : apparentPairs) {
+        cleared[pair.birth] = true;
+        deaths[pair.death] = true;
+    }
+
+    // Local phase, a chunk only reads and claims the pivots of its own rows
+    _pool.run(boundaries.size() - 1, [&](const std::size_t _chunk, const std::size_t _worker) {
+        const ScopedTrace<_Instrumentation> trace("reduction.local");
+        const int first = boundaries[_chunk];
+        const int last = boundaries[_chunk + 1];
+
+        for (int column : columnsByDimension(first, last, false)) {
+            if (cleared[column] || resolved[column]) {
+                continue;
+            }
+
+            const int pivot = reduceColumn(_matrix.chains[column], _matrix, _worker, first);
+
+            if (pivot >= first) {
+                pivots[pivot].store(column, std::memory_order_relaxed);
+                deaths[column] = true;
+
+                _matrix.chains[pivot] = typename Matrix::MatrixChain(size);
+                cleared[pivot] = true;
+            }
+        }
+    });
+
+    // Compression phase, the rows of the local deaths can never be pivots, they are removed from every column
+    // the global phase may read so that the reduced columns never bring them back
+    std::vector<int> compressedColumns;
+    for (int column = 0 ; column < size ; column++) {
+        if (!cleared[column] && _matrix.chains[column].size() != 0) {
+            compressedColumns.push_back(column);
+        }
+    }
+
+    weights.resize(compressedColumns.size());
+    for (std::size_t item = 0 ; item < compressedColumns.size() ; item++) {
+        weights[item] = _matrix.chains[compressedColumns[item]].size();
+    }
+
+    {
+        const ScopedTrace<_Instrumentation> trace("reduction.compression");
+
+        ThreadPool::forEachWeighted(&_pool, weights, [&](const std::size_t _item, const std::size_t) {
+            compressColumn(_matrix.chains[compressedColumns[_item]], deaths);
+        });
+    }
+
+    // Global phase, by decreasing dimension with clearing, on the calling thread which is the worker 0
+    const ScopedTrace<_Instrumentation> trace("reduction.global");
+
+    for (int column : columnsByDimension(0, size, false)) {
+        if (deaths[column] || cleared[column] || _matrix.chains[column].size() == 0) {
+            continue;
+        }
+
+        const int pivot = reduceColumn(_matrix.chains[column], _matrix, 0);
+
+        if (pivot >= 0) {
+            pivots[pivot].store(column, std::memory_order_relaxed);
+
+            _matrix.chains[pivot] = typename Matrix::MatrixChain(size);
+            cleared[pivot] = true;
+        }
+    }
+
+    _matrix.rebuildChainStates();
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+template <typename _Columns>
+int ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::reduceColumn(typename Matrix::MatrixChain &_column, const _Columns &_columns, const std::size_t _worker, const int _lowestPivot) {
+    const int pivot = _column.lastIndex();
+
+    // A column without reducer is left as is, converting it would be wasted
+    if (!lazyAccumulation || pivot < _lowestPivot || pivots[pivot].load(std::memory_order_relaxed) < 0) {
+        return addReducers(_column, _columns, _worker, _lowestPivot);
+    }
+
+    LazyChain<_CoefficientType, COLUMN, _StorageType> lazyColumn(_column);
+    const std::size_t size = _column.size();
+    const int reducedPivot = addReducers(lazyColumn, _columns, _worker, _lowestPivot);
+
+    _column = lazyColumn.toChain();
+
+    if constexpr (_Instrumentation::ENABLED) {
+        ReductionCounters &counters = statistics.workers[_worker];
+
+        if (_column.size() > size) {
+            counters.fillIn += _column.size() - size;
+        } else {
+            counters.cancellations += size - _column.size();
+        }
+    }
+
+    return reducedPivot;
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+template <typename _Column, typename _Columns>
+int ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::addReducers(_Column &_column, const _Columns &_columns, const std::size_t _worker, const int _lowestPivot) {
+    constexpr bool lazy = !std::is_same<_Column, typename Matrix::MatrixChain>::value;
+    const int initialPivot = _column.lastIndex();
+    int pivot = initialPivot;
+
+    while (pivot >= _lowestPivot) {
+        const int reducer = pivots[pivot].load(std::memory_order_relaxed);
+
+        if (reducer < 0) {
+            break;
+        }
+
+        const ChainView<_CoefficientType, COLUMN, _StorageType> reducerColumn = _columns[reducer];
+        _CoefficientType coefficient;
+        if constexpr (lazy) {
+            coefficient = _column.lastCoefficient();
+        } else {
+            coefficient = static_cast<const _Column&>(_column)[pivot];
+        }
+        const _CoefficientType factor = exactQuotient(coefficient, reducerColumn[pivot]);
+
+        if constexpr (_Instrumentation::ENABLED && !lazy) {
+            ReductionCounters &counters = statistics.workers[_worker];
+            const std::size_t size = _column.size();
+            const std::size_t capacity = _column.capacity();
+
+            _column.addScaled(-factor, reducerColumn);
+
+            counters.chainAdditions++;
+            if (_column.size() > size) {
+                counters.fillIn += _column.size() - size;
+            } else {
+                counters.cancellations += size - _column.size();
+            }
+            if (_column.capacity() != capacity) {
+                counters.reallocations++;
+            }
+        } else {
+            _column.addScaled(-factor, reducerColumn);
+
+            if constexpr (_Instrumentation::ENABLED) {
+                statistics.workers[_worker].chainAdditions++;
+            }
+        }
+
+        pivot = _column.lastIndex();
+    }
+    // Each addition lowers the pivot, a column keeping its initial pivot was paired without any
+    if constexpr (_Instrumentation::ENABLED) {
+        if (pivot >= _lowestPivot && pivot == initialPivot) {
+            statistics.workers[_worker].emergentPairs++;
+        }
+    }
+
+    return pivot;
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+void ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::compressColumn(typename Matrix::MatrixChain &_column, const std::vector<char> &_deaths) {
+    bool compressible = false;
+    for (typename Matrix::MatrixChain::const_iterator it = _column.cbegin() ; it != _column.cend() && !compressible ; ++it) {
+        compressible = _deaths[it->first];
+    }
+
+    if (!compressible) {
+        return;
+    }
+
+    typename Matrix::MatrixChain compressed(_column.getUpperBound());
+    for (typename Matrix::MatrixChain::const_iterator it = _column.cbegin() ; it != _column.cend() ; ++it) {
+        if (!_deaths[it->first]) {
+            compressed[it->first] = it->second;
+        }
+    }
+
+    _column = std::move(compressed);
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _Instrumentation>
+std::vector<int> ColumnReduction<_CoefficientType, _StorageType, _Instrumentation>::columnsByDimension(const int _first, const int _last, const bool _increasing) const {
+    std::vector<int> order(_last - _first);
+
+    if (dimensions.empty()) {
+        for (int column = _first ; column < _last ; column++) {
+            order[column - _first] = column;
+        }
+        return order;
+    }
+
+    int maximalDimension = 0;
+    for (int column = _first ; column < _last ; column++) {
+        maximalDimension = std::max(maximalDimension, dimensions[column]);
+    }
+
+    std::vector<std::size_t> offsets(maximalDimension + 2, 0);
+    for (int column = _first ; column < _last ; column++) {
+        offsets[(_increasing ? dimensions[column] : maximalDimension - dimensions[column]) + 1]++;
+    }
+    for (std::size_t bucket = 1 ; bucket < offsets.size() ; bucket++) {
+        offsets[bucket] += offsets[bucket - 1];
+    }
+
+    for (int column = _first ; column < _last ; column++) {
+        order[offsets[_increasing ? dimensions[column] : maximalDimension - dimensions[column]]++] = column;
+    }
+
+    return order;
+}
+
+}
+
+#endif
@@ -0,0 +1,518 @@
+/**
+ * \file Reordering.hpp
+ * \brief Fill-reducing orderings of rows and columns.
+ *
+ * Define everything for the Reordering class
+ */
+
+#ifndef __OSM_REORDERING__
+#define __OSM_REORDERING__
+
+
+#include "__base.hpp"
+#include "Permutation.hpp"
+#include "SparseMatrix.hpp"
+#include "Reduction.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class Reordering
+ * \brief Heuristic orderings of the indexes of a matrix reducing the fill-in of eliminations.
+ *
+ * Each ordering is returned as an OSM::Permutation, applied in a single pass by OSM::SparseMatrix::permuted and
+ * kept to translate the results back to the original indexes.
+ *
+ * - reverseCuthillMcKee reduces the bandwidth of the symmetric pattern, keeping each elimination local.
+ * - approximateMinimumDegree eliminates first the indexes of the least approximate degree in the quotient graph.
+ * - filtration reorders a boundary matrix inside the ties of its filtration, faces still coming before cofaces.
+ *
+ * The first two are symmetric orderings of square matrices which ignore any filtration: use them for eliminations
+ * whose result does not depend on the order, like the Smith normal form, not for persistence.
+ *
+ * \see \link OSM::Permutation \endlink
+ */
+class Reordering {
+
+private:
+    /** \brief Adjacency lists of the symmetric pattern of a square matrix, without its diagonal. */
+    struct Graph {
+        /** \brief The first neighbour of each node, followed by the end of the last list. */
+        std::vector<std::size_t> offsets;
+
+        /** \brief The sorted neighbours of every node. */
+        std::vector<int> neighbours;
+
+        /** \brief Number of nodes. */
+        int size() const noexcept { return offsets.size() - 1; }
+
+        /** \brief Number of neighbours of a node. */
+        int degree(const int _node) const noexcept { return offsets[_node + 1] - offsets[_node]; }
+    };
+
+public:
+    /**
+     * \brief Reverse Cuthill-McKee ordering of the symmetric pattern of a square matrix.
+     *
+     * Each connected component is visited breadth first from a pseudo-peripheral index, the neighbours by increasing
+     * degree, and the visit order is reversed. Apply it to both rows and columns.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     *
+     * \param[in] _matrix The matrix, its pattern is symmetrized.
+     *
+     * \return The permutation giving the new index of each index.
+     */
+    template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+    static Permutation reverseCuthillMcKee(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix);
+
+    /**
+     * \brief Approximate minimum degree ordering of the symmetric pattern of a square matrix.
+     *
+     * The elimination is simulated on the quotient graph, each eliminated index becoming an element whose members
+     * are its neighbours. The next eliminated index has the least approximate external degree, the bound of Amestoy,
+     * Davis and Duff, and the elements it covers are absorbed. Supervariables are not detected, each index is
+     * eliminated on its own. Apply it to both rows and columns.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     *
+     * \param[in] _matrix The matrix, its pattern is symmetrized.
+     *
+     * \return The permutation giving the new index of each index, its elimination rank.
+     */
+    template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+    static Permutation approximateMinimumDegree(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix);
+
+    /**
+     * \brief Filtration respecting ordering of a boundary matrix.
+     *
+     * The columns are ordered by filtration value, then by dimension, and the columns tied on both by their youngest
+     * face in the new order, the order of lexicographic filtrations: tied columns get increasing pivots, which
+     * shortens their reduction. Apply it to both rows and columns, the permuted matrix is still a filtered boundary
+     * matrix with the same persistence up to the ties.
+     *
+     * \warning Will raise an error if the matrix is not square.
+     * \warning Will raise an error if the values or the dimensions are not as many as the columns.
+     * \warning Will raise an error if a face does not come before its coface with these values and dimensions.
+     *
+     * \param[in] _boundary The boundary matrix.
+     * \param[in] _values The filtration value of each column.
+     * \param[in] _dimensions The dimension of each column.
+     *
+     * \return The permutation giving the new index of each column.
+     */
+    template <typename _CoefficientType, typename _StorageType, typename _ValueType>
+    static Permutation filtration(const SparseMatrix<_CoefficientType, COLUMN, _StorageType> &_boundary, const std::vector<_ValueType> &_values, const std::vector<int> &_dimensions);
+
+    /**
+     * \brief Translates the persistence diagram of a permuted boundary matrix back to the original indexes.
+     *
+     * \param[in] _diagram The diagram of the permuted matrix.
+     * \param[in] _permutation The permutation applied to the rows and columns.
+     *
+     * \return The diagram with original indexes, pairs by increasing birth.
+     */
+    static PersistenceDiagram restore(const PersistenceDiagram &_diagram, const Permutation &_permutation);
+
+private:
+    /**
+     * \brief Builds the adjacency lists of the pattern of a matrix plus its transpose.
+     *
+     * \param[in] _matrix The square matrix.
+     *
+     * \return The graph.
+     */
+    template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+    static Graph symmetricGraph(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix);
+
+    /**
+     * \brief Visits the component of a node breadth first.
+     *
+     * \param[in] _graph The graph.
+     * \param[in] _root The first visited node.
+     * \param[in,out] _stamps The visit stamp of each node, the visited nodes get _stamp.
+     * \param[in] _stamp The stamp of this visit.
+     * \param[out] _lastLevel The nodes at the greatest distance from the root.
+     *
+     * \return The eccentricity of the root.
+     */
+    static int breadthFirstLevels(const Graph &_graph, const int _root, std::vector<int> &_stamps, const int _stamp, std::vector<int> &_lastLevel);
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Reordering::Graph Reordering::symmetricGraph(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix) {
+    if constexpr (_ChainTypeFlag == (COLUMN | ROW)) {
+        return symmetricGraph(_matrix.getColumnMatrix());
+    } else {
+        if (_matrix.getRowCount() != _matrix.getColumnCount()) {
+            throw std::invalid_argument("A symmetric ordering needs a square matrix.");
+        }
+
+        const int size = _matrix.getColumnCount();
+        Graph graph;
+        graph.offsets.assign(size + 1, 0);
+
+        // Both orientations of each off-diagonal entry, counted then placed
+        _matrix.forEachNonEmpty([&](const int _index, const auto &_chain) {
+            for (auto it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+                if (it->first != _index) {
+                    graph.offsets[_index + 1]++;
+                    graph.offsets[it->first + 1]++;
+                }
+            }
+        });
+
+        for (int node = 0 ; node < size ; node++) {
+            graph.offsets[node + 1] += graph.offsets[node];
+        }
+
+        std::vector<std::size_t> positions(graph.offsets.begin(), graph.offsets.end() - 1);
+        graph.neighbours.resize(graph.offsets[size]);
+
+        _matrix.forEachNonEmpty([&](const int _index, const auto &_chain) {
+            for (auto it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+                if (it->first != _index) {
+                    graph.neighbours[positions[_index]++] = it->first;
+                    graph.neighbours[positions[it->first]++] = _index;
+                }
+            }
+        });
+
+        // Symmetric entries gave each edge twice, the lists are sorted and compacted
+        std::size_t write = 0;
+        for (int node = 0 ; node < size ; node++) {
+            const std::size_t first = graph.offsets[node];
+            const std::size_t last = graph.offsets[node + 1];
+
+            std::sort(graph.neighbours.begin() + first, graph.neighbours.begin() + last);
+            graph.offsets[node] = write;
+
+            for (std::size_t read = first ; read < last ; read++) {
+                if (read == first || graph.neighbours[read] != graph.neighbours[read - 1]) {
+                    graph.neighbours[write++] = graph.neighbours[read];
+                }
+            }
+        }
+        graph.offsets[size] = write;
+        graph.neighbours.resize(write);
+
+        return graph;
+    }
+}
+
+inline int Reordering::breadthFirstLevels(const Graph &_graph, const int _root, std::vector<int> &_stamps, const int _stamp, std::vector<int> &_lastLevel) {
+    std::vector<int> level(1, _root);
+    std::vector<int> nextLevel;
+    int eccentricity = 0;
+
+    _stamps[_root] = _stamp;
+
+    while (true) {
+        nextLevel.clear();
+
+        for (int node : level) {
+            for (std::size_t neighbour = _graph.offsets[node] ; neighbour < _graph.offsets[node + 1] ; neighbour++) {
+                const int next = _graph.neighbours[neighbour];
+
+                if (_stamps[next] != _stamp) {
+                    _stamps[next] = _stamp;
+                    nextLevel.push_back(next);
+                }
+            }
+        }
+
+        if (nextLevel.empty()) {
+            _lastLevel = level;
+            return eccentricity;
+        }
+
+        level.swap(nextLevel);
+        eccentricity++;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Permutation Reordering::reverseCuthillMcKee(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix) {
+    const Graph graph = symmetricGraph(_matrix);
+    const int size = graph.size();
+
+    std::vector<int> order;
+    order.reserve(size);
+    std::vector<char> visited(size, false);
+    std::vector<int> stamps(size, -1);
+    std::vector<int> lastLevel;
+    std::vector<int> neighbours;
+    int stamp = 0;
+
+    const auto lowestDegree = [&graph](const int _first, const int _second) {
+        return graph.degree(_first) < graph.degree(_second) || (graph.degree(_first) == graph.degree(_second) && _first < _second);
+    };
+
+    for (int start = 0 ; start < size ; start++) {
+        if (visited[start]) {
+            continue;
+        }
+
+        // Pseudo-peripheral root of George and Liu, moving to the lowest degree node of the last level while the
+        // eccentricity grows
+        int root = start;
+        int eccentricity = breadthFirstLevels(graph, root, stamps, stamp++, lastLevel);
+
+        while (true) {
+            const int candidate = *std::min_element(lastLevel.begin(), lastLevel.end(), lowestDegree);
+            const int candidateEccentricity = breadthFirstLevels(graph, candidate, stamps, stamp++, lastLevel);
+
+            if (candidateEccentricity <= eccentricity) {
+                break;
+            }
+
+            root = candidate;
+            eccentricity = candidateEccentricity;
+        }
+
+        // Cuthill-McKee visit, the order doubles as the queue
+        std::size_t head = order.size();
+        order.push_back(root);
+        visited[root] = true;
+
+        while (head < order.size()) {
+            const int node = order[head++];
+
+            neighbours.clear();
+            for (std::size_t neighbour = graph.offsets[node] ; neighbour < graph.offsets[node + 1] ; neighbour++) {
+                const int next = graph.neighbours[neighbour];
+
+                if (!visited[next]) {
+                    visited[next] = true;
+                    neighbours.push_back(next);
+                }
+            }
+
+            std::sort(neighbours.begin(), neighbours.end(), lowestDegree);
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+
+    return Permutation::fromOrder(order);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+Permutation Reordering::approximateMinimumDegree(const SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> &_matrix) {
+    const Graph graph = symmetricGraph(_matrix);
+    const int size = graph.size();
+
+    // Quotient graph: the variables adjacent to each variable, the elements adjacent to each variable, and the
+    // members of each element. An element member is never eliminated, since eliminating it absorbs the element.
+    std::vector<std::vector<int>> variables(size);
+    std::vector<std::vector<int>> elements(size);
+    std::vector<std::vector<int>> members(size);
+    std::vector<char> eliminated(size, false);
+    std::vector<char> absorbed(size, false);
+    std::vector<int> degrees(size);
+
+    std::vector<int> marks(size, -1);
+    std::vector<int> weights(size, 0);
+    std::vector<int> weightMarks(size, -1);
+
+    typedef std::pair<int, int> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+    for (int node = 0 ; node < size ; node++) {
+        variables[node].assign(graph.neighbours.begin() + graph.offsets[node], graph.neighbours.begin() + graph.offsets[node + 1]);
+        degrees[node] = variables[node].size();
+        candidates.emplace(degrees[node], node);
+    }
+
+    std::vector<int> order;
+    order.reserve(size);
+
+    for (int step = 0 ; step < size ; step++) {
+        // Outdated candidates are skipped, each degree update pushes a new one
+        int pivot = candidates.top().second;
+        while (eliminated[pivot] || candidates.top().first != degrees[pivot]) {
+            candidates.pop();
+            pivot = candidates.top().second;
+        }
+        candidates.pop();
+        order.push_back(pivot);
+
+        // The new element gathers the variables adjacent to the pivot and the members of its elements, absorbed
+        std::vector<int> element;
+        marks[pivot] = step;
+
+        for (int variable : variables[pivot]) {
+            if (!eliminated[variable] && marks[variable] != step) {
+                marks[variable] = step;
+                element.push_back(variable);
+            }
+        }
+        for (int absorbedElement : elements[pivot]) {
+            if (absorbed[absorbedElement]) {
+                continue;
+            }
+
+            for (int variable : members[absorbedElement]) {
+                if (marks[variable] != step) {
+                    marks[variable] = step;
+                    element.push_back(variable);
+                }
+            }
+
+            absorbed[absorbedElement] = true;
+            std::vector<int>().swap(members[absorbedElement]);
+        }
+
+        eliminated[pivot] = true;
+        std::vector<int>().swap(variables[pivot]);
+        std::vector<int>().swap(elements[pivot]);
+
+        // The weight of each other element adjacent to the new one is the number of its members out of it
+        for (int variable : element) {
+            for (int other : elements[variable]) {
+                if (absorbed[other]) {
+                    continue;
+                }
+
+                if (weightMarks[other] != step) {
+                    weightMarks[other] = step;
+                    weights[other] = members[other].size();
+                }
+                weights[other]--;
+            }
+        }
+
+        const int elementSize = element.size();
+
+        for (int variable : element) {
+            int externalDegree = 0;
+
+            // Elements covered by the new one are absorbed, the others add their members out of it
+            std::vector<int> &variableElements = elements[variable];
+            std::size_t write = 0;
+            for (int other : variableElements) {
+                if (absorbed[other]) {
+                    continue;
+                }
+                if (weights[other] == 0) {
+                    absorbed[other] = true;
+                    std::vector<int>().swap(members[other]);
+                    continue;
+                }
+
+                externalDegree += weights[other];
+                variableElements[write++] = other;
+            }
+            variableElements.resize(write);
+            variableElements.push_back(pivot);
+
+            // The variables of the new element are reached through it
+            std::vector<int> &variableVariables = variables[variable];
+            write = 0;
+            for (int other : variableVariables) {
+                if (!eliminated[other] && marks[other] != step) {
+                    variableVariables[write++] = other;
+                }
+            }
+            variableVariables.resize(write);
+
+            const int bound = static_cast<int>(variableVariables.size()) + elementSize - 1 + externalDegree;
+            degrees[variable] = std::min({size - step - 2, degrees[variable] + elementSize - 1, bound});
+            candidates.emplace(degrees[variable], variable);
+        }
+
+        members[pivot] = std::move(element);
+    }
+
+    return Permutation::fromOrder(order);
+}
+
+template <typename _CoefficientType, typename _StorageType, typename _ValueType>
+Permutation Reordering::filtration(const SparseMatrix<_CoefficientType, COLUMN, _StorageType> &_boundary, const std::vector<_ValueType> &_values, const std::vector<int> &_dimensions) {
+    const int size = _boundary.getColumnCount();
+
+    if (_boundary.getRowCount() != size) {
+        throw std::invalid_argument("A boundary matrix must be square.");
+    }
+
+    if (static_cast<int>(_values.size()) != size || static_cast<int>(_dimensions.size()) != size) {
+        throw std::invalid_argument("The filtration needs the value and the dimension of each column.");
+    }
+
+    std::vector<int> order(size);
+    for (int column = 0 ; column < size ; column++) {
+        order[column] = column;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](const int _first, const int _second) {
+        return _values[_first] < _values[_second] || (!(_values[_second] < _values[_first]) && _dimensions[_first] < _dimensions[_second]);
+    });
+
+    // The ties are placed in order, their faces already have their new index
+    std::vector<int> images(size, -1);
+    std::vector<std::pair<int, int>> ties;
+
+    for (int first = 0 ; first < size ; ) {
+        int last = first + 1;
+        while (last < size && !(_values[order[first]] < _values[order[last]]) && _dimensions[order[first]] == _dimensions[order[last]]) {
+            last++;
+        }
+
+        ties.clear();
+        for (int position = first ; position < last ; position++) {
+            const int column = order[position];
+            const ChainView<_CoefficientType, COLUMN, _StorageType> faces = _boundary[column];
+            int youngestFace = -1;
+
+            for (auto it = faces.cbegin() ; it != faces.cend() ; ++it) {
+                if (images[it->first] < 0) {
+                    throw std::invalid_argument("A face must come before its cofaces in the filtration.");
+                }
+
+                youngestFace = std::max(youngestFace, images[it->first]);
+            }
+
+            ties.emplace_back(youngestFace, column);
+        }
+
+        std::sort(ties.begin(), ties.end());
+        for (const std::pair<int, int> &tie : ties) {
+            images[tie.second] = first++;
+        }
+    }
+
+    return Permutation::fromImages(images);
+}
+
+inline PersistenceDiagram Reordering::restore(const PersistenceDiagram &_diagram, const Permutation &_permutation) {
+    PersistenceDiagram result;
+    result.pairs.reserve(_diagram.pairs.size());
+    result.essentials.reserve(_diagram.essentials.size());
+
+    for (const PersistencePair &pair : _diagram.pairs) {
+        result.pairs.push_back(PersistencePair{_permutation.preimage(pair.birth), _permutation.preimage(pair.death)});
+    }
+    for (int essential : _diagram.essentials) {
+        result.essentials.push_back(_permutation.preimage(essential));
+    }
+
+    std::sort(result.pairs.begin(), result.pairs.end(), [](const PersistencePair &_first, const PersistencePair &_second) {
+        return _first.birth < _second.birth;
+    });
+    std::sort(result.essentials.begin(), result.essentials.end());
+
+    return result;
+}
+
+}
+
+#endif
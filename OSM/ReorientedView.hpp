@@ -0,0 +1,175 @@
+/**
+ * \file ReorientedView.hpp
+ * \brief Lazy view of a matrix with the other chain type.
+ *
+ * Define everything for the ReorientedView class
+ */
+
+#ifndef __OSM_REORIENTED_VIEW__
+#define __OSM_REORIENTED_VIEW__
+
+
+#include "SparseMatrix.hpp"
+#include <cstddef>
+#include <stdexcept>
+#include <stdint.h>
+
+
+namespace OSM {
+
+/**
+ * \class ReorientedView
+ * \brief Lazy view of a sparse matrix with the other chain type.
+ *
+ * A column-based matrix is read as a row-based one, and conversely, without reorienting it up front. Each chain of
+ * the view is gathered on demand from the chains of the matrix, until the gathering work exceeds the number of
+ * entries of the matrix: the view then switches to the cached reorientation of the matrix, so a view queried chain
+ * by chain never costs more than twice a full reorientation.
+ *
+ * \warning The view is invalidated as soon as the viewed matrix is modified or destroyed.
+ * \warning While the matrix hands out chain references, the view keeps gathering its chains, since the cached
+ * reorientation would be computed again at each read.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _ChainTypeFlag The chain type of the viewed matrix (default is OSM::COLUMN)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::SparseMatrix::getReoriented \endlink
+ */
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+class ReorientedView {
+
+    static_assert(_ChainTypeFlag == COLUMN || _ChainTypeFlag == ROW, "Only single chain type matrices can be reoriented.");
+
+public:
+    typedef SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> Matrix;
+    typedef SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> ReorientedMatrix;
+    typedef Chain<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> ViewChain;
+
+private:
+    /** \brief The viewed matrix. */
+    const Matrix *matrix;
+
+    /** \brief The number of entries of the viewed matrix. */
+    std::size_t entryCount;
+
+    /** \brief The number of chain lookups spent gathering chains of the view. */
+    mutable std::size_t gatheringWork;
+
+public:
+    /**
+     * \brief Create new ReorientedView object.
+     *
+     * Views the given matrix, nothing is copied.
+     *
+     * \param[in] _matrix The viewed matrix.
+     */
+    ReorientedView(const Matrix &_matrix);
+
+    /**
+     * \brief Get a chain of the view.
+     *
+     * Copied from the cached reorientation if there is one, gathered from the matrix chains otherwise.
+     *
+     * \warning Will raise an error if the index is out of the view.
+     *
+     * \param[in] _index The chain index, a row index for a viewed column-based matrix.
+     *
+     * \return The chain, with the other chain type.
+     *
+     * \throws std::out_of_range If the index is out of the view.
+     */
+    ViewChain operator[](const int _index) const;
+
+    /**
+     * \brief Get the reoriented matrix, cached by the viewed matrix.
+     *
+     * \return The reoriented matrix.
+     *
+     * \see \link OSM::SparseMatrix::getReoriented \endlink
+     */
+    inline const ReorientedMatrix& materialize() const;
+
+    /** \brief Whether the chains of the view are read from the cached reorientation. */
+    inline bool isMaterialized() const noexcept;
+
+    /** \brief Get the number of chains of the view. */
+    inline int size() const noexcept;
+
+    /** \brief Get the number of rows of the viewed matrix. */
+    inline int getRowCount() const noexcept;
+
+    /** \brief Get the number of columns of the viewed matrix. */
+    inline int getColumnCount() const noexcept;
+};
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::ReorientedView(const Matrix &_matrix) :
+    matrix(&_matrix),
+    entryCount(0),
+    gatheringWork(0) {
+    _matrix.synchronizeChainStates();
+
+    for (int index : _matrix.nonEmptyChainsIndexes) {
+        entryCount += _matrix.chains[index].size();
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::ViewChain ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    if (_index < 0 || _index >= size()) {
+        throw std::out_of_range("Chain index out of matrix bounds.");
+    }
+
+    if (matrix->isReorientedCached() || (gatheringWork > entryCount && !matrix->chainsExposed)) {
+        return matrix->getReoriented().chains[_index];
+    }
+
+    matrix->synchronizeChainStates();
+
+    ViewChain chain(matrix->chains.size());
+    gatheringWork += matrix->nonEmptyChainsIndexes.size();
+
+    // The matrix chains are visited by increasing index, so the gathered chain is filled in order.
+    for (std::size_t word = 0 ; word < matrix->chainsStates.size() ; word++) {
+        for (uint64_t bits = matrix->chainsStates[word] ; bits != 0 ; bits &= bits - 1) {
+            const int index = word * 64 + countTrailingZeros(bits);
+            const _CoefficientType coefficient = matrix->chains[index].chainData.get(_index);
+
+            if (coefficient != _CoefficientType(0)) {
+                chain.chainData.append(index, coefficient);
+            }
+        }
+    }
+
+    return chain;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline const typename ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::ReorientedMatrix& ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::materialize() const {
+    return matrix->getReoriented();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline bool ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::isMaterialized() const noexcept {
+    return matrix->isReorientedCached();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::size() const noexcept {
+    return _ChainTypeFlag == COLUMN ? matrix->getRowCount() : matrix->getColumnCount();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::getRowCount() const noexcept {
+    return matrix->getRowCount();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int ReorientedView<_CoefficientType, _ChainTypeFlag, _StorageType>::getColumnCount() const noexcept {
+    return matrix->getColumnCount();
+}
+
+}
+
+#endif
@@ -0,0 +1,372 @@
+/**
+ * \file SmallVector.hpp
+ * \brief Vector with an inline buffer for short sequences.
+ *
+ * Define everything for the SmallVector class
+ */
+
+#ifndef __OSM_SMALL_VECTOR__
+#define __OSM_SMALL_VECTOR__
+
+
+#include "__base.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+
+
+namespace OSM {
+
+/**
+ * \class SmallVector
+ * \brief Contiguous array storing its first elements inside the object.
+ *
+ * Up to _InlineCapacity elements are stored in an inline buffer, the elements only move to the heap when it overflows.
+ * The inline buffer shares its memory with the heap pointer, so a SmallVector is not bigger than a std::vector
+ * as long as the inline buffer is not bigger than two pointers.
+ *
+ * \pre The element type is trivially copyable.
+ *
+ * \tparam _Type The type of the stored elements.
+ * \tparam _InlineCapacity The number of elements stored inline.
+ * \tparam _Allocator The stateless allocator of the heap buffer (default is std::allocator)
+ */
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator = std::allocator<_Type>>
+class SmallVector {
+
+    static_assert(std::is_trivially_copyable<_Type>::value, "SmallVector can only store trivially copyable types.");
+    static_assert(_InlineCapacity > 0, "SmallVector needs a non zero inline capacity, use std::vector instead.");
+    static_assert(std::allocator_traits<_Allocator>::is_always_equal::value, "SmallVector only supports stateless allocators.");
+
+public:
+    typedef _Type value_type;
+    typedef std::size_t size_type;
+    typedef _Type* iterator;
+    typedef const _Type* const_iterator;
+
+private:
+    /** \brief Inline buffer when the elements fit in it, heap pointer otherwise. */
+    union {
+        alignas(_Type) unsigned char inlineBuffer[_InlineCapacity * sizeof(_Type)];
+        _Type *heapData;
+    };
+
+    /** \brief The number of stored elements. */
+    uint32_t count;
+
+    /** \brief The number of elements that fit in the current buffer. */
+    uint32_t bufferCapacity;
+
+public:
+    /**
+     * \brief Create new SmallVector object.
+     *
+     * Default constructor, initialize an empty vector using the inline buffer.
+     */
+    SmallVector() noexcept : count(0), bufferCapacity(_InlineCapacity) {}
+
+    /**
+     * \brief Create new SmallVector object.
+     *
+     * Copy constructor, only allocates if the copied elements do not fit inline.
+     *
+     * \param[in] _otherToCopy The vector we want to copy.
+     */
+    SmallVector(const SmallVector &_otherToCopy);
+
+    /**
+     * \brief Create new SmallVector object.
+     *
+     * Move constructor, steals the heap buffer if any.
+     *
+     * \param[in] _otherToMove The vector we want to move.
+     */
+    SmallVector(SmallVector &&_otherToMove) noexcept;
+
+    /**
+     * \brief Assign to other vector.
+     *
+     * \param[in] _otherToCopy The vector we want to copy.
+     *
+     * \return The reference to the modified vector.
+     */
+    SmallVector& operator=(const SmallVector &_otherToCopy);
+
+    /**
+     * \brief Move assign to other vector.
+     *
+     * \param[in] _otherToMove The vector we want to move.
+     *
+     * \return The reference to the modified vector.
+     */
+    SmallVector& operator=(SmallVector &&_otherToMove) noexcept;
+
+    /** \brief Releases the heap buffer if any. */
+    ~SmallVector();
+
+    /** \brief Number of stored elements. */
+    size_type size() const noexcept { return count; }
+
+    /** \brief Checks if no element is stored. */
+    bool empty() const noexcept { return count == 0; }
+
+    /** \brief Number of elements that fit without reallocation. */
+    size_type capacity() const noexcept { return bufferCapacity; }
+
+    /** \brief Checks if the elements are stored in the inline buffer. */
+    bool isInline() const noexcept { return bufferCapacity <= _InlineCapacity; }
+
+    /** \brief Raw pointer to the elements. */
+    _Type* data() noexcept { return isInline() ? reinterpret_cast<_Type*>(inlineBuffer) : heapData; }
+
+    /** \brief Raw pointer to the elements. */
+    const _Type* data() const noexcept { return isInline() ? reinterpret_cast<const _Type*>(inlineBuffer) : heapData; }
+
+    iterator begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    iterator end() noexcept { return data() + count; }
+    const_iterator end() const noexcept { return data() + count; }
+
+    _Type& operator[](const size_type _index) noexcept { return data()[_index]; }
+    const _Type& operator[](const size_type _index) const noexcept { return data()[_index]; }
+
+    /** \brief The last element, the vector must not be empty. */
+    _Type& back() noexcept { return data()[count - 1]; }
+
+    /** \brief The last element, the vector must not be empty. */
+    const _Type& back() const noexcept { return data()[count - 1]; }
+
+    /** \brief Removes all elements, keeps the buffer. */
+    void clear() noexcept { count = 0; }
+
+    /**
+     * \brief Grows the buffer to hold at least _capacity elements.
+     *
+     * \param[in] _capacity The number of elements to preallocate.
+     */
+    void reserve(const size_type _capacity);
+
+    /**
+     * \brief Changes the number of stored elements.
+     *
+     * New elements are value initialized.
+     *
+     * \param[in] _size The new number of elements.
+     */
+    void resize(const size_type _size);
+
+    /**
+     * \brief Inserts an element before the given position.
+     *
+     * \param[in] _position The position of insertion.
+     * \param[in] _value The inserted element.
+     *
+     * \return The iterator to the inserted element.
+     */
+    iterator insert(const_iterator _position, const _Type &_value);
+
+    /**
+     * \brief Removes the element at the given position.
+     *
+     * \param[in] _position The position of the removed element.
+     *
+     * \return The iterator following the removed element.
+     */
+    iterator erase(const_iterator _position);
+
+    /**
+     * \brief Removes the elements in the given range.
+     *
+     * \param[in] _first The first removed element.
+     * \param[in] _last The element following the last removed element.
+     *
+     * \return The iterator following the removed elements.
+     */
+    iterator erase(const_iterator _first, const_iterator _last);
+
+    /** \brief Appends an element. */
+    void push_back(const _Type &_value);
+
+    /**
+     * \brief Reduces the buffer to the number of elements, moving them back inline if they fit.
+     */
+    void shrinkToFit();
+
+private:
+    /**
+     * \brief Moves the elements to a buffer of the given capacity.
+     *
+     * \param[in] _capacity The new buffer capacity, must be at least the number of elements.
+     */
+    void reallocate(const size_type _capacity);
+};
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+SmallVector<_Type, _InlineCapacity, _Allocator>::SmallVector(const SmallVector &_otherToCopy) : count(0), bufferCapacity(_InlineCapacity) {
+    reserve(_otherToCopy.count);
+    std::memcpy(static_cast<void*>(data()), _otherToCopy.data(), _otherToCopy.count * sizeof(_Type));
+    count = _otherToCopy.count;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+SmallVector<_Type, _InlineCapacity, _Allocator>::SmallVector(SmallVector &&_otherToMove) noexcept :
+    count(_otherToMove.count),
+    bufferCapacity(_otherToMove.bufferCapacity) {
+    if (_otherToMove.isInline()) {
+        std::memcpy(inlineBuffer, _otherToMove.inlineBuffer, count * sizeof(_Type));
+    } else {
+        heapData = _otherToMove.heapData;
+    }
+
+    _otherToMove.count = 0;
+    _otherToMove.bufferCapacity = _InlineCapacity;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+SmallVector<_Type, _InlineCapacity, _Allocator>& SmallVector<_Type, _InlineCapacity, _Allocator>::operator=(const SmallVector &_otherToCopy) {
+    if (&_otherToCopy == this) {
+        return *this;
+    }
+
+    count = 0;
+    reserve(_otherToCopy.count);
+    std::memcpy(static_cast<void*>(data()), _otherToCopy.data(), _otherToCopy.count * sizeof(_Type));
+    count = _otherToCopy.count;
+
+    return *this;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+SmallVector<_Type, _InlineCapacity, _Allocator>& SmallVector<_Type, _InlineCapacity, _Allocator>::operator=(SmallVector &&_otherToMove) noexcept {
+    if (&_otherToMove == this) {
+        return *this;
+    }
+
+    if (!isInline()) {
+        _Allocator().deallocate(heapData, bufferCapacity);
+    }
+
+    count = _otherToMove.count;
+    bufferCapacity = _otherToMove.bufferCapacity;
+
+    if (_otherToMove.isInline()) {
+        std::memcpy(inlineBuffer, _otherToMove.inlineBuffer, count * sizeof(_Type));
+    } else {
+        heapData = _otherToMove.heapData;
+    }
+
+    _otherToMove.count = 0;
+    _otherToMove.bufferCapacity = _InlineCapacity;
+
+    return *this;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+SmallVector<_Type, _InlineCapacity, _Allocator>::~SmallVector() {
+    if (!isInline()) {
+        _Allocator().deallocate(heapData, bufferCapacity);
+    }
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+void SmallVector<_Type, _InlineCapacity, _Allocator>::reserve(const size_type _capacity) {
+    if (_capacity > bufferCapacity) {
+        reallocate(_capacity);
+    }
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+void SmallVector<_Type, _InlineCapacity, _Allocator>::resize(const size_type _size) {
+    if (_size > bufferCapacity) {
+        reallocate(std::max<size_type>(_size, 2 * bufferCapacity));
+    }
+
+    _Type *elements = data();
+    for (size_type index = count ; index < _size ; index++) {
+        new (elements + index) _Type();
+    }
+
+    count = _size;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+typename SmallVector<_Type, _InlineCapacity, _Allocator>::iterator SmallVector<_Type, _InlineCapacity, _Allocator>::insert(const_iterator _position, const _Type &_value) {
+    const size_type offset = _position - data();
+    const _Type value = _value;
+
+    if (count == bufferCapacity) {
+        reallocate(2 * bufferCapacity);
+    }
+
+    _Type *elements = data();
+    std::memmove(static_cast<void*>(elements + offset + 1), elements + offset, (count - offset) * sizeof(_Type));
+    elements[offset] = value;
+    count++;
+
+    return elements + offset;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+typename SmallVector<_Type, _InlineCapacity, _Allocator>::iterator SmallVector<_Type, _InlineCapacity, _Allocator>::erase(const_iterator _position) {
+    return erase(_position, _position + 1);
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+typename SmallVector<_Type, _InlineCapacity, _Allocator>::iterator SmallVector<_Type, _InlineCapacity, _Allocator>::erase(const_iterator _first, const_iterator _last) {
+    _Type *elements = data();
+    const size_type first = _first - elements;
+    const size_type last = _last - elements;
+
+    std::memmove(static_cast<void*>(elements + first), elements + last, (count - last) * sizeof(_Type));
+    count -= last - first;
+
+    return elements + first;
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+void SmallVector<_Type, _InlineCapacity, _Allocator>::push_back(const _Type &_value) {
+    insert(end(), _value);
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+void SmallVector<_Type, _InlineCapacity, _Allocator>::shrinkToFit() {
+    if (isInline() || count == bufferCapacity) {
+        return;
+    }
+
+    _Type *buffer = heapData;
+    const size_type capacity = bufferCapacity;
+
+    // The inline buffer shares its memory with the heap pointer, saved above.
+    if (count <= _InlineCapacity) {
+        std::memcpy(inlineBuffer, buffer, count * sizeof(_Type));
+        bufferCapacity = _InlineCapacity;
+    } else {
+        heapData = _Allocator().allocate(count);
+        std::memcpy(static_cast<void*>(heapData), buffer, count * sizeof(_Type));
+        bufferCapacity = count;
+    }
+
+    _Allocator().deallocate(buffer, capacity);
+}
+
+template <typename _Type, std::size_t _InlineCapacity, typename _Allocator>
+void SmallVector<_Type, _InlineCapacity, _Allocator>::reallocate(const size_type _capacity) {
+    _Type *buffer = _Allocator().allocate(_capacity);
+    std::memcpy(static_cast<void*>(buffer), data(), count * sizeof(_Type));
+
+    if (!isInline()) {
+        _Allocator().deallocate(heapData, bufferCapacity);
+    }
+
+    heapData = buffer;
+    bufferCapacity = _capacity;
+}
+
+}
+
+#endif
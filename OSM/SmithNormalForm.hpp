@@ -0,0 +1,811 @@
+/**
+ * \file SmithNormalForm.hpp
+ * \brief Smith normal form of integer matrices.
+ *
+ * Define everything for the SmithNormalForm class
+ */
+
+#ifndef __OSM_SMITH_NORMAL_FORM__
+#define __OSM_SMITH_NORMAL_FORM__
+
+
+#include "__base.hpp"
+#include "Storage.hpp"
+#include "Chain.hpp"
+#include "SparseMatrix.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class SmithNormalForm
+ * \brief Smith normal form of integer matrices, with coefficient growth control.
+ *
+ * Computes the invariant factors d1 | d2 | ... | dr of a column-based matrix over OSM::ZCoefficient, by unimodular
+ * row and column operations. Each pivot is the entry of smallest absolute value, ties broken by the Markowitz cost
+ * (row count - 1) * (column count - 1) estimating the fill-in. When the pivot does not divide an entry of its row or
+ * column, a gcd step replaces it by a strictly smaller one.
+ *
+ * The best entry of each column is kept in a priority queue, recomputed only for the columns a step changed, so the
+ * Markowitz cost of a candidate is the one of the last time its column changed. The columns having an entry in a row
+ * are kept in a row index, so a step only visits the columns meeting the rows it combines.
+ *
+ * An eliminated pivot leaves an empty row and an empty column, the column is swapped to the index of the row, so
+ * that batches of eliminated indexes are removed with OSM::SparseMatrix::operator/= and the matrix shrinks as the
+ * elimination goes.
+ *
+ * Chains are stored with OSM::ZCoefficient until an operation may overflow it, the chain is then widened to
+ * WideCoefficient, and narrowed back once its coefficients fit again.
+ *
+ * \warning Raises std::overflow_error if a coefficient overflows WideCoefficient. The coefficients are not reduced
+ * modulo a multiple of the determinant, so they may grow exponentially with the rank: random matrices with
+ * coefficients in [-5, 5] overflow from about 20 rows when half dense, and from a few dozen rows with only 3 or 4
+ * entries per column. Boundary matrices, with unit coefficients and few entries per column, stay far from the limit.
+ *
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ *
+ * \see \link OSM::SparseMatrix \endlink
+ */
+template <typename _StorageType>
+class SmithNormalForm {
+
+public:
+    /** \brief The reduced matrix type. */
+    typedef SparseMatrix<ZCoefficient, COLUMN, _StorageType> Matrix;
+
+    /** \brief The coefficient type of the widened chains. */
+    typedef long long WideCoefficient;
+
+    /** \brief The widened chain type. */
+    typedef Chain<WideCoefficient, COLUMN, SortedStorage<WideCoefficient>> WideChain;
+
+    /** \brief The minimal number of eliminated indexes removed at once from the matrix. */
+    static constexpr std::size_t MINIMAL_COMPACTION_SIZE = 64;
+
+private:
+    /** \brief Entries of a column, sorted by row. */
+    typedef std::vector<std::pair<int, WideCoefficient>> Entries;
+
+    /** \brief The best pivot of a column, when the column had the given version. */
+    struct PivotCandidate {
+        /** \brief The absolute value of the pivot. */
+        WideCoefficient value;
+
+        /** \brief The Markowitz cost of the pivot. */
+        long long cost;
+
+        /** \brief The pivot column. */
+        int column;
+
+        /** \brief The pivot row. */
+        int row;
+
+        /** \brief The version of the column. */
+        unsigned version;
+
+        /** \brief Lexicographic order on the value, the cost, then the position. */
+        bool operator>(const PivotCandidate &_other) const noexcept {
+            return std::tie(value, cost, column, row) > std::tie(_other.value, _other.cost, _other.column, _other.row);
+        }
+    };
+
+    /** \brief The matrix being eliminated, made square. */
+    Matrix matrix;
+
+    /** \brief The widened chains, empty if the chain is not widened. */
+    std::vector<WideChain> wideChains;
+
+    /** \brief Whether each column is widened. */
+    std::vector<char> widened;
+
+    /** \brief The greatest absolute coefficient of each column. */
+    std::vector<WideCoefficient> bounds;
+
+    /** \brief The number of entries of each row. */
+    std::vector<int> rowCounts;
+
+    /** \brief The columns having an entry in each row, possibly outdated or repeated, checked when read. */
+    std::vector<std::vector<int>> rowColumns;
+
+    /** \brief The pivot candidates, outdated ones are skipped. */
+    std::priority_queue<PivotCandidate, std::vector<PivotCandidate>, std::greater<PivotCandidate>> candidates;
+
+    /** \brief The version of each column, increased when its candidate is recomputed. */
+    std::vector<unsigned> versions;
+
+    /** \brief Whether each column changed since its candidate was computed. */
+    std::vector<char> dirty;
+
+    /** \brief The columns which changed since the last pivot search. */
+    std::vector<int> dirtyColumns;
+
+    /** \brief The rows of a column before it changes, reused buffer. */
+    std::vector<int> previousRows;
+
+    /** \brief The eliminated indexes not yet removed from the matrix. */
+    std::vector<int> eliminated;
+
+    /** \brief The invariant factors of the last matrix. */
+    std::vector<WideCoefficient> invariantFactors;
+
+    /** \brief The number of times a chain was widened. */
+    std::size_t widenedChainCount;
+
+public:
+    /**
+     * \brief Create new SmithNormalForm object.
+     */
+    SmithNormalForm();
+
+    /**
+     * \brief Computes the Smith normal form of a matrix.
+     *
+     * \warning Will raise an error if a coefficient overflows WideCoefficient.
+     *
+     * \param[in] _matrix The matrix.
+     *
+     * \return The invariant factors, each one dividing the next one.
+     */
+    const std::vector<WideCoefficient>& compute(const Matrix &_matrix);
+
+    /** \brief Get the invariant factors of the last matrix. */
+    const std::vector<WideCoefficient>& getInvariantFactors() const noexcept { return invariantFactors; }
+
+    /** \brief Get the rank of the last matrix. */
+    int getRank() const noexcept { return invariantFactors.size(); }
+
+    /** \brief Get the number of times a chain had to be widened during the last computation. */
+    std::size_t getWidenedChainCount() const noexcept { return widenedChainCount; }
+
+private:
+    /**
+     * \brief Finds the pivot of least absolute value, then of least Markowitz cost.
+     *
+     * The candidates of the columns changed since the last search are recomputed first.
+     *
+     * \param[out] _row The pivot row.
+     * \param[out] _column The pivot column.
+     *
+     * \return Whether the matrix still has an entry.
+     */
+    bool findPivot(int &_row, int &_column);
+
+    /** \brief Pushes the best pivot of a column, outdating its previous candidates. */
+    void pushCandidate(const int _column);
+
+    /** \brief Marks a column as changed. */
+    void markDirty(const int _column);
+
+    /** \brief Rebuilds the row index and recomputes every candidate, after the indexes changed. */
+    void rebuildIndex();
+
+    /**
+     * \brief Gets the columns having an entry in a row, and drops the outdated ones from the row index.
+     *
+     * \param[in] _row The row.
+     *
+     * \return The columns, sorted.
+     */
+    const std::vector<int>& rowEntries(const int _row);
+
+    /** \brief Saves the rows of a column in previousRows, before it changes. */
+    void savePreviousRows(const int _column);
+
+    /** \brief Adds to the row index the entries of a column which are not in previousRows. */
+    void indexNewEntries(const int _column);
+
+    /**
+     * \brief Eliminates the row and the column of a pivot, and records it.
+     *
+     * \param[in] _row The pivot row.
+     * \param[in] _column The pivot column.
+     */
+    void eliminate(const int _row, const int _column);
+
+    /**
+     * \brief Removes the eliminated indexes from the matrix.
+     */
+    void compact();
+
+    /**
+     * \brief Turns the recorded pivots into invariant factors.
+     */
+    void normalizeInvariantFactors();
+
+    /**
+     * \brief Calls a function on each entry of a column, widened or not.
+     *
+     * \param[in] _column The column.
+     * \param[in] _function The function, called with the row and the coefficient.
+     */
+    template <typename _Function>
+    void forEachEntry(const int _column, const _Function &_function) const;
+
+    /** \brief Number of entries of a column. */
+    std::size_t columnSize(const int _column) const;
+
+    /** \brief Get a coefficient of the matrix. */
+    WideCoefficient coefficient(const int _row, const int _column) const;
+
+    /** \brief Get the entries of a column. */
+    Entries entries(const int _column) const;
+
+    /**
+     * \brief Replaces a column, widened only if its coefficients do not fit OSM::ZCoefficient.
+     *
+     * \param[in] _column The column.
+     * \param[in] _entries The new entries, sorted and non null.
+     */
+    void assignColumn(const int _column, const Entries &_entries);
+
+    /**
+     * \brief Adds a multiple of a column to another one.
+     *
+     * \param[in] _destination The modified column.
+     * \param[in] _factor The factor.
+     * \param[in] _source The added column.
+     */
+    void addMultiple(const int _destination, const WideCoefficient _factor, const int _source);
+
+    /**
+     * \brief Applies a unimodular transform to two columns.
+     *
+     * The first column becomes _a * first + _b * second, the second one _c * first + _d * second.
+     */
+    void transformColumns(const int _first, const int _second, const WideCoefficient _a, const WideCoefficient _b, const WideCoefficient _c, const WideCoefficient _d);
+
+    /**
+     * \brief Applies a unimodular transform to two rows.
+     *
+     * The first row becomes _a * first + _b * second, the second one _c * first + _d * second.
+     */
+    void transformRows(const int _first, const int _second, const WideCoefficient _a, const WideCoefficient _b, const WideCoefficient _c, const WideCoefficient _d);
+
+    /** \brief Swaps two columns. */
+    void swapColumns(const int _first, const int _second);
+
+    /** \brief Computes _a * first + _b * second on sorted entries. */
+    static Entries combine(const Entries &_first, const WideCoefficient _a, const Entries &_second, const WideCoefficient _b);
+
+    /** \brief Narrows a value to WideCoefficient, raises std::overflow_error if it does not fit. */
+    static WideCoefficient narrow(const __int128 _value);
+
+    /** \brief Computes g = gcd(_a, _b) and _s, _t such that _s * _a + _t * _b = g. */
+    static WideCoefficient extendedGcd(const WideCoefficient _a, const WideCoefficient _b, WideCoefficient &_s, WideCoefficient &_t);
+
+    /** \brief Absolute value. */
+    static WideCoefficient absolute(const WideCoefficient _value) noexcept { return _value < 0 ? -_value : _value; }
+};
+
+template <typename _StorageType>
+SmithNormalForm<_StorageType>::SmithNormalForm() : widenedChainCount(0) {}
+
+template <typename _StorageType>
+const std::vector<typename SmithNormalForm<_StorageType>::WideCoefficient>& SmithNormalForm<_StorageType>::compute(const Matrix &_matrix) {
+    const int size = std::max(_matrix.getRowCount(), _matrix.getColumnCount());
+
+    matrix = Matrix(size, size);
+    for (int column = 0 ; column < _matrix.getColumnCount() ; column++) {
+        matrix.setColumn(column, _matrix[column]);
+    }
+
+    wideChains.assign(size, WideChain(size));
+    widened.assign(size, false);
+    bounds.assign(size, 0);
+    rowCounts.assign(size, 0);
+    eliminated.clear();
+    invariantFactors.clear();
+    widenedChainCount = 0;
+
+    for (int column = 0 ; column < size ; column++) {
+        forEachEntry(column, [&](const int _row, const WideCoefficient _coefficient) {
+            rowCounts[_row]++;
+            bounds[column] = std::max(bounds[column], absolute(_coefficient));
+        });
+    }
+
+    rebuildIndex();
+
+    int row, column;
+    while (findPivot(row, column)) {
+        eliminate(row, column);
+
+        if (eliminated.size() >= std::max<std::size_t>(MINIMAL_COMPACTION_SIZE, matrix.getColumnCount() / 4)) {
+            compact();
+        }
+    }
+
+    compact();
+    normalizeInvariantFactors();
+
+    return invariantFactors;
+}
+
+template <typename _StorageType>
+bool SmithNormalForm<_StorageType>::findPivot(int &_row, int &_column) {
+    for (int column : dirtyColumns) {
+        dirty[column] = false;
+        pushCandidate(column);
+    }
+    dirtyColumns.clear();
+
+    while (!candidates.empty()) {
+        const PivotCandidate candidate = candidates.top();
+        candidates.pop();
+
+        if (candidate.version == versions[candidate.column]) {
+            _row = candidate.row;
+            _column = candidate.column;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::pushCandidate(const int _column) {
+    versions[_column]++;
+
+    const long long columnCost = static_cast<long long>(columnSize(_column)) - 1;
+    if (columnCost < 0) {
+        return;
+    }
+
+    PivotCandidate best = {0, 0, _column, -1, versions[_column]};
+
+    forEachEntry(_column, [&](const int _entryRow, const WideCoefficient _coefficient) {
+        const WideCoefficient value = absolute(_coefficient);
+        const long long cost = (rowCounts[_entryRow] - 1) * columnCost;
+
+        if (best.row < 0 || value < best.value || (value == best.value && cost < best.cost)) {
+            best.value = value;
+            best.cost = cost;
+            best.row = _entryRow;
+        }
+    });
+
+    candidates.push(best);
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::markDirty(const int _column) {
+    if (!dirty[_column]) {
+        dirty[_column] = true;
+        dirtyColumns.push_back(_column);
+    }
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::rebuildIndex() {
+    const int size = matrix.getColumnCount();
+
+    rowColumns.assign(size, std::vector<int>());
+    candidates = decltype(candidates)();
+    versions.assign(size, 0);
+    dirty.assign(size, false);
+    dirtyColumns.clear();
+
+    for (int column = 0 ; column < size ; column++) {
+        forEachEntry(column, [&](const int _row, const WideCoefficient) {
+            rowColumns[_row].push_back(column);
+        });
+
+        markDirty(column);
+    }
+}
+
+template <typename _StorageType>
+const std::vector<int>& SmithNormalForm<_StorageType>::rowEntries(const int _row) {
+    std::vector<int> &columns = rowColumns[_row];
+
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    columns.erase(std::remove_if(columns.begin(), columns.end(), [&](const int _column) {
+        return coefficient(_row, _column) == 0;
+    }), columns.end());
+
+    return columns;
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::savePreviousRows(const int _column) {
+    previousRows.clear();
+    forEachEntry(_column, [&](const int _row, const WideCoefficient) {
+        previousRows.push_back(_row);
+    });
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::indexNewEntries(const int _column) {
+    std::size_t previous = 0;
+
+    // Both are sorted by row, the rows the column already had are in the index
+    forEachEntry(_column, [&](const int _row, const WideCoefficient) {
+        while (previous < previousRows.size() && previousRows[previous] < _row) {
+            previous++;
+        }
+
+        if (previous == previousRows.size() || previousRows[previous] != _row) {
+            rowColumns[_row].push_back(_column);
+        }
+    });
+
+    markDirty(_column);
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::eliminate(const int _row, const int _column) {
+    WideCoefficient pivot = coefficient(_row, _column);
+
+    while (true) {
+        // Clears the pivot row with column operations, the operations only change the pivot row in the pivot column
+        const std::vector<int> columns = rowEntries(_row);
+
+        for (int column : columns) {
+            if (column == _column) {
+                continue;
+            }
+
+            const WideCoefficient value = coefficient(_row, column);
+            if (value == 0) {
+                continue;
+            }
+
+            if (value % pivot == 0) {
+                addMultiple(column, -(value / pivot), _column);
+            } else {
+                WideCoefficient s, t;
+                const WideCoefficient gcd = extendedGcd(pivot, value, s, t);
+
+                transformColumns(_column, column, s, t, -(value / gcd), pivot / gcd);
+                pivot = gcd;
+            }
+        }
+
+        // The pivot row has a single entry, the row operations clearing the pivot column only change the pivot column
+        int blockingRow = -1;
+        WideCoefficient blockingValue = 0;
+
+        forEachEntry(_column, [&](const int _entryRow, const WideCoefficient _coefficient) {
+            if (blockingRow < 0 && _entryRow != _row && _coefficient % pivot != 0) {
+                blockingRow = _entryRow;
+                blockingValue = _coefficient;
+            }
+        });
+
+        if (blockingRow < 0) {
+            break;
+        }
+
+        WideCoefficient s, t;
+        const WideCoefficient gcd = extendedGcd(pivot, blockingValue, s, t);
+
+        transformRows(_row, blockingRow, s, t, -(blockingValue / gcd), pivot / gcd);
+        pivot = gcd;
+    }
+
+    invariantFactors.push_back(absolute(pivot));
+
+    assignColumn(_column, Entries());
+    swapColumns(_column, _row);
+    eliminated.push_back(_row);
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::compact() {
+    if (eliminated.empty()) {
+        return;
+    }
+
+    std::sort(eliminated.begin(), eliminated.end());
+    matrix /= eliminated;
+
+    const int size = matrix.getRowCount();
+    std::size_t write = 0;
+    std::vector<int>::const_iterator removed = eliminated.begin();
+
+    for (std::size_t read = 0 ; read < wideChains.size() ; read++) {
+        if (removed != eliminated.end() && *removed == static_cast<int>(read)) {
+            ++removed;
+            continue;
+        }
+
+        // Only the widened chains hold entries, the others are simply resized
+        if (widened[read]) {
+            wideChains[read] /= eliminated;
+        } else {
+            wideChains[read] = WideChain(size);
+        }
+
+        if (write != read) {
+            wideChains[write] = std::move(wideChains[read]);
+            widened[write] = widened[read];
+            bounds[write] = bounds[read];
+            rowCounts[write] = rowCounts[read];
+        }
+        write++;
+    }
+
+    wideChains.resize(write);
+    widened.resize(write);
+    bounds.resize(write);
+    rowCounts.resize(write);
+    eliminated.clear();
+
+    rebuildIndex();
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::normalizeInvariantFactors() {
+    std::sort(invariantFactors.begin(), invariantFactors.end());
+
+    const std::size_t firstNonUnit = std::upper_bound(invariantFactors.begin(), invariantFactors.end(), WideCoefficient(1)) - invariantFactors.begin();
+
+    for (std::size_t first = firstNonUnit ; first < invariantFactors.size() ; first++) {
+        for (std::size_t second = first + 1 ; second < invariantFactors.size() ; second++) {
+            WideCoefficient s, t;
+            const WideCoefficient gcd = extendedGcd(invariantFactors[first], invariantFactors[second], s, t);
+
+            invariantFactors[second] = narrow(static_cast<__int128>(invariantFactors[first] / gcd) * invariantFactors[second]);
+            invariantFactors[first] = gcd;
+        }
+    }
+}
+
+template <typename _StorageType>
+template <typename _Function>
+void SmithNormalForm<_StorageType>::forEachEntry(const int _column, const _Function &_function) const {
+    if (widened[_column]) {
+        for (typename WideChain::const_iterator it = wideChains[_column].cbegin() ; it != wideChains[_column].cend() ; ++it) {
+            _function(it->first, it->second);
+        }
+    } else {
+        for (typename Matrix::MatrixChain::const_iterator it = matrix.chains[_column].cbegin() ; it != matrix.chains[_column].cend() ; ++it) {
+            _function(it->first, WideCoefficient(it->second));
+        }
+    }
+}
+
+template <typename _StorageType>
+std::size_t SmithNormalForm<_StorageType>::columnSize(const int _column) const {
+    return widened[_column] ? wideChains[_column].size() : matrix.chains[_column].size();
+}
+
+template <typename _StorageType>
+typename SmithNormalForm<_StorageType>::WideCoefficient SmithNormalForm<_StorageType>::coefficient(const int _row, const int _column) const {
+    if (widened[_column]) {
+        return wideChains[_column][_row];
+    }
+
+    return matrix.chains[_column][_row];
+}
+
+template <typename _StorageType>
+typename SmithNormalForm<_StorageType>::Entries SmithNormalForm<_StorageType>::entries(const int _column) const {
+    Entries result;
+
+    result.reserve(columnSize(_column));
+    forEachEntry(_column, [&](const int _row, const WideCoefficient _coefficient) {
+        result.emplace_back(_row, _coefficient);
+    });
+
+    return result;
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::assignColumn(const int _column, const Entries &_entries) {
+    const int size = matrix.getRowCount();
+    WideCoefficient bound = 0;
+
+    savePreviousRows(_column);
+    for (int row : previousRows) {
+        rowCounts[row]--;
+    }
+
+    for (const std::pair<int, WideCoefficient> &entry : _entries) {
+        rowCounts[entry.first]++;
+        bound = std::max(bound, absolute(entry.second));
+    }
+
+    if (bound <= INT_MAX) {
+        typename Matrix::MatrixChain chain(size);
+        for (const std::pair<int, WideCoefficient> &entry : _entries) {
+            chain[entry.first] = ZCoefficient(entry.second);
+        }
+
+        matrix.chains[_column] = std::move(chain);
+        wideChains[_column] = WideChain(size);
+        widened[_column] = false;
+    } else {
+        WideChain chain(size);
+        for (const std::pair<int, WideCoefficient> &entry : _entries) {
+            chain[entry.first] = entry.second;
+        }
+
+        wideChains[_column] = std::move(chain);
+        matrix.chains[_column] = typename Matrix::MatrixChain(size);
+
+        if (!widened[_column]) {
+            widened[_column] = true;
+            widenedChainCount++;
+        }
+    }
+
+    matrix.updateChainState(_column, matrix.chains[_column].size() == 0);
+    bounds[_column] = bound;
+    indexNewEntries(_column);
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::addMultiple(const int _destination, const WideCoefficient _factor, const int _source) {
+    const __int128 bound = static_cast<__int128>(bounds[_destination]) + static_cast<__int128>(absolute(_factor)) * bounds[_source];
+
+    if (!widened[_destination] && !widened[_source] && bound <= INT_MAX) {
+        typename Matrix::MatrixChain &destination = matrix.chains[_destination];
+
+        savePreviousRows(_destination);
+        for (int row : previousRows) {
+            rowCounts[row]--;
+        }
+
+        destination.addScaled(ZCoefficient(_factor), matrix.chains[_source]);
+        matrix.updateChainState(_destination, destination.size() == 0);
+        bounds[_destination] = 0;
+
+        for (typename Matrix::MatrixChain::const_iterator it = destination.cbegin() ; it != destination.cend() ; ++it) {
+            rowCounts[it->first]++;
+            bounds[_destination] = std::max(bounds[_destination], absolute(it->second));
+        }
+
+        indexNewEntries(_destination);
+        return;
+    }
+
+    assignColumn(_destination, combine(entries(_destination), 1, entries(_source), _factor));
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::transformColumns(const int _first, const int _second, const WideCoefficient _a, const WideCoefficient _b, const WideCoefficient _c, const WideCoefficient _d) {
+    const Entries first = entries(_first);
+    const Entries second = entries(_second);
+
+    assignColumn(_first, combine(first, _a, second, _b));
+    assignColumn(_second, combine(first, _c, second, _d));
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::transformRows(const int _first, const int _second, const WideCoefficient _a, const WideCoefficient _b, const WideCoefficient _c, const WideCoefficient _d) {
+    // Only the columns meeting one of the rows change
+    std::vector<int> columns;
+    const std::vector<int> &firstColumns = rowEntries(_first);
+    const std::vector<int> &secondColumns = rowEntries(_second);
+    std::set_union(firstColumns.begin(), firstColumns.end(), secondColumns.begin(), secondColumns.end(), std::back_inserter(columns));
+
+    for (int column : columns) {
+        const WideCoefficient first = coefficient(_first, column);
+        const WideCoefficient second = coefficient(_second, column);
+
+        if (first == 0 && second == 0) {
+            continue;
+        }
+
+        const WideCoefficient newFirst = narrow(static_cast<__int128>(_a) * first + static_cast<__int128>(_b) * second);
+        const WideCoefficient newSecond = narrow(static_cast<__int128>(_c) * first + static_cast<__int128>(_d) * second);
+
+        Entries updated;
+        updated.reserve(columnSize(column) + 2);
+
+        forEachEntry(column, [&](const int _row, const WideCoefficient _coefficient) {
+            if (_row != _first && _row != _second) {
+                updated.emplace_back(_row, _coefficient);
+            }
+        });
+
+        if (newFirst != 0) {
+            updated.emplace_back(_first, newFirst);
+        }
+        if (newSecond != 0) {
+            updated.emplace_back(_second, newSecond);
+        }
+
+        std::sort(updated.begin(), updated.end());
+        assignColumn(column, updated);
+    }
+}
+
+template <typename _StorageType>
+void SmithNormalForm<_StorageType>::swapColumns(const int _first, const int _second) {
+    if (_first == _second) {
+        return;
+    }
+
+    std::swap(matrix.chains[_first], matrix.chains[_second]);
+    matrix.updateChainState(_first, matrix.chains[_first].size() == 0);
+    matrix.updateChainState(_second, matrix.chains[_second].size() == 0);
+    std::swap(wideChains[_first], wideChains[_second]);
+    std::swap(widened[_first], widened[_second]);
+    std::swap(bounds[_first], bounds[_second]);
+
+    // The index entries under the former positions become outdated
+    for (int column : {_first, _second}) {
+        forEachEntry(column, [&](const int _row, const WideCoefficient) {
+            rowColumns[_row].push_back(column);
+        });
+        markDirty(column);
+    }
+}
+
+template <typename _StorageType>
+typename SmithNormalForm<_StorageType>::Entries SmithNormalForm<_StorageType>::combine(const Entries &_first, const WideCoefficient _a, const Entries &_second, const WideCoefficient _b) {
+    Entries result;
+    result.reserve(_first.size() + _second.size());
+
+    std::size_t first = 0;
+    std::size_t second = 0;
+
+    while (first < _first.size() || second < _second.size()) {
+        int row;
+        __int128 value = 0;
+
+        if (second == _second.size() || (first < _first.size() && _first[first].first < _second[second].first)) {
+            row = _first[first].first;
+            value = static_cast<__int128>(_a) * _first[first++].second;
+        } else if (first == _first.size() || _second[second].first < _first[first].first) {
+            row = _second[second].first;
+            value = static_cast<__int128>(_b) * _second[second++].second;
+        } else {
+            row = _first[first].first;
+            value = static_cast<__int128>(_a) * _first[first++].second + static_cast<__int128>(_b) * _second[second++].second;
+        }
+
+        if (value != 0) {
+            result.emplace_back(row, narrow(value));
+        }
+    }
+
+    return result;
+}
+
+template <typename _StorageType>
+typename SmithNormalForm<_StorageType>::WideCoefficient SmithNormalForm<_StorageType>::narrow(const __int128 _value) {
+    if (_value > LLONG_MAX || _value < -static_cast<__int128>(LLONG_MAX)) {
+        throw std::overflow_error("Coefficient growth overflows the wide coefficient type.");
+    }
+
+    return static_cast<WideCoefficient>(_value);
+}
+
+template <typename _StorageType>
+typename SmithNormalForm<_StorageType>::WideCoefficient SmithNormalForm<_StorageType>::extendedGcd(const WideCoefficient _a, const WideCoefficient _b, WideCoefficient &_s, WideCoefficient &_t) {
+    WideCoefficient oldRemainder = _a, remainder = _b;
+    WideCoefficient oldS = 1, s = 0;
+    WideCoefficient oldT = 0, t = 1;
+
+    while (remainder != 0) {
+        const WideCoefficient quotient = oldRemainder / remainder;
+
+        oldRemainder = std::exchange(remainder, oldRemainder - quotient * remainder);
+        oldS = std::exchange(s, oldS - quotient * s);
+        oldT = std::exchange(t, oldT - quotient * t);
+    }
+
+    _s = oldS;
+    _t = oldT;
+
+    return oldRemainder;
+}
+
+}
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * \file SparseAccumulator.hpp
+ * \brief Dense scratch accumulator for sums of sparse chains.
+ *
+ * Define everything for the SparseAccumulator class
+ */
+
+#ifndef __OSM_SPARSE_ACCUMULATOR__
+#define __OSM_SPARSE_ACCUMULATOR__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class SparseAccumulator
+ * \brief Dense accumulator with a touched-index list.
+ *
+ * Accumulates linear combinations of chains into a dense array of coefficients while recording which indexes
+ * were touched, so that both accumulation and extraction cost is proportional to the number of touched indexes.
+ * The touched flags are generation stamps, resetting the accumulator never scans the dense array.
+ *
+ * Values are accumulated unreduced through OSM::DeferredReduction, so a Z/pZ sum of products is only reduced when
+ * extracted.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ */
+template <typename _CoefficientType>
+class SparseAccumulator {
+
+    typedef DeferredReduction<_CoefficientType> Reduction;
+
+private:
+    /** \brief The dense accumulated coefficients, unreduced. */
+    std::vector<typename Reduction::accumulator_type> values;
+
+    /** \brief The generation in which each index was last touched. */
+    std::vector<uint32_t> marks;
+
+    /** \brief The current generation. */
+    uint32_t generation;
+
+    /** \brief The indexes touched during the current generation. */
+    std::vector<int> touched;
+
+public:
+    /**
+     * \brief Create new SparseAccumulator object.
+     *
+     * Default constructor, initialize an accumulator of size 0.
+     */
+    SparseAccumulator() : generation(1) {}
+
+    /**
+     * \brief Create new SparseAccumulator object.
+     *
+     * \param[in] _size The number of indexes the accumulator can hold.
+     */
+    explicit SparseAccumulator(const int _size) : values(_size), marks(_size, 0), generation(1) {}
+
+    /**
+     * \brief Changes the number of indexes the accumulator can hold.
+     *
+     * \warning Discards the accumulated values.
+     *
+     * \param[in] _size The number of indexes.
+     */
+    void resize(const int _size);
+
+    /** \brief Number of indexes the accumulator can hold. */
+    int size() const noexcept { return values.size(); }
+
+    /** \brief Number of indexes touched since the last reset. */
+    std::size_t touchedCount() const noexcept { return touched.size(); }
+
+    /**
+     * \brief Adds a value at the given index.
+     *
+     * \param[in] _index The coefficient index.
+     * \param[in] _value The value to add.
+     */
+    inline void add(const int _index, const _CoefficientType _value);
+
+    /**
+     * \brief Adds a scaled chain.
+     *
+     * \tparam _Entries Any iterable of (index, coefficient) entries, such as OSM::Chain.
+     *
+     * \param[in] _entries The entries to add.
+     * \param[in] _lambda The factor applied to the entries.
+     */
+    template <typename _Entries>
+    void addScaled(const _Entries &_entries, const _CoefficientType _lambda);
+
+    /**
+     * \brief Writes the non zero accumulated values into a storage and reset the accumulator.
+     *
+     * The entries are written by increasing index. Touched indexes are sorted when they are few,
+     * the dense array is scanned otherwise.
+     *
+     * \tparam _Storage The chain storage policy.
+     *
+     * \param[in] _storage The storage to overwrite.
+     */
+    template <typename _Storage>
+    void flush(_Storage &_storage);
+
+    /**
+     * \brief Forgets all accumulated values.
+     */
+    void reset();
+};
+
+template <typename _CoefficientType>
+void SparseAccumulator<_CoefficientType>::resize(const int _size) {
+    values.assign(_size, Reduction::lift(_CoefficientType(0)));
+    marks.assign(_size, 0);
+    touched.clear();
+    generation = 1;
+}
+
+template <typename _CoefficientType>
+inline void SparseAccumulator<_CoefficientType>::add(const int _index, const _CoefficientType _value) {
+    if (marks[_index] != generation) {
+        marks[_index] = generation;
+        values[_index] = Reduction::lift(_value);
+        touched.push_back(_index);
+    } else {
+        Reduction::accumulate(values[_index], _value);
+    }
+}
+
+template <typename _CoefficientType>
+template <typename _Entries>
+void SparseAccumulator<_CoefficientType>::addScaled(const _Entries &_entries, const _CoefficientType _lambda) {
+    for (typename _Entries::const_iterator it = _entries.begin() ; it != _entries.end() ; ++it) {
+        const int index = it->first;
+
+        if (marks[index] != generation) {
+            marks[index] = generation;
+            values[index] = Reduction::lift(_CoefficientType(0));
+            touched.push_back(index);
+        }
+        Reduction::accumulate(values[index], it->second, _lambda);
+    }
+}
+
+template <typename _CoefficientType>
+template <typename _Storage>
+void SparseAccumulator<_CoefficientType>::flush(_Storage &_storage) {
+    _storage.clear();
+    _storage.reserve(touched.size());
+
+    if (touched.size() * 8 > values.size()) {
+        for (int index = 0 ; index < static_cast<int>(values.size()) ; index++) {
+            if (marks[index] == generation) {
+                const _CoefficientType value = Reduction::reduce(values[index]);
+
+                if (value != _CoefficientType(0)) {
+                    _storage.append(index, value);
+                }
+            }
+        }
+    } else {
+        std::sort(touched.begin(), touched.end());
+
+        for (int index : touched) {
+            const _CoefficientType value = Reduction::reduce(values[index]);
+
+            if (value != _CoefficientType(0)) {
+                _storage.append(index, value);
+            }
+        }
+    }
+
+    reset();
+}
+
+template <typename _CoefficientType>
+void SparseAccumulator<_CoefficientType>::reset() {
+    touched.clear();
+    generation++;
+
+    if (generation == 0) {
+        std::fill(marks.begin(), marks.end(), 0);
+        generation = 1;
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,676 @@
+/**
+ * \file SparseKernels.hpp
+ * \brief Scalar and SIMD kernels for sparse dot products and products by dense blocks.
+ *
+ * Define everything for the SparseKernels structure
+ */
+
+#ifndef __OSM_SPARSE_KERNELS__
+#define __OSM_SPARSE_KERNELS__
+
+
+#include "__base.hpp"
+#include "Coefficient.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OSM_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#if defined(OSM_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+/** \brief Compiles a function for the given instruction sets, whatever the flags of the translation unit. */
+#define OSM_TARGET(_features) __attribute__((target(_features)))
+#else
+#define OSM_TARGET(_features)
+#endif
+
+
+namespace OSM {
+
+/**
+ * \brief The instruction sets used by the OSM::SparseKernels.
+ */
+enum class SimdLevel {
+    /** \brief Plain loops, vectorized by the compiler only. */
+    SCALAR,
+    /** \brief AVX2 and FMA kernels. */
+    AVX2,
+    /** \brief AVX-512 kernels. */
+    AVX512
+};
+
+/**
+ * \brief The instruction sets the kernels run on.
+ *
+ * With GCC and Clang the processor is queried once, so a library built without -march flags still runs the SIMD
+ * kernels. Other compilers only use the instruction sets enabled at compile time.
+ *
+ * \return The widest instruction set supported by the processor and the compiler.
+ */
+inline SimdLevel simdLevel() noexcept {
+#if defined(__AVX512F__)
+    return SimdLevel::AVX512;
+#elif defined(OSM_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SCALAR;
+    }();
+
+    return level;
+#elif defined(__AVX2__)
+    return SimdLevel::AVX2;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+/**
+ * \brief Name of an instruction set level.
+ *
+ * \param[in] _level The level.
+ *
+ * \return "scalar", "avx2" or "avx512".
+ */
+inline const char* simdLevelName(const SimdLevel _level) noexcept {
+    switch (_level) {
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * \brief Flat kernels combining the (index, coefficient) arrays of a chain with dense vectors.
+ *
+ * The products of a matrix with a vector or a block of vectors reduce to these kernels, run on the arrays of each
+ * chain. Dense blocks are stored row-major: entry v of row i of a block of _vectorCount vectors is at
+ * i * _vectorCount + v, so the vectors of a row are contiguous.
+ *
+ * The dot and scatter kernels use AVX2 or AVX-512 gathers on ZCoefficient and double chains when the processor
+ * supports them, as given by OSM::simdLevel, other types accumulate through OSM::DeferredReduction. The block kernels
+ * keep OSM::SparseKernels::BLOCK_WIDTH vectors in registers, the loops over them being vectorized by the compiler.
+ *
+ * The tile kernels combine two dense arrays of coefficients, the dense tiles of OSM::HybridStorage chains, with
+ * plain AVX2 or AVX-512 loads instead of gathers.
+ *
+ * The SIMD bodies are compiled for their instruction sets through function target attributes and selected at run
+ * time, so no -march flag is needed. OSM_NATIVE only lets the compiler vectorize the plain loops further.
+ *
+ * The intersection kernel computes the dot product of two chains from their sorted indexes, galloping through the
+ * longer chain when their sizes are far apart.
+ *
+ * \tparam _CoefficientType The chain's coefficient types.
+ */
+template <typename _CoefficientType>
+struct SparseKernels {
+    /** \brief The unreduced sums policy. */
+    typedef DeferredReduction<_CoefficientType> Reduction;
+
+    /** \brief The unreduced sum type. */
+    typedef typename Reduction::accumulator_type Accumulator;
+
+    /** \brief The number of vectors of a block accumulated together. */
+    static constexpr int BLOCK_WIDTH = 8;
+
+    /** \brief The size ratio above which an intersection gallops through the longer chain. */
+    static constexpr std::size_t GALLOPING_RATIO = 16;
+
+    /**
+     * \brief Dot product of a chain with a dense vector.
+     *
+     * \param[in] _indexes The chain indexes.
+     * \param[in] _coefficients The chain coefficients.
+     * \param[in] _count The number of entries.
+     * \param[in] _vector The dense vector.
+     *
+     * \return The sum of the coefficients times the vector entries at their indexes.
+     */
+    static _CoefficientType dot(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector) noexcept;
+
+    /**
+     * \brief Dot products of a chain with each vector of a dense block.
+     *
+     * \param[in] _indexes The chain indexes.
+     * \param[in] _coefficients The chain coefficients.
+     * \param[in] _count The number of entries.
+     * \param[in] _block The dense block, row-major.
+     * \param[in] _vectorCount The number of vectors of the block.
+     * \param[out] _result The _vectorCount dot products.
+     */
+    static void dotBlock(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_block, const int _vectorCount, _CoefficientType *_result) noexcept;
+
+    /**
+     * \brief Adds a scaled chain to a dense vector.
+     *
+     * \pre The indexes are unique.
+     *
+     * \param[in] _indexes The chain indexes.
+     * \param[in] _coefficients The chain coefficients.
+     * \param[in] _count The number of entries.
+     * \param[in] _factor The factor applied to the chain.
+     * \param[in,out] _vector The dense vector.
+     */
+    static void scatterAdd(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType _factor, _CoefficientType *_vector) noexcept;
+
+    /**
+     * \brief Adds a chain scaled by each factor to the vectors of a dense block.
+     *
+     * \param[in] _indexes The chain indexes.
+     * \param[in] _coefficients The chain coefficients.
+     * \param[in] _count The number of entries.
+     * \param[in] _factors The _vectorCount factors, one per vector.
+     * \param[in] _vectorCount The number of vectors of the block.
+     * \param[in,out] _block The dense block, row-major.
+     */
+    static void scatterAddBlock(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_factors, const int _vectorCount, _CoefficientType *_block) noexcept;
+
+    /**
+     * \brief Adds a scaled dense tile to another one.
+     *
+     * \pre The tiles do not overlap.
+     *
+     * \param[in] _factor The factor applied to the added tile.
+     * \param[in] _source The added tile.
+     * \param[in] _count The number of coefficients of the added tile.
+     * \param[in,out] _target The tile receiving the sum.
+     */
+    static void tileAddScaled(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept;
+
+    /**
+     * \brief Dot product of two dense tiles.
+     *
+     * \param[in] _first The first tile.
+     * \param[in] _second The second tile.
+     * \param[in] _count The number of coefficients of both tiles.
+     *
+     * \return The sum of the products of the coefficients at the same position.
+     */
+    static _CoefficientType tileDot(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count) noexcept;
+
+    /**
+     * \brief Sum of the squares of coefficients.
+     *
+     * \param[in] _coefficients The coefficients.
+     * \param[in] _count The number of coefficients.
+     *
+     * \return The squared Euclidean norm of the coefficients.
+     */
+    static _CoefficientType squaredNorm(const _CoefficientType *_coefficients, const std::size_t _count) noexcept { return tileDot(_coefficients, _coefficients, _count); }
+
+    /**
+     * \brief Dot product of two chains, by intersecting their sorted indexes.
+     *
+     * The indexes are merged without branching on their order. When a chain is more than GALLOPING_RATIO times longer
+     * than the other, each index of the shorter chain is searched in the longer one by exponential search instead.
+     *
+     * \pre The indexes of each chain are sorted and unique.
+     *
+     * \param[in] _firstIndexes The first chain indexes.
+     * \param[in] _firstCoefficients The first chain coefficients.
+     * \param[in] _firstCount The number of entries of the first chain.
+     * \param[in] _secondIndexes The second chain indexes.
+     * \param[in] _secondCoefficients The second chain coefficients.
+     * \param[in] _secondCount The number of entries of the second chain.
+     *
+     * \return The sum of the products of the coefficients sharing an index.
+     */
+    static _CoefficientType intersectionDot(
+        const int *_firstIndexes, const _CoefficientType *_firstCoefficients, const std::size_t _firstCount,
+        const int *_secondIndexes, const _CoefficientType *_secondCoefficients, const std::size_t _secondCount
+    ) noexcept;
+
+    /**
+     * \brief Counts the non null coefficients of a dense tile.
+     *
+     * \param[in] _tile The tile.
+     * \param[in] _count The number of coefficients of the tile.
+     *
+     * \return The number of coefficients different from 0.
+     */
+    static std::size_t tileNonZeroCount(const _CoefficientType *_tile, const std::size_t _count) noexcept;
+
+private:
+#if defined(OSM_X86_KERNELS)
+    /** \brief Whether the coefficient type has SIMD kernel bodies. */
+    static constexpr bool VECTORIZED = std::is_same<_CoefficientType, int>::value || std::is_same<_CoefficientType, double>::value;
+
+    /** \brief Sum of the lanes of an integer register. */
+    OSM_TARGET("avx2") static int horizontalSum(const __m256i _sums) noexcept {
+        __m128i halves = _mm_add_epi32(_mm256_castsi256_si128(_sums), _mm256_extracti128_si256(_sums, 1));
+        halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(1, 0, 3, 2)));
+        halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(halves);
+    }
+
+    /** \brief Sum of the lanes of a double register. */
+    OSM_TARGET("avx2") static double horizontalSum(const __m256d _sums) noexcept {
+        const __m128d halves = _mm_add_pd(_mm256_castpd256_pd128(_sums), _mm256_extractf128_pd(_sums, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+    }
+
+    /*
+     * The SIMD bodies of the kernels process a prefix of the entries and return its length, the public kernels
+     * finishing the remaining entries with plain loops. They do nothing on types without a SIMD body.
+     */
+
+    OSM_TARGET("avx2,fma") static std::size_t dotAvx2(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector, Accumulator &_sum) noexcept;
+    OSM_TARGET("avx512f,avx2,fma") static std::size_t dotAvx512(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector, Accumulator &_sum) noexcept;
+    OSM_TARGET("avx512f,avx2,fma") static std::size_t scatterAddAvx512(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType _factor, _CoefficientType *_vector) noexcept;
+    OSM_TARGET("avx2,fma") static std::size_t tileAddScaledAvx2(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept;
+    OSM_TARGET("avx512f,avx2,fma") static std::size_t tileAddScaledAvx512(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept;
+    OSM_TARGET("avx2,fma") static std::size_t tileDotAvx2(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count, Accumulator &_sum) noexcept;
+    OSM_TARGET("avx512f,avx2,fma") static std::size_t tileDotAvx512(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count, Accumulator &_sum) noexcept;
+#endif
+};
+
+template <typename _CoefficientType>
+_CoefficientType SparseKernels<_CoefficientType>::dot(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector) noexcept {
+    std::size_t position = 0;
+    Accumulator sum = Accumulator();
+
+#if defined(OSM_X86_KERNELS)
+    if constexpr (VECTORIZED) {
+        switch (simdLevel()) {
+            case SimdLevel::AVX512: position = dotAvx512(_indexes, _coefficients, _count, _vector, sum); break;
+            case SimdLevel::AVX2: position = dotAvx2(_indexes, _coefficients, _count, _vector, sum); break;
+            default: break;
+        }
+    }
+#endif
+
+    for ( ; position < _count ; position++) {
+        Reduction::accumulate(sum, _coefficients[position], _vector[_indexes[position]]);
+    }
+
+    return Reduction::reduce(sum);
+}
+
+template <typename _CoefficientType>
+void SparseKernels<_CoefficientType>::dotBlock(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_block, const int _vectorCount, _CoefficientType *_result) noexcept {
+    int first = 0;
+
+    for ( ; first + BLOCK_WIDTH <= _vectorCount ; first += BLOCK_WIDTH) {
+        Accumulator sums[BLOCK_WIDTH] = {};
+
+        for (std::size_t position = 0 ; position < _count ; position++) {
+            const _CoefficientType *row = _block + std::size_t(_indexes[position]) * _vectorCount + first;
+
+            for (int vector = 0 ; vector < BLOCK_WIDTH ; vector++) {
+                Reduction::accumulate(sums[vector], _coefficients[position], row[vector]);
+            }
+        }
+
+        for (int vector = 0 ; vector < BLOCK_WIDTH ; vector++) {
+            _result[first + vector] = Reduction::reduce(sums[vector]);
+        }
+    }
+
+    if (first < _vectorCount) {
+        const int width = _vectorCount - first;
+        Accumulator sums[BLOCK_WIDTH] = {};
+
+        for (std::size_t position = 0 ; position < _count ; position++) {
+            const _CoefficientType *row = _block + std::size_t(_indexes[position]) * _vectorCount + first;
+
+            for (int vector = 0 ; vector < width ; vector++) {
+                Reduction::accumulate(sums[vector], _coefficients[position], row[vector]);
+            }
+        }
+
+        for (int vector = 0 ; vector < width ; vector++) {
+            _result[first + vector] = Reduction::reduce(sums[vector]);
+        }
+    }
+}
+
+template <typename _CoefficientType>
+void SparseKernels<_CoefficientType>::scatterAdd(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType _factor, _CoefficientType *_vector) noexcept {
+    std::size_t position = 0;
+
+#if defined(OSM_X86_KERNELS)
+    if constexpr (VECTORIZED) {
+        if (simdLevel() == SimdLevel::AVX512) {
+            position = scatterAddAvx512(_indexes, _coefficients, _count, _factor, _vector);
+        }
+    }
+#endif
+
+    for ( ; position < _count ; position++) {
+        _vector[_indexes[position]] += _factor * _coefficients[position];
+    }
+}
+
+template <typename _CoefficientType>
+void SparseKernels<_CoefficientType>::scatterAddBlock(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_factors, const int _vectorCount, _CoefficientType *_block) noexcept {
+    int first = 0;
+
+    for ( ; first + BLOCK_WIDTH <= _vectorCount ; first += BLOCK_WIDTH) {
+        _CoefficientType factors[BLOCK_WIDTH];
+        std::copy(_factors + first, _factors + first + BLOCK_WIDTH, factors);
+
+        for (std::size_t position = 0 ; position < _count ; position++) {
+            _CoefficientType *row = _block + std::size_t(_indexes[position]) * _vectorCount + first;
+
+            for (int vector = 0 ; vector < BLOCK_WIDTH ; vector++) {
+                row[vector] += _coefficients[position] * factors[vector];
+            }
+        }
+    }
+
+    for (std::size_t position = 0 ; first < _vectorCount && position < _count ; position++) {
+        _CoefficientType *row = _block + std::size_t(_indexes[position]) * _vectorCount;
+
+        for (int vector = first ; vector < _vectorCount ; vector++) {
+            row[vector] += _coefficients[position] * _factors[vector];
+        }
+    }
+}
+template <typename _CoefficientType>
+void SparseKernels<_CoefficientType>::tileAddScaled(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept {
+    std::size_t position = 0;
+
+#if defined(OSM_X86_KERNELS)
+    if constexpr (VECTORIZED) {
+        switch (simdLevel()) {
+            case SimdLevel::AVX512: position = tileAddScaledAvx512(_factor, _source, _count, _target); break;
+            case SimdLevel::AVX2: position = tileAddScaledAvx2(_factor, _source, _count, _target); break;
+            default: break;
+        }
+    }
+#endif
+
+    for ( ; position < _count ; position++) {
+        _target[position] += _factor * _source[position];
+    }
+}
+
+template <typename _CoefficientType>
+_CoefficientType SparseKernels<_CoefficientType>::tileDot(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count) noexcept {
+    std::size_t position = 0;
+    Accumulator sum = Accumulator();
+
+#if defined(OSM_X86_KERNELS)
+    if constexpr (VECTORIZED) {
+        switch (simdLevel()) {
+            case SimdLevel::AVX512: position = tileDotAvx512(_first, _second, _count, sum); break;
+            case SimdLevel::AVX2: position = tileDotAvx2(_first, _second, _count, sum); break;
+            default: break;
+        }
+    }
+#endif
+
+    for ( ; position < _count ; position++) {
+        Reduction::accumulate(sum, _first[position], _second[position]);
+    }
+
+    return Reduction::reduce(sum);
+}
+
+template <typename _CoefficientType>
+_CoefficientType SparseKernels<_CoefficientType>::intersectionDot(
+    const int *_firstIndexes, const _CoefficientType *_firstCoefficients, const std::size_t _firstCount,
+    const int *_secondIndexes, const _CoefficientType *_secondCoefficients, const std::size_t _secondCount
+) noexcept {
+    Accumulator sum = Accumulator();
+
+    if (_firstCount * GALLOPING_RATIO < _secondCount || _secondCount * GALLOPING_RATIO < _firstCount) {
+        const bool firstIsShorter = _firstCount < _secondCount;
+        const int *shortIndexes = firstIsShorter ? _firstIndexes : _secondIndexes;
+        const _CoefficientType *shortCoefficients = firstIsShorter ? _firstCoefficients : _secondCoefficients;
+        const std::size_t shortCount = firstIsShorter ? _firstCount : _secondCount;
+        const int *longIndexes = firstIsShorter ? _secondIndexes : _firstIndexes;
+        const _CoefficientType *longCoefficients = firstIsShorter ? _secondCoefficients : _firstCoefficients;
+        const int *longEnd = longIndexes + (firstIsShorter ? _secondCount : _firstCount);
+
+        const int *position = longIndexes;
+
+        for (std::size_t entry = 0 ; entry < shortCount && position != longEnd ; entry++) {
+            const int index = shortIndexes[entry];
+            const std::size_t remaining = longEnd - position;
+
+            // Exponential search of the first index not lower than index, from the current position
+            std::size_t low = 0;
+            std::size_t step = 1;
+            while (step < remaining && position[step] < index) {
+                low = step;
+                step *= 2;
+            }
+            position = std::lower_bound(position + low, position + std::min(step + 1, remaining), index);
+
+            if (position != longEnd && *position == index) {
+                Reduction::accumulate(sum, shortCoefficients[entry], longCoefficients[position - longIndexes]);
+            }
+        }
+
+        return Reduction::reduce(sum);
+    }
+
+    std::size_t first = 0;
+    std::size_t second = 0;
+
+    while (first < _firstCount && second < _secondCount) {
+        const int firstIndex = _firstIndexes[first];
+        const int secondIndex = _secondIndexes[second];
+
+        if (firstIndex == secondIndex) {
+            Reduction::accumulate(sum, _firstCoefficients[first], _secondCoefficients[second]);
+        }
+
+        first += static_cast<std::size_t>(firstIndex <= secondIndex);
+        second += static_cast<std::size_t>(secondIndex <= firstIndex);
+    }
+
+    return Reduction::reduce(sum);
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::tileNonZeroCount(const _CoefficientType *_tile, const std::size_t _count) noexcept {
+    std::size_t count = 0;
+
+    // Branchless, vectorized by the compiler on arithmetic types
+    for (std::size_t position = 0 ; position < _count ; position++) {
+        count += static_cast<std::size_t>(_tile[position] != _CoefficientType(0));
+    }
+
+    return count;
+}
+
+#if defined(OSM_X86_KERNELS)
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::dotAvx2(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector, Accumulator &_sum) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        __m256i vectorSum = _mm256_setzero_si256();
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_indexes + position));
+            const __m256i coefficients = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_coefficients + position));
+            const __m256i gathered = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), _vector, indexes, _mm256_set1_epi32(-1), 4);
+            vectorSum = _mm256_add_epi32(vectorSum, _mm256_mullo_epi32(coefficients, gathered));
+        }
+
+        _sum = horizontalSum(vectorSum);
+    } else {
+        __m256d vectorSum = _mm256_setzero_pd();
+
+        for ( ; position + 4 <= _count ; position += 4) {
+            const __m128i indexes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_indexes + position));
+            const __m256d gathered = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), _vector, indexes, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+            vectorSum = _mm256_fmadd_pd(_mm256_loadu_pd(_coefficients + position), gathered, vectorSum);
+        }
+
+        _sum = horizontalSum(vectorSum);
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::dotAvx512(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType *_vector, Accumulator &_sum) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        __m512i vectorSum = _mm512_setzero_si512();
+
+        for ( ; position + 16 <= _count ; position += 16) {
+            const __m512i indexes = _mm512_loadu_si512(_indexes + position);
+            const __m512i coefficients = _mm512_loadu_si512(_coefficients + position);
+            const __m512i gathered = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, indexes, _vector, 4);
+            vectorSum = _mm512_add_epi32(vectorSum, _mm512_mullo_epi32(coefficients, gathered));
+        }
+
+        _sum = horizontalSum(_mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xF, vectorSum, 0), _mm512_maskz_extracti64x4_epi64(0xF, vectorSum, 1)));
+    } else {
+        __m512d vectorSum = _mm512_setzero_pd();
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_indexes + position));
+            const __m512d gathered = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, indexes, _vector, 8);
+            vectorSum = _mm512_fmadd_pd(_mm512_loadu_pd(_coefficients + position), gathered, vectorSum);
+        }
+
+        _sum = horizontalSum(_mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, vectorSum, 0), _mm512_maskz_extractf64x4_pd(0xF, vectorSum, 1)));
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::scatterAddAvx512(const int *_indexes, const _CoefficientType *_coefficients, const std::size_t _count, const _CoefficientType _factor, _CoefficientType *_vector) noexcept {
+    std::size_t position = 0;
+
+    // The indexes of a chain are unique, so the lanes of a scatter never collide.
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        const __m512i factor = _mm512_set1_epi32(_factor);
+
+        for ( ; position + 16 <= _count ; position += 16) {
+            const __m512i indexes = _mm512_loadu_si512(_indexes + position);
+            const __m512i products = _mm512_mullo_epi32(factor, _mm512_loadu_si512(_coefficients + position));
+            const __m512i gathered = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, indexes, _vector, 4);
+            _mm512_i32scatter_epi32(_vector, indexes, _mm512_add_epi32(gathered, products), 4);
+        }
+    } else {
+        const __m512d factor = _mm512_set1_pd(_factor);
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            const __m256i indexes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_indexes + position));
+            const __m512d gathered = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, indexes, _vector, 8);
+            const __m512d sums = _mm512_fmadd_pd(factor, _mm512_loadu_pd(_coefficients + position), gathered);
+            _mm512_i32scatter_pd(_vector, indexes, sums, 8);
+        }
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::tileAddScaledAvx2(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        const __m256i factor = _mm256_set1_epi32(_factor);
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            const __m256i products = _mm256_mullo_epi32(factor, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_source + position)));
+            const __m256i sums = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(_target + position)), products);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(_target + position), sums);
+        }
+    } else {
+        const __m256d factor = _mm256_set1_pd(_factor);
+
+        for ( ; position + 4 <= _count ; position += 4) {
+            _mm256_storeu_pd(_target + position, _mm256_fmadd_pd(factor, _mm256_loadu_pd(_source + position), _mm256_loadu_pd(_target + position)));
+        }
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::tileAddScaledAvx512(const _CoefficientType _factor, const _CoefficientType *_source, const std::size_t _count, _CoefficientType *_target) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        const __m512i factor = _mm512_set1_epi32(_factor);
+
+        for ( ; position + 16 <= _count ; position += 16) {
+            const __m512i products = _mm512_mullo_epi32(factor, _mm512_loadu_si512(_source + position));
+            _mm512_storeu_si512(_target + position, _mm512_add_epi32(_mm512_loadu_si512(_target + position), products));
+        }
+    } else {
+        const __m512d factor = _mm512_set1_pd(_factor);
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            _mm512_storeu_pd(_target + position, _mm512_fmadd_pd(factor, _mm512_loadu_pd(_source + position), _mm512_loadu_pd(_target + position)));
+        }
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::tileDotAvx2(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count, Accumulator &_sum) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        __m256i vectorSum = _mm256_setzero_si256();
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_first + position));
+            const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_second + position));
+            vectorSum = _mm256_add_epi32(vectorSum, _mm256_mullo_epi32(first, second));
+        }
+
+        _sum = horizontalSum(vectorSum);
+    } else {
+        __m256d vectorSum = _mm256_setzero_pd();
+
+        for ( ; position + 4 <= _count ; position += 4) {
+            vectorSum = _mm256_fmadd_pd(_mm256_loadu_pd(_first + position), _mm256_loadu_pd(_second + position), vectorSum);
+        }
+
+        _sum = horizontalSum(vectorSum);
+    }
+
+    return position;
+}
+
+template <typename _CoefficientType>
+std::size_t SparseKernels<_CoefficientType>::tileDotAvx512(const _CoefficientType *_first, const _CoefficientType *_second, const std::size_t _count, Accumulator &_sum) noexcept {
+    std::size_t position = 0;
+
+    if constexpr (std::is_same<_CoefficientType, int>::value) {
+        __m512i vectorSum = _mm512_setzero_si512();
+
+        for ( ; position + 16 <= _count ; position += 16) {
+            vectorSum = _mm512_add_epi32(vectorSum, _mm512_mullo_epi32(_mm512_loadu_si512(_first + position), _mm512_loadu_si512(_second + position)));
+        }
+
+        _sum = horizontalSum(_mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xF, vectorSum, 0), _mm512_maskz_extracti64x4_epi64(0xF, vectorSum, 1)));
+    } else {
+        __m512d vectorSum = _mm512_setzero_pd();
+
+        for ( ; position + 8 <= _count ; position += 8) {
+            vectorSum = _mm512_fmadd_pd(_mm512_loadu_pd(_first + position), _mm512_loadu_pd(_second + position), vectorSum);
+        }
+
+        _sum = horizontalSum(_mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xF, vectorSum, 0), _mm512_maskz_extractf64x4_pd(0xF, vectorSum, 1)));
+    }
+
+    return position;
+}
+#endif
+}
+
+#endif
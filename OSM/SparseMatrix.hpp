@@ -13,29 +13,89 @@
 
 
 #include "Chain.hpp"
+#include "IndexSet.hpp"
+#include "Permutation.hpp"
+#include "PoolAllocator.hpp"
+#include "SparseAccumulator.hpp"
+#include "SparseKernels.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
 #include <stdint.h>
+#include <type_traits>
+#include <utility>
 
 
 namespace OSM {
+
+/**
+ * \brief A coefficient and its position, the input of OSM::SparseMatrix::fromTriplets.
+ *
+ * \tparam _CoefficientType The coefficient type.
+ */
+template <typename _CoefficientType>
+struct Triplet {
+    /** \brief The row index. */
+    int row;
+
+    /** \brief The column index. */
+    int column;
+
+    /** \brief The coefficient. */
+    _CoefficientType value;
+};
+
+/**
+ * \brief The support size and the squared norm of each chain, the result of OSM::SparseMatrix::chainStatistics.
+ *
+ * \tparam _CoefficientType The coefficient type.
+ */
+template <typename _CoefficientType>
+struct ChainStatistics {
+    /** \brief The number of stored coefficients of each chain. */
+    std::vector<std::size_t> sizes;
+
+    /** \brief The sum of the squared coefficients of each chain. */
+    std::vector<_CoefficientType> squaredNorms;
+};
     
 /**
  * \class SparseMatrix
  * \brief Vector<Map> implementation of sparse matrices.
  * 
  * The SparseMatrix class contains all algebraic functions that are related to matrix.
+ * Use OSM::COLUMN | OSM::ROW as chain type flag to index the matrix both by columns and by rows.
  * 
  * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
  * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
  * 
  * \author Fedyna K.
  * \version 0.1.0
  * \date 08/04/2024
  */
-template <typename _CoefficientType, int _ChainTypeFlag>
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
 class SparseMatrix {
 
 public:
-    typedef Chain<_CoefficientType, _ChainTypeFlag> MatrixChain;
+    typedef Chain<_CoefficientType, _ChainTypeFlag, _StorageType> MatrixChain;
+    typedef ChainView<_CoefficientType, _ChainTypeFlag, _StorageType> MatrixChainView;
+
+    /** \brief The type returned by getColumn, a view on the stored column for column-based matrices, a new column otherwise. */
+    typedef typename std::conditional<
+        _ChainTypeFlag == COLUMN,
+        ChainView<_CoefficientType, COLUMN, _StorageType>,
+        Chain<_CoefficientType, COLUMN, _StorageType>
+    >::type ConstColumn;
+
+    /** \brief The type returned by getRow, a view on the stored row for row-based matrices, a new row otherwise. */
+    typedef typename std::conditional<
+        _ChainTypeFlag == ROW,
+        ChainView<_CoefficientType, ROW, _StorageType>,
+        Chain<_CoefficientType, ROW, _StorageType>
+    >::type ConstRow;
+
     typedef typename std::vector<MatrixChain>::iterator iterator;
     typedef typename std::vector<MatrixChain>::const_iterator const_iterator;
     typedef typename std::vector<MatrixChain>::reverse_iterator reverse_iterator;
@@ -46,10 +106,28 @@ private:
     std::vector<MatrixChain> chains;
 
     /** \brief A vector of int containing state of each columns. */
-    std::vector<uint64_t> chainsStates;
+    mutable std::vector<uint64_t> chainsStates;
 
     /** \brief Stores all non empty chain indexes in order to implement iterators. */
-    std::vector<int> nonEmptyChainsIndexes;
+    mutable std::vector<int> nonEmptyChainsIndexes;
+
+    /** \brief The position of each chain in nonEmptyChainsIndexes, -1 for empty chains. */
+    mutable std::vector<int> nonEmptyChainsPositions;
+
+    /** \brief Whether chain references were handed out, the chain states being then rescanned before each use. */
+    bool chainsExposed;
+
+    /** \brief The number of rows of the matrix. */
+    int rowCount;
+
+    /** \brief The number of columns of the matrix. */
+    int columnCount;
+
+    /** \brief The pool used to process chains in parallel, null for sequential processing. */
+    ThreadPool *threadPool;
+
+    /** \brief The matrix stored with the other chain type, computed on demand and dropped by every mutation. */
+    mutable std::shared_ptr<SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>> reorientedCache;
 
 public:
     /**
@@ -109,6 +187,15 @@ public:
      */
     SparseMatrix(const SparseMatrix &_otherToCopy);
 
+    /**
+     * \brief Create new SparseMatrix object.
+     * 
+     * Move constructor, the resulting matrix takes over the chains of the passed matrix, which is left as a 0x0 matrix.
+     * 
+     * \param[in] _otherToMove The matrix we want to move.
+     */
+    SparseMatrix(SparseMatrix &&_otherToMove) noexcept;
+
     /**
      * \brief Assign to other matrix.
      * 
@@ -130,6 +217,36 @@ public:
      */
     SparseMatrix& operator=(const SparseMatrix &_otherToCopy);
 
+    /**
+     * \brief Move assign to other matrix.
+     * 
+     * Takes over the chains of the other matrix, which is left as a 0x0 matrix.
+     * 
+     * \param[in] _otherToMove The matrix we want to move.
+     * 
+     * \return The reference to the modified matrix.
+     */
+    SparseMatrix& operator=(SparseMatrix &&_otherToMove) noexcept;
+
+    /**
+     * \brief Builds a matrix from (row, column, value) triplets.
+     * 
+     * The triplets are sorted by chain index then by index in the chain with a least significant digit radix sort,
+     * each pass counting and scattering contiguous blocks of triplets in parallel. Duplicate positions are summed and
+     * null sums dropped, then every chain storage is reserved at its final size and filled in order, so no chain grows
+     * or rehashes during the construction.
+     * 
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _triplets The triplets, in any order.
+     * \param[in] _threadPool The pool used for the construction and set on the matrix, null for sequential processing.
+     * 
+     * \return The matrix.
+     * 
+     * \throws std::out_of_range If a triplet is out of the matrix.
+     */
+    static SparseMatrix fromTriplets(const int _rowCount, const int _columnCount, const std::vector<Triplet<_CoefficientType>> &_triplets, ThreadPool *_threadPool = nullptr);
+
     /**
      * \brief Adds two matrices together.
      * 
@@ -150,8 +267,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix operator+(const SparseMatrix<_CT, _CTF> &_first, const SparseMatrix<_CT, _CTF> &_second);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator+(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second);
 
     /**
      * \brief Substracts two matrices together.
@@ -173,8 +290,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix operator-(const SparseMatrix<_CT, _CTF> &_first, const SparseMatrix<_CT, _CTF> &_second);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator-(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second);
 
     /**
      * \brief Apply factor on each coefficients.
@@ -192,8 +309,8 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix operator*(const int _lambda, const SparseMatrix<_CT, _CTF> &_matrix);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator*(const int _lambda, const SparseMatrix<_CT, _CTF, _ST> &_matrix);
 
     /**
      * \brief Apply factor on each coefficients.
@@ -211,17 +328,23 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix operator*(const SparseMatrix<_CT, _CTF> &_matrix, const int _lambda);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator*(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const int _lambda);
 
     /**
      * \brief Perform matrix multiplication between two chains.
      * 
      * Generate a column-based matrix from the matrix multiplication and return it.
+     * The accumulation order follows the operands chain type flags, no operand is transposed:
+     * - column times column accumulates the first matrix columns into each result column (Gustavson),
+     * - column times row expands the outer products and compresses them per result column,
+     * - row times column computes the dot products between non empty chains,
+     * - row times row accumulates the result rows and scatters them into columns.
      * 
      * \pre The matrix have the same coefficent type.
      * 
      * \warning Will raise an error if the two chains are not the same coefficient type.
+     * \warning Will raise an error if the first matrix column count is not the second matrix row count.
      * 
      * \param[in] _first The first matrix.
      * \param[in] _second The second matrix.
@@ -229,22 +352,29 @@ public:
      * \return The result of the matrix multiplication, column-based.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::SparseAccumulator \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix<_CT, COLUMN> operator*(const SparseMatrix<_CT, _CTF> &_first, const SparseMatrix<_CT, _CTF> &_second);
+    template <typename _CT, int _CTF1, int _CTF2, typename _ST>
+    friend SparseMatrix<_CT, COLUMN, _ST> operator*(const SparseMatrix<_CT, _CTF1, _ST> &_first, const SparseMatrix<_CT, _CTF2, _ST> &_second);
 
     /**
      * \brief Perform matrix multiplication between two chains.
      * 
      * Generate a line-based matrix from the matrix multiplication and return it.
+     * The accumulation order follows the operands chain type flags, no operand is transposed:
+     * - row times row accumulates the second matrix rows into each result row (Gustavson),
+     * - column times row expands the outer products and compresses them per result row,
+     * - row times column computes the dot products between non empty chains,
+     * - column times column accumulates the result columns and scatters them into rows.
      * 
      * \pre The matrix have the same coefficent type.
      * 
      * \warning Will raise an error if the two chains are not the same coefficient type.
+     * \warning Will raise an error if the first matrix column count is not the second matrix row count.
      * 
      * \param[in] _first The first matrix.
      * \param[in] _second The second matrix.
@@ -252,13 +382,14 @@ public:
      * \return The result of the matrix multiplication, line-based.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::SparseAccumulator \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    friend SparseMatrix<_CT, ROW> operator%(const SparseMatrix<_CT, _CTF> &_first, const SparseMatrix<_CT, _CTF> &_second);
+    template <typename _CT, int _CTF1, int _CTF2, typename _ST>
+    friend SparseMatrix<_CT, ROW, _ST> operator%(const SparseMatrix<_CT, _CTF1, _ST> &_first, const SparseMatrix<_CT, _CTF2, _ST> &_second);
 
     /**
      * \brief Add a matrix and assign.
@@ -334,30 +465,34 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT, int _CTF>
-    SparseMatrix& operator*=(const SparseMatrix<_CT, _CTF> &_other);
+    template <int _CTF>
+    SparseMatrix& operator*=(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other);
 
     /**
      * \brief Get a chain from the matrix.
      * 
      * \warning The matrix will perform boundary check.
+     * \warning The view is invalidated by any modification of the chain.
      * 
      * \param[in] _index The coefficient index.
      * 
-     * \return The chain stored at given index.
+     * \return A view on the chain stored at given index.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainView \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    MatrixChain operator[](const int _index) const;
+    MatrixChainView operator[](const int _index) const;
 
     /**
      * \brief Set a chain from the matrix.
      * 
      * \warning The matrix will perform boundary check.
+     * \warning Once a reference is handed out, the chain states are rescanned before each operation reading them,
+     * since the chain may be written at any time. Call commitChains when the references are no longer written.
      * 
      * \param[in] _index The coefficient index.
      * 
@@ -374,7 +509,7 @@ public:
     /**
      * \brief Get a column from the matrix, even if matrix is a row-chain matrix.
      * 
-     * \note For column-chain matrixes, it is equivalent to operator[]. 
+     * \note For column-chain matrixes, it is equivalent to operator[] and returns a view, a new column is built otherwise.
      * 
      * \warning The matrix will perform boundary check.
      * 
@@ -383,18 +518,18 @@ public:
      * \return The column stored at given index.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainView \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 17/04/2024
      */
-    template <typename _CT>
-    Chain<_CT, COLUMN> getColumn(const int _index) const;
+    ConstColumn getColumn(const int _index) const;
 
     /**
      * \brief Get a row from the matrix, even if matrix is a row-chain matrix.
      * 
-     * \note For row-chain matrixes, it is equivalent to operator[]. 
+     * \note For row-chain matrixes, it is equivalent to operator[] and returns a view, a new row is built otherwise.
      * 
      * \warning The matrix will perform boundary check.
      * 
@@ -403,13 +538,13 @@ public:
      * \return The row stored at given index.
      * 
      * \see \link OSM::Chain \endlink
+     * \see \link OSM::ChainView \endlink
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 17/04/2024
      */
-    template <typename _CT>
-    Chain<_CT, ROW> getRow(const int _index) const;
+    ConstRow getRow(const int _index) const;
 
     /**
      * \brief Set a column from the matrix, even if matrix is a row-chain matrix.
@@ -417,7 +552,7 @@ public:
      * \warning The matrix will perform boundary check.
      * 
      * \param[in] _index The coefficient index.
-     * \param[in] _chain The new column.
+     * \param[in] _chain The new column, or a view on it.
      * 
      * \see \link OSM::Chain \endlink
      * 
@@ -425,8 +560,7 @@ public:
      * \version 0.1.0
      * \date 17/04/2024
      */
-    template <typename _CT>
-    void setColumn(const int _index, const Chain<_CT, COLUMN> &_chain);
+    void setColumn(const int _index, const ChainView<_CoefficientType, COLUMN, _StorageType> &_chain);
 
     /**
      * \brief Set a row from the matrix, even if matrix is a row-chain matrix.
@@ -434,7 +568,7 @@ public:
      * \warning The matrix will perform boundary check.
      * 
      * \param[in] _index The coefficient index.
-     * \param[in] _chain The new row.
+     * \param[in] _chain The new row, or a view on it.
      * 
      * \see \link OSM::Chain \endlink
      * 
@@ -442,13 +576,30 @@ public:
      * \version 0.1.0
      * \date 17/04/2024
      */
-    template <typename _CT>
-    void setRow(const int _index, const Chain<_CT, ROW> &_chain);
+    void setRow(const int _index, const ChainView<_CoefficientType, ROW, _StorageType> &_chain);
+
+    /**
+     * \brief Add a scaled chain of the matrix to another one.
+     * 
+     * Fused `chain[_destination] += _lambda * chain[_source]` on the matrix chains (columns of a column-based matrix,
+     * rows of a row-based one), the elementary operation of the column reductions.
+     * Performed in a single merge, without any temporary chain, entries cancelling to zero are dropped.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _destination The index of the modified chain.
+     * \param[in] _lambda The factor applied to the source chain.
+     * \param[in] _source The index of the added chain, may be the destination.
+     * 
+     * \see \link OSM::Chain::addScaled \endlink
+     */
+    void addScaledChain(const int _destination, const _CoefficientType _lambda, const int _source);
 
     /**
      * \brief Get a submatrix from the matrix.
      * 
      * Removes all indexes provided in the vector from the matrix and returns it.
+     * Both the rows and the columns with those indexes are removed, the remaining indexes are shifted.
      * 
      * \note Will return a copy of the matrix if given vector is empty.
      * \note The submatrix will be rectangular.
@@ -465,17 +616,20 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT>
-    friend SparseMatrix<_CT> operator/(const SparseMatrix<_CT> &_matrix, const std::vector<int> &_indexes);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const std::vector<int> &_indexes);
 
     /**
      * \brief Get a submatrix from the matrix.
      * 
      * Removes all indexes provided in the vector from the matrix and returns it.
+     * Both the rows and the columns with those indexes are removed, the remaining indexes are shifted.
      * 
      * \note Will return a copy of the matrix if given vector is empty.
      * \note The submatrix will be rectangular.
      * 
+     * \warning The indexes array must be terminated by a negative index.
+     * 
      * \param[in] _matrix The matrix to process.
      * \param[in] _indexes The indexes to remove.
      * 
@@ -488,13 +642,31 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CT>
-    friend SparseMatrix<_CT> operator/(const SparseMatrix<_CT> &_matrix, const int *_indexes);
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const int *_indexes);
+
+    /**
+     * \brief Get a submatrix from the matrix.
+     * 
+     * Removes the rows and the columns with the indexes of the set, the remaining indexes are shifted.
+     * Only the remaining chains are copied, each in a single pass, in parallel if the matrix has a pool.
+     * 
+     * \param[in] _matrix The matrix to process.
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return A new matrix representing the result.
+     * 
+     * \see \link OSM::SparseMatrix \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    template <typename _CT, int _CTF, typename _ST>
+    friend SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const IndexSet &_indexes);
 
     /**
      * \brief Get a submatrix from the matrix and assign.
      * 
      * Removes all indexes provided in the vector from the matrix and returns it.
+     * Both the rows and the columns with those indexes are removed, the remaining indexes are shifted.
      * 
      * \note Will not alter the matrix if given vector is empty.
      * 
@@ -515,9 +687,12 @@ public:
      * \brief Get a submatrix from the matrix and assign.
      * 
      * Removes all indexes provided in the vector from the matrix and returns it.
+     * Both the rows and the columns with those indexes are removed, the remaining indexes are shifted.
      * 
      * \note Will not alter the matrix if given vector is empty.
      * 
+     * \warning The indexes array must be terminated by a negative index.
+     * 
      * \param[in] _indexes The indexes to remove.
      * 
      * \return The modified matrix representing the result.
@@ -531,10 +706,79 @@ public:
      */
     SparseMatrix& operator/=(const int *_indexes);
 
+    /**
+     * \brief Get a submatrix from the matrix and assign.
+     * 
+     * Removes the rows and the columns with the indexes of the set, the remaining indexes are shifted.
+     * The index remap is given by the set, each remaining chain is compacted in a single pass, in parallel if the
+     * matrix has a pool.
+     * 
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return The modified matrix representing the result.
+     * 
+     * \see \link OSM::SparseMatrix \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    SparseMatrix& operator/=(const IndexSet &_indexes);
+
+    /**
+     * \brief Restricts the matrix to a set of indexes.
+     * 
+     * Keeps the rows and the columns with the indexes of the set only, renumbered among them, for instance
+     * to restrict a boundary matrix to a subcomplex.
+     * 
+     * \param[in] _indexes The indexes to keep.
+     * 
+     * \return A new matrix representing the result.
+     * 
+     * \see \link OSM::SparseMatrix \endlink
+     * \see \link OSM::IndexSet \endlink
+     */
+    SparseMatrix restriction(const IndexSet &_indexes) const;
+
+    /**
+     * \brief Permutes the rows and the columns of the matrix.
+     * 
+     * Each chain is copied once to its new index and its entries are renumbered and sorted again, in parallel when
+     * the matrix has a thread pool. Row i of the matrix is row _rows(i) of the result, and so for the columns.
+     * 
+     * \warning Will raise an error if the permutation sizes are not the row and column counts.
+     * 
+     * \param[in] _rows The permutation of the rows.
+     * \param[in] _columns The permutation of the columns.
+     * 
+     * \return A new matrix representing the result.
+     * 
+     * \see \link OSM::Permutation \endlink
+     */
+    SparseMatrix permuted(const Permutation &_rows, const Permutation &_columns) const;
+
+    /**
+     * \brief Gives back the memory left unused by cancellations.
+     * 
+     * Every chain storage is shrunk to its size, in parallel when the matrix has a thread pool, the chain states are
+     * rebuilt and the blocks cached by the OSM::ChainPool are released.
+     * 
+     * \see \link OSM::ChainPool \endlink
+     */
+    void shrinkToFit();
+
+    /**
+     * \brief Declares that the chain references and iterators handed out so far will no longer be written.
+     * 
+     * Until then, every operation reading the empty and non empty chains rescans them, and const operations
+     * update the matrix internal state, so they must not run concurrently.
+     * 
+     * \see \link OSM::SparseMatrix::operator[] \endlink
+     */
+    void commitChains();
+
     /**
      * \brief Iterator to the beginning of the chains.
      * 
      * \warning The chains are stored in a FIFO order for speed reason.
+     * \warning Chains written through the iterator are tracked as through operator[], until commitChains is called.
      * 
      * \return The iterator to the beginning of the chains.
      * 
@@ -771,9 +1015,2562 @@ public:
      * \version 0.1.0
      * \date 08/04/2024
      */
-    inline SparseMatrix transpose();
+    inline SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> transpose() const;
+
+    /**
+     * \brief Get the number of rows of the matrix.
+     * 
+     * \return The number of rows.
+     * 
+     * \see \link OSM::SparseMatrix \endlink
+     */
+    inline int getRowCount() const noexcept;
+
+    /**
+     * \brief Get the number of columns of the matrix.
+     * 
+     * \return The number of columns.
+     * 
+     * \see \link OSM::SparseMatrix \endlink
+     */
+    inline int getColumnCount() const noexcept;
+
+    /**
+     * \brief Set the thread pool used by the matrix operations.
+     * 
+     * Chain-wise operations (addition, substraction, factor and products) split the chains between the pool workers.
+     * The chains are grouped by number of coefficients, so that skewed chain sizes stay balanced.
+     * 
+     * \note The pool is shared with the matrices copied from or computed from this matrix.
+     * 
+     * \warning The pool must outlive the matrix, or be unset before being destroyed.
+     * 
+     * \param[in] _threadPool The pool to use, null for sequential processing.
+     * 
+     * \see \link OSM::ThreadPool \endlink
+     */
+    inline void setThreadPool(ThreadPool *_threadPool) noexcept;
+
+    /**
+     * \brief Get the thread pool used by the matrix operations.
+     * 
+     * \return The pool, null if the matrix is processed sequentially.
+     * 
+     * \see \link OSM::ThreadPool \endlink
+     */
+    inline ThreadPool* getThreadPool() const noexcept;
+
+    /**
+     * \brief Calls a function on each non empty chain, by increasing index.
+     * 
+     * Only the words of the chain states with set bits are visited, so the cost is proportional to the number of non
+     * empty chains plus the number of chains divided by 64. Chains emptied through a reference returned by operator[]
+     * are skipped.
+     * 
+     * \param[in] _function The function, called with the chain index and the chain.
+     */
+    template <typename _Function>
+    void forEachNonEmpty(const _Function &_function) const;
+
+    /**
+     * \brief Calls a function on each non empty chain, by increasing index, allowing to modify it.
+     * 
+     * The state of each chain is updated after the call, so the function may empty the chain it is given. It must
+     * not modify the other chains of the matrix.
+     * 
+     * \param[in] _function The function, called with the chain index and the chain.
+     */
+    template <typename _Function>
+    void forEachNonEmpty(const _Function &_function);
+
+    /**
+     * \brief Multiplies the matrix with a dense vector.
+     * 
+     * Row-based matrices compute one gathered dot product per row, column-based matrices add each scaled column to
+     * the result. Both are processed in parallel on the matrix pool by blocks of rows, the columns of contiguous
+     * storages being split by binary search between the blocks.
+     * 
+     * \warning Will raise an error if the vector size is not the column count.
+     * 
+     * \param[in] _vector The dense vector.
+     * 
+     * \return The dense product, of size the row count.
+     * 
+     * \see \link OSM::SparseKernels \endlink
+     */
+    std::vector<_CoefficientType> multiply(const std::vector<_CoefficientType> &_vector) const;
+
+    /**
+     * \brief Multiplies the matrix with a dense block of vectors.
+     * 
+     * The block is stored row-major, entry v of row i being at i * _vectorCount + v, and so is the result.
+     * 
+     * \warning Will raise an error if the block size is not the column count times the vector count.
+     * 
+     * \param[in] _block The dense block, of columnCount rows.
+     * \param[in] _vectorCount The number of vectors of the block.
+     * 
+     * \return The dense product, of rowCount rows.
+     * 
+     * \see \link OSM::SparseKernels \endlink
+     */
+    std::vector<_CoefficientType> multiply(const std::vector<_CoefficientType> &_block, const int _vectorCount) const;
+
+    /**
+     * \brief Computes the dot products of many pairs of chains.
+     * 
+     * Pair (i, j) gives the dot product of chain i of the matrix with chain j of _other, both indexed over the same
+     * entries: with rows of the matrix and columns of _other, it is coefficient (i, j) of their product.
+     * 
+     * The pairs are grouped by their first chain and the groups processed in parallel on the matrix pool. A chain
+     * shared by several pairs is scattered once into a dense vector of the worker, each dot product is then a gathered
+     * dot product of the second chain. A chain used once goes through the dot product of the storage, the sorted
+     * intersection of OSM::SparseKernels::intersectionDot for OSM::SortedStorage.
+     * 
+     * \warning Will raise an error if the chains of both matrices do not have the same size.
+     * \warning Will raise an error if a chain index is out of range.
+     * 
+     * \param[in] _other The matrix of the second chains.
+     * \param[in] _pairs The chain index in the matrix and the chain index in _other of each dot product.
+     * 
+     * \return The dot products, in the order of the pairs.
+     * 
+     * \see \link OSM::SparseKernels \endlink
+     */
+    template <int _CTF>
+    std::vector<_CoefficientType> dots(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other, const std::vector<std::pair<int, int>> &_pairs) const;
+
+    /**
+     * \brief Computes the number of stored coefficients and the squared norm of every chain.
+     * 
+     * A single pass over the chains, in parallel on the matrix pool.
+     * 
+     * \return The size and the squared norm of every chain, null for empty chains.
+     * 
+     * \see \link OSM::ChainStatistics \endlink
+     */
+    ChainStatistics<_CoefficientType> chainStatistics() const;
+
+    /**
+     * \brief Get the same matrix stored with the other chain type.
+     * 
+     * Two-pass counting sort: the result chains are sized first, then filled by increasing index. With a thread pool
+     * and a contiguous storage, the result chains are split in blocks, each block finding its entries in every chain
+     * by binary search, so both passes run in parallel without sharing any output chain.
+     * 
+     * \return The same matrix, with the chain type flag changed.
+     * 
+     * \see \link OSM::SparseMatrix::getReoriented \endlink
+     */
+    SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> reoriented() const;
+
+    /**
+     * \brief Get the same matrix stored with the other chain type, computed once and cached.
+     * 
+     * The cache is shared by copies and dropped by every modification of the matrix, so repeated coboundary
+     * computations on an unchanged boundary matrix pay for a single reorientation.
+     * 
+     * While mutable chain references or iterators are handed out, a chain may be written at any time, so the
+     * reorientation is computed again at each call, in place of the previous one, until commitChains is called.
+     * 
+     * \warning The reference is invalidated by the next modification of the matrix, and the cache is filled without
+     * synchronization: do not call it concurrently on a matrix whose cache is empty or whose chains are handed out.
+     * 
+     * \return The cached reoriented matrix.
+     * 
+     * \see \link OSM::SparseMatrix::reoriented \endlink
+     */
+    const SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>& getReoriented() const;
+
+    /**
+     * \brief Whether the reoriented matrix is currently cached.
+     * 
+     * \return True if getReoriented would not compute anything, false while chain references are handed out.
+     */
+    inline bool isReorientedCached() const noexcept;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class SparseMatrix;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ReorientedView;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class ImplicitMatrix;
+
+    template <typename _CT, typename _ST, typename _I>
+    friend class ColumnReduction;
+
+    template <typename _ST>
+    friend class SmithNormalForm;
+
+    template <typename _CT, int _CTF>
+    friend class MappedMatrix;
+
+    template <typename _CT, int _CTF, typename _ST>
+    friend class DistributedMatrix;
+
+    template <typename _CT, typename _ST>
+    friend class DistributedReduction;
+
+private:
+    /**
+     * \brief Update the state of a chain after it was modified.
+     * 
+     * Constant time: an emptied chain is swapped with the last of the non empty chain indexes.
+     * 
+     * \param[in] _index The chain index.
+     * \param[in] _isEmpty Whether the chain is now empty.
+     */
+    void updateChainState(const int _index, const bool _isEmpty);
+
+    /**
+     * \brief Throws if the chain index is out of the matrix.
+     * 
+     * \param[in] _index The chain index.
+     */
+    void checkChainIndex(const int _index) const;
+
+    /**
+     * \brief Recompute the chain states from the chains.
+     */
+    void rebuildChainStates();
+
+    /**
+     * \brief Recompute the chain states if chain references were handed out.
+     * 
+     * Called before reading the chain states, since chains may have been written through the references.
+     */
+    void synchronizeChainStates() const;
+
+    /**
+     * \brief Recompute the chain states from the chains, leaving the reoriented matrix cache untouched.
+     */
+    void scanChainStates() const;
+
+    /**
+     * \brief Multiplies the matrix with a row-major dense block.
+     * 
+     * \param[in] _block The dense block, of columnCount rows.
+     * \param[in] _vectorCount The number of vectors of the block.
+     * \param[out] _result The null initialized product, of rowCount rows.
+     */
+    void multiplyBlock(const _CoefficientType *_block, const int _vectorCount, _CoefficientType *_result) const;
+
+    /**
+     * \brief Get the flat arrays of a chain.
+     * 
+     * \param[in] _chain The chain.
+     * \param[out] _indexes The scratch indexes, filled if the storage is not contiguous.
+     * \param[out] _coefficients The scratch coefficients, filled if the storage is not contiguous.
+     * 
+     * \return The indexes and the coefficients of the chain.
+     */
+    static std::pair<const int*, const _CoefficientType*> chainArrays(const MatrixChain &_chain, std::vector<int> &_indexes, std::vector<_CoefficientType> &_coefficients);
+
+    /**
+     * \brief Copies the chains into a matrix with renumbered indexes.
+     * 
+     * \param[in] _chainMap The new index of each chain, -1 to drop it.
+     * \param[in] _entryMap The new index of each chain entry, -1 to drop it.
+     * \param[in] _rowCount The new row count.
+     * \param[in] _columnCount The new column count.
+     * \param[in] _increasing Whether the entry map is increasing, otherwise the entries are sorted again (default is true).
+     * 
+     * \return The renumbered matrix.
+     */
+    template <typename _ChainMap, typename _EntryMap>
+    SparseMatrix renumbered(const _ChainMap &_chainMap, const _EntryMap &_entryMap, const int _rowCount, const int _columnCount, const bool _increasing = true) const;
+
+    /**
+     * \brief Gustavson product kernel.
+     * 
+     * Each output chain is the linear combination of the inner chains given by the entries of the outer chain
+     * with the same index, accumulated in a OSM::SparseAccumulator.
+     * 
+     * \param[in] _inner The chains that are combined.
+     * \param[in] _outer The chains giving the combination coefficients.
+     * \param[out] _output The result chains, one per outer chain.
+     * \param[in] _outputSize The size of the result chains.
+     * \param[in] _pool The pool computing the output chains in parallel, may be null.
+     */
+    template <typename _InnerChain, typename _OuterChain>
+    static void gustavsonKernel(const std::vector<_InnerChain> &_inner, const std::vector<_OuterChain> &_outer, std::vector<MatrixChain> &_output, const int _outputSize, ThreadPool *_pool);
+
+    /**
+     * \brief Outer product kernel.
+     * 
+     * For each shared index, every entry of the entry chain is sent to each output chain given by the target chain.
+     * The expanded entries are bucketed per output chain with a counting sort, then compressed.
+     * 
+     * \param[in] _targets The chains giving the output chain indexes.
+     * \param[in] _entries The chains giving the output entries.
+     * \param[out] _output The result chains.
+     * \param[in] _outputSize The size of the result chains.
+     * \param[in] _pool The pool compressing the output chains in parallel, may be null.
+     */
+    template <typename _TargetChain, typename _EntryChain>
+    static void outerProductKernel(const std::vector<_TargetChain> &_targets, const std::vector<_EntryChain> &_entries, std::vector<MatrixChain> &_output, const int _outputSize, ThreadPool *_pool);
+
+    /**
+     * \brief Inner product kernel.
+     * 
+     * Each output coefficient is the dot product between a row and a column, only non empty chains are visited.
+     * 
+     * \param[in] _rows The row chains.
+     * \param[in] _columns The column chains.
+     * \param[out] _output The result chains, indexed by column if the result is column-based, by row otherwise.
+     * \param[in] _pool The pool computing the output chains in parallel, may be null.
+     */
+    template <typename _RowChain, typename _ColumnChain>
+    static void innerProductKernel(const std::vector<_RowChain> &_rows, const std::vector<_ColumnChain> &_columns, std::vector<MatrixChain> &_output, ThreadPool *_pool);
 };
 
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::SparseMatrix() : SparseMatrix(128, 128) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::SparseMatrix(const int _rowCount, const int _columnCount) :
+    chains(_ChainTypeFlag == COLUMN ? _columnCount : _rowCount, MatrixChain(_ChainTypeFlag == COLUMN ? _rowCount : _columnCount)),
+    chainsStates(((_ChainTypeFlag == COLUMN ? _columnCount : _rowCount) + 63) / 64, 0),
+    nonEmptyChainsPositions(_ChainTypeFlag == COLUMN ? _columnCount : _rowCount, -1),
+    chainsExposed(false),
+    rowCount(_rowCount),
+    columnCount(_columnCount),
+    threadPool(nullptr) {}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::SparseMatrix(const SparseMatrix &_otherToCopy) :
+    chains(_otherToCopy.chains),
+    chainsExposed(false),
+    rowCount(_otherToCopy.rowCount),
+    columnCount(_otherToCopy.columnCount),
+    threadPool(_otherToCopy.threadPool) {
+    _otherToCopy.synchronizeChainStates();
+
+    chainsStates = _otherToCopy.chainsStates;
+    nonEmptyChainsIndexes = _otherToCopy.nonEmptyChainsIndexes;
+    nonEmptyChainsPositions = _otherToCopy.nonEmptyChainsPositions;
+
+    if (!_otherToCopy.chainsExposed) {
+        reorientedCache = _otherToCopy.reorientedCache;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(const SparseMatrix &_otherToCopy) {
+    _otherToCopy.synchronizeChainStates();
+
+    // References to the chains of this matrix stay valid, so chainsExposed is kept.
+    chains = _otherToCopy.chains;
+    chainsStates = _otherToCopy.chainsStates;
+    nonEmptyChainsIndexes = _otherToCopy.nonEmptyChainsIndexes;
+    nonEmptyChainsPositions = _otherToCopy.nonEmptyChainsPositions;
+    rowCount = _otherToCopy.rowCount;
+    columnCount = _otherToCopy.columnCount;
+    threadPool = _otherToCopy.threadPool;
+    reorientedCache = _otherToCopy.chainsExposed ? nullptr : _otherToCopy.reorientedCache;
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::SparseMatrix(SparseMatrix &&_otherToMove) noexcept :
+    chains(std::move(_otherToMove.chains)),
+    chainsStates(std::move(_otherToMove.chainsStates)),
+    nonEmptyChainsIndexes(std::move(_otherToMove.nonEmptyChainsIndexes)),
+    nonEmptyChainsPositions(std::move(_otherToMove.nonEmptyChainsPositions)),
+    chainsExposed(_otherToMove.chainsExposed),
+    rowCount(_otherToMove.rowCount),
+    columnCount(_otherToMove.columnCount),
+    threadPool(_otherToMove.threadPool),
+    reorientedCache(std::move(_otherToMove.reorientedCache)) {
+    _otherToMove.chains.clear();
+    _otherToMove.chainsStates.clear();
+    _otherToMove.nonEmptyChainsIndexes.clear();
+    _otherToMove.nonEmptyChainsPositions.clear();
+    _otherToMove.rowCount = 0;
+    _otherToMove.columnCount = 0;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator=(SparseMatrix &&_otherToMove) noexcept {
+    if (&_otherToMove == this) {
+        return *this;
+    }
+
+    chains = std::move(_otherToMove.chains);
+    chainsStates = std::move(_otherToMove.chainsStates);
+    nonEmptyChainsIndexes = std::move(_otherToMove.nonEmptyChainsIndexes);
+    nonEmptyChainsPositions = std::move(_otherToMove.nonEmptyChainsPositions);
+    chainsExposed = _otherToMove.chainsExposed;
+    rowCount = _otherToMove.rowCount;
+    columnCount = _otherToMove.columnCount;
+    threadPool = _otherToMove.threadPool;
+    reorientedCache = std::move(_otherToMove.reorientedCache);
+
+    _otherToMove.chains.clear();
+    _otherToMove.chainsStates.clear();
+    _otherToMove.nonEmptyChainsIndexes.clear();
+    _otherToMove.nonEmptyChainsPositions.clear();
+    _otherToMove.rowCount = 0;
+    _otherToMove.columnCount = 0;
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::fromTriplets(const int _rowCount, const int _columnCount, const std::vector<Triplet<_CoefficientType>> &_triplets, ThreadPool *_threadPool) {
+    struct Entry {
+        uint64_t key;
+        _CoefficientType value;
+    };
+
+    constexpr int DIGIT_BITS = 11;
+    constexpr std::size_t DIGIT_COUNT = std::size_t(1) << DIGIT_BITS;
+
+    SparseMatrix result(_rowCount, _columnCount);
+    result.threadPool = _threadPool;
+
+    const std::size_t tripletCount = _triplets.size();
+    const int chainCount = result.chains.size();
+    const int chainSize = _ChainTypeFlag == COLUMN ? _rowCount : _columnCount;
+
+    int minorBits = 0;
+    while (minorBits < 31 && (int64_t(1) << minorBits) < chainSize) {
+        minorBits++;
+    }
+    int keyBits = minorBits;
+    while (keyBits - minorBits < 31 && (int64_t(1) << (keyBits - minorBits)) < chainCount) {
+        keyBits++;
+    }
+
+    // Each block of triplets is counted and scattered by one task, the blocks being in order the sort is stable.
+    const std::size_t blockCount = _threadPool == nullptr || tripletCount < ThreadPool::MINIMAL_TASK_WEIGHT ? 1 : std::min(_threadPool->size(), tripletCount / ThreadPool::MINIMAL_TASK_WEIGHT);
+    const auto forEachBlock = [&](const auto &_function) {
+        const ThreadPool::Job job = [&](const std::size_t _block, const std::size_t) {
+            _function(_block, _block * tripletCount / blockCount, (_block + 1) * tripletCount / blockCount);
+        };
+
+        if (blockCount == 1) {
+            job(0, 0);
+        } else {
+            _threadPool->run(blockCount, job);
+        }
+    };
+
+    std::vector<Entry> entries(tripletCount);
+    std::vector<Entry> sorted(tripletCount);
+
+    forEachBlock([&](const std::size_t, const std::size_t _begin, const std::size_t _end) {
+        for (std::size_t position = _begin ; position < _end ; position++) {
+            const Triplet<_CoefficientType> &triplet = _triplets[position];
+
+            if (triplet.row < 0 || triplet.row >= _rowCount || triplet.column < 0 || triplet.column >= _columnCount) {
+                throw std::out_of_range("Triplet index out of matrix bounds.");
+            }
+
+            const int major = _ChainTypeFlag == COLUMN ? triplet.column : triplet.row;
+            const int minor = _ChainTypeFlag == COLUMN ? triplet.row : triplet.column;
+
+            entries[position].key = uint64_t(major) << minorBits | uint64_t(minor);
+            entries[position].value = triplet.value;
+        }
+    });
+
+    std::vector<std::size_t> counts(blockCount * DIGIT_COUNT);
+
+    for (int shift = 0 ; shift < keyBits ; shift += DIGIT_BITS) {
+        std::fill(counts.begin(), counts.end(), 0);
+
+        forEachBlock([&](const std::size_t _block, const std::size_t _begin, const std::size_t _end) {
+            std::size_t *blockCounts = counts.data() + _block * DIGIT_COUNT;
+
+            for (std::size_t position = _begin ; position < _end ; position++) {
+                blockCounts[entries[position].key >> shift & (DIGIT_COUNT - 1)]++;
+            }
+        });
+
+        std::size_t offset = 0;
+        for (std::size_t digit = 0 ; digit < DIGIT_COUNT ; digit++) {
+            for (std::size_t block = 0 ; block < blockCount ; block++) {
+                const std::size_t count = counts[block * DIGIT_COUNT + digit];
+                counts[block * DIGIT_COUNT + digit] = offset;
+                offset += count;
+            }
+        }
+
+        forEachBlock([&](const std::size_t _block, const std::size_t _begin, const std::size_t _end) {
+            std::size_t *blockOffsets = counts.data() + _block * DIGIT_COUNT;
+
+            for (std::size_t position = _begin ; position < _end ; position++) {
+                sorted[blockOffsets[entries[position].key >> shift & (DIGIT_COUNT - 1)]++] = entries[position];
+            }
+        });
+
+        entries.swap(sorted);
+    }
+
+    sorted = std::vector<Entry>();
+
+    std::vector<std::size_t> starts(chainCount + 1);
+    std::vector<std::size_t> weights(chainCount);
+
+    for (int chain = 0 ; chain <= chainCount ; chain++) {
+        starts[chain] = std::lower_bound(entries.begin(), entries.end(), uint64_t(chain) << minorBits, [](const Entry &_entry, const uint64_t _key) {
+            return _entry.key < _key;
+        }) - entries.begin();
+    }
+    for (int chain = 0 ; chain < chainCount ; chain++) {
+        weights[chain] = starts[chain + 1] - starts[chain];
+    }
+
+    const uint64_t minorMask = (uint64_t(1) << minorBits) - 1;
+
+    ThreadPool::forEachWeighted(_threadPool, weights, [&](const std::size_t _chain, const std::size_t) {
+        // Duplicates are summed in place, the chain entries then span from its start to the write position.
+        std::size_t write = starts[_chain];
+
+        for (std::size_t read = starts[_chain] ; read < starts[_chain + 1] ; ) {
+            Entry combined = entries[read++];
+
+            while (read < starts[_chain + 1] && entries[read].key == combined.key) {
+                combined.value += entries[read++].value;
+            }
+
+            if (combined.value != _CoefficientType(0)) {
+                entries[write++] = combined;
+            }
+        }
+
+        _StorageType &storage = result.chains[_chain].chainData;
+        storage.reserve(write - starts[_chain]);
+
+        for (std::size_t position = starts[_chain] ; position < write ; position++) {
+            storage.append(entries[position].key & minorMask, entries[position].value);
+        }
+    });
+
+    result.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator+(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second) {
+    SparseMatrix<_CT, _CTF, _ST> result = _first;
+    result += _second;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator-(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second) {
+    SparseMatrix<_CT, _CTF, _ST> result = _first;
+    result -= _second;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator*(const int _lambda, const SparseMatrix<_CT, _CTF, _ST> &_matrix) {
+    SparseMatrix<_CT, _CTF, _ST> result = _matrix;
+    result *= _lambda;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator*(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const int _lambda) {
+    SparseMatrix<_CT, _CTF, _ST> result = _matrix;
+    result *= _lambda;
+
+    return result;
+}
+
+template <typename _CT, int _CTF1, int _CTF2, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const SparseMatrix<_CT, _CTF1, _ST> &_first, const SparseMatrix<_CT, _CTF2, _ST> &_second) {
+    if (_first.columnCount != _second.rowCount) {
+        throw std::invalid_argument("First matrix column count must match second matrix row count.");
+    }
+
+    if constexpr (_CTF1 == ROW && _CTF2 == ROW) {
+        return (_first % _second).reoriented();
+    } else {
+        SparseMatrix<_CT, COLUMN, _ST> result(_first.rowCount, _second.columnCount);
+        result.threadPool = _first.threadPool != nullptr ? _first.threadPool : _second.threadPool;
+
+        if constexpr (_CTF1 == COLUMN && _CTF2 == COLUMN) {
+            SparseMatrix<_CT, COLUMN, _ST>::gustavsonKernel(_first.chains, _second.chains, result.chains, _first.rowCount, result.threadPool);
+        } else if constexpr (_CTF1 == COLUMN && _CTF2 == ROW) {
+            SparseMatrix<_CT, COLUMN, _ST>::outerProductKernel(_second.chains, _first.chains, result.chains, _first.rowCount, result.threadPool);
+        } else {
+            SparseMatrix<_CT, COLUMN, _ST>::innerProductKernel(_first.chains, _second.chains, result.chains, result.threadPool);
+        }
+
+        result.rebuildChainStates();
+
+        return result;
+    }
+}
+
+template <typename _CT, int _CTF1, int _CTF2, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const SparseMatrix<_CT, _CTF1, _ST> &_first, const SparseMatrix<_CT, _CTF2, _ST> &_second) {
+    if (_first.columnCount != _second.rowCount) {
+        throw std::invalid_argument("First matrix column count must match second matrix row count.");
+    }
+
+    if constexpr (_CTF1 == COLUMN && _CTF2 == COLUMN) {
+        return (_first * _second).reoriented();
+    } else {
+        SparseMatrix<_CT, ROW, _ST> result(_first.rowCount, _second.columnCount);
+        result.threadPool = _first.threadPool != nullptr ? _first.threadPool : _second.threadPool;
+
+        if constexpr (_CTF1 == ROW && _CTF2 == ROW) {
+            SparseMatrix<_CT, ROW, _ST>::gustavsonKernel(_second.chains, _first.chains, result.chains, _second.columnCount, result.threadPool);
+        } else if constexpr (_CTF1 == COLUMN && _CTF2 == ROW) {
+            SparseMatrix<_CT, ROW, _ST>::outerProductKernel(_first.chains, _second.chains, result.chains, _second.columnCount, result.threadPool);
+        } else {
+            SparseMatrix<_CT, ROW, _ST>::innerProductKernel(_first.chains, _second.chains, result.chains, result.threadPool);
+        }
+
+        result.rebuildChainStates();
+
+        return result;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator+=(const SparseMatrix &_other) {
+    if (rowCount != _other.rowCount || columnCount != _other.columnCount) {
+        throw std::invalid_argument("Matrices must have the same dimensions.");
+    }
+
+    synchronizeChainStates();
+    _other.synchronizeChainStates();
+
+    const std::vector<int> otherIndexes = _other.nonEmptyChainsIndexes;
+    std::vector<std::size_t> weights(otherIndexes.size());
+
+    for (std::size_t item = 0 ; item < otherIndexes.size() ; item++) {
+        weights[item] = chains[otherIndexes[item]].size() + _other.chains[otherIndexes[item]].size();
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t) {
+        chains[otherIndexes[_item]] += _other.chains[otherIndexes[_item]];
+    });
+
+    for (int index : otherIndexes) {
+        updateChainState(index, chains[index].size() == 0);
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator-=(const SparseMatrix &_other) {
+    if (rowCount != _other.rowCount || columnCount != _other.columnCount) {
+        throw std::invalid_argument("Matrices must have the same dimensions.");
+    }
+
+    synchronizeChainStates();
+    _other.synchronizeChainStates();
+
+    const std::vector<int> otherIndexes = _other.nonEmptyChainsIndexes;
+    std::vector<std::size_t> weights(otherIndexes.size());
+
+    for (std::size_t item = 0 ; item < otherIndexes.size() ; item++) {
+        weights[item] = chains[otherIndexes[item]].size() + _other.chains[otherIndexes[item]].size();
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t) {
+        chains[otherIndexes[_item]] -= _other.chains[otherIndexes[_item]];
+    });
+
+    for (int index : otherIndexes) {
+        updateChainState(index, chains[index].size() == 0);
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator*=(const int _lambda) {
+    if (_lambda == 0) {
+        throw std::invalid_argument("Factor must be non zero.");
+    }
+
+    reorientedCache.reset();
+    synchronizeChainStates();
+
+    std::vector<std::size_t> weights(nonEmptyChainsIndexes.size());
+
+    for (std::size_t item = 0 ; item < nonEmptyChainsIndexes.size() ; item++) {
+        weights[item] = chains[nonEmptyChainsIndexes[item]].size();
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t) {
+        chains[nonEmptyChainsIndexes[_item]] *= _lambda;
+    });
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <int _CTF>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator*=(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other) {
+    if constexpr (_ChainTypeFlag == COLUMN) {
+        *this = *this * _other;
+    } else {
+        *this = *this % _other;
+    }
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::MatrixChainView SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) const {
+    checkChainIndex(_index);
+
+    return chains[_index];
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::MatrixChain& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator[](const int _index) {
+    checkChainIndex(_index);
+    reorientedCache.reset();
+    chainsExposed = true;
+
+    return chains[_index];
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::ConstColumn SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getColumn(const int _index) const {
+    if constexpr (_ChainTypeFlag == COLUMN) {
+        checkChainIndex(_index);
+
+        return chains[_index];
+    } else {
+        if (_index < 0 || _index >= columnCount) {
+            throw std::out_of_range("Column index out of matrix bounds.");
+        }
+
+        synchronizeChainStates();
+
+        Chain<_CoefficientType, COLUMN, _StorageType> column(rowCount);
+
+        for (int row = 0 ; row < rowCount ; row++) {
+            if ((chainsStates[row / 64] >> (row % 64) & 1) == 0) {
+                continue;
+            }
+
+            _CoefficientType coefficient = chains[row].chainData.get(_index);
+
+            if (coefficient != _CoefficientType(0)) {
+                column[row] = coefficient;
+            }
+        }
+
+        return column;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::ConstRow SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getRow(const int _index) const {
+    if constexpr (_ChainTypeFlag == ROW) {
+        checkChainIndex(_index);
+
+        return chains[_index];
+    } else {
+        if (_index < 0 || _index >= rowCount) {
+            throw std::out_of_range("Row index out of matrix bounds.");
+        }
+
+        synchronizeChainStates();
+
+        Chain<_CoefficientType, ROW, _StorageType> row(columnCount);
+
+        for (int column = 0 ; column < columnCount ; column++) {
+            if ((chainsStates[column / 64] >> (column % 64) & 1) == 0) {
+                continue;
+            }
+
+            _CoefficientType coefficient = chains[column].chainData.get(_index);
+
+            if (coefficient != _CoefficientType(0)) {
+                row[column] = coefficient;
+            }
+        }
+
+        return row;
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::setColumn(const int _index, const ChainView<_CoefficientType, COLUMN, _StorageType> &_chain) {
+    if constexpr (_ChainTypeFlag == COLUMN) {
+        checkChainIndex(_index);
+
+        chains[_index].chainData = *_chain.chainData;
+        chains[_index].upperBound = rowCount;
+        updateChainState(_index, _chain.size() == 0);
+    } else {
+        if (_index < 0 || _index >= columnCount) {
+            throw std::out_of_range("Column index out of matrix bounds.");
+        }
+
+        synchronizeChainStates();
+
+        const std::vector<int> rowIndexes = nonEmptyChainsIndexes;
+
+        for (int row : rowIndexes) {
+            chains[row].chainData.erase(_index);
+            updateChainState(row, chains[row].size() == 0);
+        }
+
+        for (typename ChainView<_CoefficientType, COLUMN, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+            checkChainIndex(it->first);
+
+            chains[it->first][_index] = it->second;
+            updateChainState(it->first, false);
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::setRow(const int _index, const ChainView<_CoefficientType, ROW, _StorageType> &_chain) {
+    if constexpr (_ChainTypeFlag == ROW) {
+        checkChainIndex(_index);
+
+        chains[_index].chainData = *_chain.chainData;
+        chains[_index].upperBound = columnCount;
+        updateChainState(_index, _chain.size() == 0);
+    } else {
+        if (_index < 0 || _index >= rowCount) {
+            throw std::out_of_range("Row index out of matrix bounds.");
+        }
+
+        synchronizeChainStates();
+
+        const std::vector<int> columnIndexes = nonEmptyChainsIndexes;
+
+        for (int column : columnIndexes) {
+            chains[column].chainData.erase(_index);
+            updateChainState(column, chains[column].size() == 0);
+        }
+
+        for (typename ChainView<_CoefficientType, ROW, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+            checkChainIndex(it->first);
+
+            chains[it->first][_index] = it->second;
+            updateChainState(it->first, false);
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::addScaledChain(const int _destination, const _CoefficientType _lambda, const int _source) {
+    checkChainIndex(_destination);
+    checkChainIndex(_source);
+
+    chains[_destination].chainData.addScaled(_lambda, chains[_source].chainData);
+    updateChainState(_destination, chains[_destination].size() == 0);
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const std::vector<int> &_indexes) {
+    SparseMatrix<_CT, _CTF, _ST> result = _matrix;
+    result /= _indexes;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const int *_indexes) {
+    SparseMatrix<_CT, _CTF, _ST> result = _matrix;
+    result /= _indexes;
+
+    return result;
+}
+
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, _CTF, _ST> operator/(const SparseMatrix<_CT, _CTF, _ST> &_matrix, const IndexSet &_indexes) {
+    if constexpr (_CTF == (COLUMN | ROW)) {
+        SparseMatrix<_CT, _CTF, _ST> result = _matrix;
+        result /= _indexes;
+
+        return result;
+    } else {
+        return _matrix.renumbered(
+            [&_indexes](const int _index) { return _indexes.removedIndex(_index); },
+            [&_indexes](const int _index) { return _indexes.removedIndex(_index); },
+            _matrix.rowCount - _indexes.rank(_matrix.rowCount),
+            _matrix.columnCount - _indexes.rank(_matrix.columnCount)
+        );
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const std::vector<int> &_indexes) {
+    return *this /= IndexSet(std::max(rowCount, columnCount), _indexes);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const int *_indexes) {
+    std::vector<int> indexes;
+
+    for (const int *index = _indexes ; *index >= 0 ; index++) {
+        indexes.push_back(*index);
+    }
+
+    return *this /= indexes;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::operator/=(const IndexSet &_indexes) {
+    if (_indexes.empty()) {
+        return *this;
+    }
+
+    const int removedRows = _indexes.rank(rowCount);
+    const int removedColumns = _indexes.rank(columnCount);
+    const int chainSize = _ChainTypeFlag == COLUMN ? rowCount - removedRows : columnCount - removedColumns;
+
+    std::vector<int> remainingIndexes;
+    std::vector<std::size_t> weights;
+
+    synchronizeChainStates();
+
+    for (int index : nonEmptyChainsIndexes) {
+        if (!_indexes.contains(index)) {
+            remainingIndexes.push_back(index);
+            weights.push_back(chains[index].size());
+        }
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t) {
+        chains[remainingIndexes[_item]].chainData.remapIndexes([&_indexes](const int _index) { return _indexes.removedIndex(_index); });
+    });
+
+    std::size_t write = 0;
+    for (std::size_t read = 0 ; read < chains.size() ; read++) {
+        if (_indexes.contains(read)) {
+            continue;
+        }
+
+        chains[read].upperBound = chainSize;
+
+        if (write != read) {
+            chains[write] = std::move(chains[read]);
+        }
+        write++;
+    }
+
+    chains.erase(chains.begin() + write, chains.end());
+    rowCount -= removedRows;
+    columnCount -= removedColumns;
+
+    rebuildChainStates();
+
+    return *this;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::restriction(const IndexSet &_indexes) const {
+    return renumbered(
+        [&_indexes](const int _index) { return _indexes.keptIndex(_index); },
+        [&_indexes](const int _index) { return _indexes.keptIndex(_index); },
+        _indexes.rank(rowCount),
+        _indexes.rank(columnCount)
+    );
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::permuted(const Permutation &_rows, const Permutation &_columns) const {
+    if (_rows.size() != rowCount || _columns.size() != columnCount) {
+        throw std::invalid_argument("The permutations must have the matrix dimensions.");
+    }
+
+    const Permutation &chainPermutation = _ChainTypeFlag == COLUMN ? _columns : _rows;
+    const Permutation &entryPermutation = _ChainTypeFlag == COLUMN ? _rows : _columns;
+
+    return renumbered(chainPermutation, entryPermutation, rowCount, columnCount, false);
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::shrinkToFit() {
+    std::vector<std::size_t> weights(chains.size());
+
+    for (std::size_t index = 0 ; index < chains.size() ; index++) {
+        weights[index] = chains[index].size() + 1;
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _index, const std::size_t) {
+        chains[_index].chainData.shrinkToFit();
+    });
+
+    rebuildChainStates();
+    nonEmptyChainsIndexes.shrink_to_fit();
+    ChainPool::releaseAll();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::commitChains() {
+    if (chainsExposed) {
+        rebuildChainStates();
+    }
+
+    chainsExposed = false;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::begin() noexcept {
+    reorientedCache.reset();
+    chainsExposed = true;
+
+    return chains.begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::begin() const noexcept {
+    return chains.begin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::cbegin() const noexcept {
+    return chains.cbegin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::rbegin() noexcept {
+    reorientedCache.reset();
+    chainsExposed = true;
+
+    return chains.rbegin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::rbegin() const noexcept {
+    return chains.rbegin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::crbegin() const noexcept {
+    return chains.crbegin();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::end() noexcept {
+    reorientedCache.reset();
+    chainsExposed = true;
+
+    return chains.end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::end() const noexcept {
+    return chains.end();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::cend() const noexcept {
+    return chains.cend();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::rend() noexcept {
+    reorientedCache.reset();
+    chainsExposed = true;
+
+    return chains.rend();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::rend() const noexcept {
+    return chains.rend();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline typename SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::const_reverse_iterator SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::crend() const noexcept {
+    return chains.crend();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::transpose() const {
+    SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> result(0, 0);
+
+    result.chains.reserve(chains.size());
+    for (const MatrixChain &chain : chains) {
+        result.chains.push_back(chain.transpose());
+    }
+
+    synchronizeChainStates();
+
+    result.chainsStates = chainsStates;
+    result.nonEmptyChainsIndexes = nonEmptyChainsIndexes;
+    result.nonEmptyChainsPositions = nonEmptyChainsPositions;
+    result.rowCount = columnCount;
+    result.columnCount = rowCount;
+    result.threadPool = threadPool;
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getRowCount() const noexcept {
+    return rowCount;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline int SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getColumnCount() const noexcept {
+    return columnCount;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::setThreadPool(ThreadPool *_threadPool) noexcept {
+    threadPool = _threadPool;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline ThreadPool* SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getThreadPool() const noexcept {
+    return threadPool;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _Function>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::forEachNonEmpty(const _Function &_function) const {
+    synchronizeChainStates();
+
+    for (std::size_t word = 0 ; word < chainsStates.size() ; word++) {
+        for (uint64_t bits = chainsStates[word] ; bits != 0 ; bits &= bits - 1) {
+            const int index = word * 64 + countTrailingZeros(bits);
+
+            if (chains[index].size() != 0) {
+                _function(index, chains[index]);
+            }
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _Function>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::forEachNonEmpty(const _Function &_function) {
+    synchronizeChainStates();
+
+    for (std::size_t word = 0 ; word < chainsStates.size() ; word++) {
+        for (uint64_t bits = chainsStates[word] ; bits != 0 ; bits &= bits - 1) {
+            const int index = word * 64 + countTrailingZeros(bits);
+
+            if (chains[index].size() != 0) {
+                _function(index, chains[index]);
+            }
+
+            updateChainState(index, chains[index].size() == 0);
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::vector<_CoefficientType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::multiply(const std::vector<_CoefficientType> &_vector) const {
+    if (static_cast<int>(_vector.size()) != columnCount) {
+        throw std::invalid_argument("Vector size must be the matrix column count.");
+    }
+
+    std::vector<_CoefficientType> result(rowCount, _CoefficientType(0));
+    multiplyBlock(_vector.data(), 1, result.data());
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::vector<_CoefficientType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::multiply(const std::vector<_CoefficientType> &_block, const int _vectorCount) const {
+    if (_vectorCount <= 0 || _block.size() != std::size_t(columnCount) * _vectorCount) {
+        throw std::invalid_argument("Block size must be the matrix column count times the vector count.");
+    }
+
+    std::vector<_CoefficientType> result(std::size_t(rowCount) * _vectorCount, _CoefficientType(0));
+    multiplyBlock(_block.data(), _vectorCount, result.data());
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <int _CTF>
+std::vector<_CoefficientType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::dots(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other, const std::vector<std::pair<int, int>> &_pairs) const {
+    typedef SparseKernels<_CoefficientType> Kernels;
+    typedef SparseMatrix<_CoefficientType, _CTF, _StorageType> OtherMatrix;
+
+    const int entryCount = _ChainTypeFlag == COLUMN ? rowCount : columnCount;
+    if (entryCount != (_CTF == COLUMN ? _other.rowCount : _other.columnCount)) {
+        throw std::invalid_argument("Chains of both matrices must have the same size.");
+    }
+
+    for (const std::pair<int, int> &pair : _pairs) {
+        checkChainIndex(pair.first);
+        _other.checkChainIndex(pair.second);
+    }
+
+    // Counting sort of the pairs by first chain
+    std::vector<std::size_t> starts(chains.size() + 1, 0);
+    for (const std::pair<int, int> &pair : _pairs) {
+        starts[pair.first + 1]++;
+    }
+    for (std::size_t chain = 0 ; chain < chains.size() ; chain++) {
+        starts[chain + 1] += starts[chain];
+    }
+
+    std::vector<std::size_t> order(_pairs.size());
+    std::vector<std::size_t> positions(starts.begin(), starts.end() - 1);
+    for (std::size_t pair = 0 ; pair < _pairs.size() ; pair++) {
+        order[positions[_pairs[pair].first]++] = pair;
+    }
+
+    synchronizeChainStates();
+
+    std::vector<int> groups;
+    std::vector<std::size_t> weights;
+    for (int chain : nonEmptyChainsIndexes) {
+        if (starts[chain + 1] == starts[chain]) {
+            continue;
+        }
+
+        std::size_t weight = chains[chain].size();
+        for (std::size_t position = starts[chain] ; position < starts[chain + 1] ; position++) {
+            weight += _other.chains[_pairs[order[position]].second].size();
+        }
+
+        groups.push_back(chain);
+        weights.push_back(weight);
+    }
+
+    const std::size_t workerCount = threadPool == nullptr ? 1 : threadPool->size();
+    std::vector<std::vector<_CoefficientType>> denseChains(workerCount);
+    std::vector<std::vector<int>> scratchIndexes(workerCount);
+    std::vector<std::vector<_CoefficientType>> scratchCoefficients(workerCount);
+    std::vector<std::vector<int>> otherScratchIndexes(workerCount);
+    std::vector<std::vector<_CoefficientType>> otherScratchCoefficients(workerCount);
+    std::vector<_CoefficientType> result(_pairs.size(), _CoefficientType(0));
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t _worker) {
+        const int chain = groups[_item];
+
+        if (starts[chain + 1] - starts[chain] == 1) {
+            const std::size_t pair = order[starts[chain]];
+
+            result[pair] = _StorageType::dot(chains[chain].chainData, _other.chains[_pairs[pair].second].chainData);
+            return;
+        }
+
+        const std::size_t size = chains[chain].size();
+        const std::pair<const int*, const _CoefficientType*> arrays = chainArrays(chains[chain], scratchIndexes[_worker], scratchCoefficients[_worker]);
+
+        std::vector<_CoefficientType> &dense = denseChains[_worker];
+        if (dense.empty()) {
+            dense.assign(entryCount, _CoefficientType(0));
+        }
+
+        for (std::size_t entry = 0 ; entry < size ; entry++) {
+            dense[arrays.first[entry]] = arrays.second[entry];
+        }
+
+        for (std::size_t position = starts[chain] ; position < starts[chain + 1] ; position++) {
+            const std::size_t pair = order[position];
+            const typename OtherMatrix::MatrixChain &other = _other.chains[_pairs[pair].second];
+            const std::pair<const int*, const _CoefficientType*> otherArrays = OtherMatrix::chainArrays(other, otherScratchIndexes[_worker], otherScratchCoefficients[_worker]);
+
+            result[pair] = Kernels::dot(otherArrays.first, otherArrays.second, other.size(), dense.data());
+        }
+
+        // Only the scattered entries are cleared, the dense chain is reused by the next group of the worker
+        for (std::size_t entry = 0 ; entry < size ; entry++) {
+            dense[arrays.first[entry]] = _CoefficientType(0);
+        }
+    });
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+ChainStatistics<_CoefficientType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::chainStatistics() const {
+    synchronizeChainStates();
+
+    ChainStatistics<_CoefficientType> result;
+    result.sizes.assign(chains.size(), 0);
+    result.squaredNorms.assign(chains.size(), _CoefficientType(0));
+
+    const std::size_t workerCount = threadPool == nullptr ? 1 : threadPool->size();
+    std::vector<std::vector<int>> scratchIndexes(workerCount);
+    std::vector<std::vector<_CoefficientType>> scratchCoefficients(workerCount);
+    std::vector<std::size_t> weights(nonEmptyChainsIndexes.size());
+
+    for (std::size_t item = 0 ; item < nonEmptyChainsIndexes.size() ; item++) {
+        weights[item] = chains[nonEmptyChainsIndexes[item]].size();
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t _worker) {
+        const int chain = nonEmptyChainsIndexes[_item];
+        const std::pair<const int*, const _CoefficientType*> arrays = chainArrays(chains[chain], scratchIndexes[_worker], scratchCoefficients[_worker]);
+
+        result.sizes[chain] = chains[chain].size();
+        result.squaredNorms[chain] = SparseKernels<_CoefficientType>::squaredNorm(arrays.second, chains[chain].size());
+    });
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::updateChainState(const int _index, const bool _isEmpty) {
+    reorientedCache.reset();
+
+    const uint64_t mask = uint64_t(1) << (_index % 64);
+    const bool wasEmpty = (chainsStates[_index / 64] & mask) == 0;
+
+    if (wasEmpty == _isEmpty) {
+        return;
+    }
+
+    if (_isEmpty) {
+        const int position = nonEmptyChainsPositions[_index];
+        const int last = nonEmptyChainsIndexes.back();
+
+        chainsStates[_index / 64] &= ~mask;
+        nonEmptyChainsIndexes[position] = last;
+        nonEmptyChainsPositions[last] = position;
+        nonEmptyChainsIndexes.pop_back();
+        nonEmptyChainsPositions[_index] = -1;
+    } else {
+        chainsStates[_index / 64] |= mask;
+        nonEmptyChainsPositions[_index] = nonEmptyChainsIndexes.size();
+        nonEmptyChainsIndexes.push_back(_index);
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::checkChainIndex(const int _index) const {
+    if (_index < 0 || _index >= static_cast<int>(chains.size())) {
+        throw std::out_of_range("Chain index out of matrix bounds.");
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::rebuildChainStates() {
+    reorientedCache.reset();
+    scanChainStates();
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::synchronizeChainStates() const {
+    if (chainsExposed) {
+        scanChainStates();
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::scanChainStates() const {
+    chainsStates.assign((chains.size() + 63) / 64, 0);
+    nonEmptyChainsIndexes.clear();
+    nonEmptyChainsPositions.assign(chains.size(), -1);
+
+    for (std::size_t index = 0 ; index < chains.size() ; index++) {
+        if (chains[index].size() != 0) {
+            chainsStates[index / 64] |= uint64_t(1) << (index % 64);
+            nonEmptyChainsPositions[index] = nonEmptyChainsIndexes.size();
+            nonEmptyChainsIndexes.push_back(index);
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::multiplyBlock(const _CoefficientType *_block, const int _vectorCount, _CoefficientType *_result) const {
+    typedef SparseKernels<_CoefficientType> Kernels;
+
+    synchronizeChainStates();
+
+    const std::size_t workerCount = threadPool == nullptr ? 1 : threadPool->size();
+    std::vector<std::vector<int>> scratchIndexes(workerCount);
+    std::vector<std::vector<_CoefficientType>> scratchCoefficients(workerCount);
+
+    if constexpr (_ChainTypeFlag == ROW) {
+        std::vector<std::size_t> weights(nonEmptyChainsIndexes.size());
+
+        for (std::size_t item = 0 ; item < nonEmptyChainsIndexes.size() ; item++) {
+            weights[item] = chains[nonEmptyChainsIndexes[item]].size() * _vectorCount;
+        }
+
+        ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t _worker) {
+            const int row = nonEmptyChainsIndexes[_item];
+            const std::pair<const int*, const _CoefficientType*> arrays = chainArrays(chains[row], scratchIndexes[_worker], scratchCoefficients[_worker]);
+
+            if (_vectorCount == 1) {
+                _result[row] = Kernels::dot(arrays.first, arrays.second, chains[row].size(), _block);
+            } else {
+                Kernels::dotBlock(arrays.first, arrays.second, chains[row].size(), _block, _vectorCount, _result + std::size_t(row) * _vectorCount);
+            }
+        });
+    } else {
+        std::size_t entryCount = 0;
+        for (int column : nonEmptyChainsIndexes) {
+            entryCount += chains[column].size();
+        }
+
+        // Each block of rows adds the part of every column in its rows, found by binary search in sorted storages.
+        const std::size_t blockCount = threadPool == nullptr || !_StorageType::CONTIGUOUS || entryCount * _vectorCount < ThreadPool::MINIMAL_TASK_WEIGHT ?
+            1 : std::min<std::size_t>(4 * workerCount, std::max(rowCount, 1));
+
+        const ThreadPool::Job job = [&](const std::size_t _rowBlock, const std::size_t _worker) {
+            const int firstRow = _rowBlock * rowCount / blockCount;
+            const int lastRow = (_rowBlock + 1) * rowCount / blockCount;
+
+            for (int column : nonEmptyChainsIndexes) {
+                const std::pair<const int*, const _CoefficientType*> arrays = chainArrays(chains[column], scratchIndexes[_worker], scratchCoefficients[_worker]);
+                const int *begin = arrays.first;
+                const int *end = arrays.first + chains[column].size();
+
+                if (blockCount > 1) {
+                    begin = std::lower_bound(begin, end, firstRow);
+                    end = std::lower_bound(begin, end, lastRow);
+                }
+
+                const _CoefficientType *coefficients = arrays.second + (begin - arrays.first);
+
+                if (_vectorCount == 1) {
+                    if (_block[column] != _CoefficientType(0)) {
+                        Kernels::scatterAdd(begin, coefficients, end - begin, _block[column], _result);
+                    }
+                } else {
+                    Kernels::scatterAddBlock(begin, coefficients, end - begin, _block + std::size_t(column) * _vectorCount, _vectorCount, _result);
+                }
+            }
+        };
+
+        if (blockCount == 1) {
+            job(0, 0);
+        } else {
+            threadPool->run(blockCount, job);
+        }
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+std::pair<const int*, const _CoefficientType*> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::chainArrays(const MatrixChain &_chain, std::vector<int> &_indexes, std::vector<_CoefficientType> &_coefficients) {
+    if constexpr (_StorageType::CONTIGUOUS) {
+        return std::make_pair(_chain.chainData.indexData(), _chain.chainData.coefficientData());
+    } else {
+        _indexes.clear();
+        _coefficients.clear();
+
+        for (typename MatrixChain::const_iterator it = _chain.cbegin() ; it != _chain.cend() ; ++it) {
+            _indexes.push_back(it->first);
+            _coefficients.push_back(it->second);
+        }
+
+        return std::make_pair(_indexes.data(), _coefficients.data());
+    }
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _ChainMap, typename _EntryMap>
+SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::renumbered(const _ChainMap &_chainMap, const _EntryMap &_entryMap, const int _rowCount, const int _columnCount, const bool _increasing) const {
+    SparseMatrix result(_rowCount, _columnCount);
+    result.threadPool = threadPool;
+
+    synchronizeChainStates();
+
+    std::vector<std::pair<int, int>> copies;
+    std::vector<std::size_t> weights;
+
+    for (int index : nonEmptyChainsIndexes) {
+        const int target = _chainMap(index);
+
+        if (target >= 0) {
+            copies.emplace_back(index, target);
+            weights.push_back(chains[index].size());
+        }
+    }
+
+    ThreadPool::forEachWeighted(threadPool, weights, [&](const std::size_t _item, const std::size_t) {
+        MatrixChain &chain = result.chains[copies[_item].second];
+
+        chain.chainData = chains[copies[_item].first].chainData;
+        if (_increasing) {
+            chain.chainData.remapIndexes(_entryMap);
+        } else {
+            chain.chainData.permuteIndexes(_entryMap);
+        }
+    });
+
+    result.rebuildChainStates();
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::reoriented() const {
+    SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType> result(rowCount, columnCount);
+    const std::size_t targetCount = result.chains.size();
+
+    synchronizeChainStates();
+
+    std::size_t entryCount = 0;
+    for (int index : nonEmptyChainsIndexes) {
+        entryCount += chains[index].size();
+    }
+
+    const std::size_t blockCount = threadPool == nullptr || !_StorageType::CONTIGUOUS || entryCount < ThreadPool::MINIMAL_TASK_WEIGHT ?
+        1 : std::min<std::size_t>(4 * threadPool->size(), std::max<std::size_t>(targetCount, 1));
+
+    // Calls the function on the entries of the chain falling in [_first, _last), by increasing index.
+    const auto forEachEntry = [blockCount](const MatrixChain &_chain, const int _first, const int _last, const auto &_function) {
+        if constexpr (_StorageType::CONTIGUOUS) {
+            const int *indexes = _chain.chainData.indexData();
+            const _CoefficientType *coefficients = _chain.chainData.coefficientData();
+            const int *begin = indexes;
+            const int *end = indexes + _chain.size();
+
+            if (blockCount > 1) {
+                begin = std::lower_bound(begin, end, _first);
+                end = std::lower_bound(begin, end, _last);
+            }
+
+            for (const int *it = begin ; it != end ; ++it) {
+                _function(*it, coefficients[it - indexes]);
+            }
+        } else {
+            for (typename MatrixChain::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+                _function(it->first, it->second);
+            }
+        }
+    };
+
+    const ThreadPool::Job job = [&](const std::size_t _block, const std::size_t) {
+        const int first = _block * targetCount / blockCount;
+        const int last = (_block + 1) * targetCount / blockCount;
+        std::vector<std::size_t> counts(last - first, 0);
+
+        for (std::size_t index = 0 ; index < chains.size() ; index++) {
+            forEachEntry(chains[index], first, last, [&](const int _target, const _CoefficientType &) {
+                counts[_target - first]++;
+            });
+        }
+
+        for (int target = first ; target < last ; target++) {
+            result.chains[target].chainData.reserve(counts[target - first]);
+        }
+
+        // Source chains are visited by increasing index, so every target chain is filled in order.
+        for (std::size_t index = 0 ; index < chains.size() ; index++) {
+            forEachEntry(chains[index], first, last, [&](const int _target, const _CoefficientType &_coefficient) {
+                result.chains[_target].chainData.append(index, _coefficient);
+            });
+        }
+    };
+
+    if (blockCount == 1) {
+        job(0, 0);
+    } else {
+        threadPool->run(blockCount, job);
+    }
+
+    result.rebuildChainStates();
+    result.threadPool = threadPool;
+
+    return result;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+const SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>& SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::getReoriented() const {
+    if (chainsExposed && reorientedCache != nullptr && reorientedCache.use_count() == 1) {
+        // Refreshed in place, so that the reference given by the previous call stays valid.
+        *reorientedCache = reoriented();
+    } else if (chainsExposed || reorientedCache == nullptr) {
+        reorientedCache = std::make_shared<SparseMatrix<_CoefficientType, TRANSPOSED<_ChainTypeFlag>, _StorageType>>(reoriented());
+    }
+
+    return *reorientedCache;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+inline bool SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::isReorientedCached() const noexcept {
+    return reorientedCache != nullptr && !chainsExposed;
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _InnerChain, typename _OuterChain>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::gustavsonKernel(const std::vector<_InnerChain> &_inner, const std::vector<_OuterChain> &_outer, std::vector<MatrixChain> &_output, const int _outputSize, ThreadPool *_pool) {
+    std::vector<std::size_t> weights(_outer.size(), 0);
+
+    for (std::size_t index = 0 ; index < _outer.size() ; index++) {
+        for (typename _OuterChain::const_iterator it = _outer[index].begin() ; it != _outer[index].end() ; ++it) {
+            weights[index] += _inner[it->first].size();
+        }
+    }
+
+    std::vector<SparseAccumulator<_CoefficientType>> accumulators(_pool != nullptr ? _pool->size() : 1);
+
+    ThreadPool::forEachWeighted(_pool, weights, [&](const std::size_t _index, const std::size_t _worker) {
+        if (weights[_index] == 0) {
+            return;
+        }
+
+        SparseAccumulator<_CoefficientType> &accumulator = accumulators[_worker];
+        if (accumulator.size() != _outputSize) {
+            accumulator.resize(_outputSize);
+        }
+
+        for (typename _OuterChain::const_iterator it = _outer[_index].begin() ; it != _outer[_index].end() ; ++it) {
+            accumulator.addScaled(_inner[it->first], it->second);
+        }
+
+        accumulator.flush(_output[_index].chainData);
+    });
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _TargetChain, typename _EntryChain>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::outerProductKernel(const std::vector<_TargetChain> &_targets, const std::vector<_EntryChain> &_entries, std::vector<MatrixChain> &_output, const int _outputSize, ThreadPool *_pool) {
+    std::vector<std::size_t> offsets(_output.size() + 1, 0);
+
+    for (std::size_t shared = 0 ; shared < _targets.size() ; shared++) {
+        for (typename _TargetChain::const_iterator it = _targets[shared].begin() ; it != _targets[shared].end() ; ++it) {
+            offsets[it->first + 1] += _entries[shared].size();
+        }
+    }
+
+    for (std::size_t index = 1 ; index < offsets.size() ; index++) {
+        offsets[index] += offsets[index - 1];
+    }
+
+    std::vector<std::size_t> cursors(offsets.begin(), offsets.end() - 1);
+    std::vector<int> expandedIndexes(offsets.back());
+    std::vector<_CoefficientType> expandedCoefficients(offsets.back());
+
+    for (std::size_t shared = 0 ; shared < _targets.size() ; shared++) {
+        for (typename _TargetChain::const_iterator target = _targets[shared].begin() ; target != _targets[shared].end() ; ++target) {
+            for (typename _EntryChain::const_iterator entry = _entries[shared].begin() ; entry != _entries[shared].end() ; ++entry) {
+                std::size_t position = cursors[target->first]++;
+                expandedIndexes[position] = entry->first;
+                expandedCoefficients[position] = entry->second * target->second;
+            }
+        }
+    }
+
+    std::vector<std::size_t> weights(_output.size());
+    for (std::size_t index = 0 ; index < _output.size() ; index++) {
+        weights[index] = offsets[index + 1] - offsets[index];
+    }
+
+    std::vector<SparseAccumulator<_CoefficientType>> accumulators(_pool != nullptr ? _pool->size() : 1);
+
+    ThreadPool::forEachWeighted(_pool, weights, [&](const std::size_t _index, const std::size_t _worker) {
+        if (weights[_index] == 0) {
+            return;
+        }
+
+        SparseAccumulator<_CoefficientType> &accumulator = accumulators[_worker];
+        if (accumulator.size() != _outputSize) {
+            accumulator.resize(_outputSize);
+        }
+
+        for (std::size_t position = offsets[_index] ; position < offsets[_index + 1] ; position++) {
+            accumulator.add(expandedIndexes[position], expandedCoefficients[position]);
+        }
+
+        accumulator.flush(_output[_index].chainData);
+    });
+}
+
+template <typename _CoefficientType, int _ChainTypeFlag, typename _StorageType>
+template <typename _RowChain, typename _ColumnChain>
+void SparseMatrix<_CoefficientType, _ChainTypeFlag, _StorageType>::innerProductKernel(const std::vector<_RowChain> &_rows, const std::vector<_ColumnChain> &_columns, std::vector<MatrixChain> &_output, ThreadPool *_pool) {
+    std::vector<int> rowIndexes;
+    std::vector<int> columnIndexes;
+
+    for (std::size_t index = 0 ; index < _rows.size() ; index++) {
+        if (_rows[index].size() != 0) {
+            rowIndexes.push_back(index);
+        }
+    }
+
+    for (std::size_t index = 0 ; index < _columns.size() ; index++) {
+        if (_columns[index].size() != 0) {
+            columnIndexes.push_back(index);
+        }
+    }
+
+    const std::vector<int> &outerIndexes = _ChainTypeFlag == COLUMN ? columnIndexes : rowIndexes;
+    const std::vector<int> &innerIndexes = _ChainTypeFlag == COLUMN ? rowIndexes : columnIndexes;
+
+    std::size_t innerCoefficients = 0;
+    for (int inner : innerIndexes) {
+        innerCoefficients += _ChainTypeFlag == COLUMN ? _rows[inner].size() : _columns[inner].size();
+    }
+
+    std::vector<std::size_t> weights(outerIndexes.size());
+    for (std::size_t item = 0 ; item < outerIndexes.size() ; item++) {
+        const std::size_t outerSize = _ChainTypeFlag == COLUMN ? _columns[outerIndexes[item]].size() : _rows[outerIndexes[item]].size();
+        weights[item] = outerSize * innerIndexes.size() + innerCoefficients;
+    }
+
+    ThreadPool::forEachWeighted(_pool, weights, [&](const std::size_t _item, const std::size_t) {
+        const int outer = outerIndexes[_item];
+
+        for (int inner : innerIndexes) {
+            const int row = _ChainTypeFlag == COLUMN ? inner : outer;
+            const int column = _ChainTypeFlag == COLUMN ? outer : inner;
+            const _CoefficientType coefficient = _rows[row] * _columns[column];
+
+            if (coefficient != _CoefficientType(0)) {
+                _output[outer].chainData.append(inner, coefficient);
+            }
+        }
+    });
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const Chain<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row) {
+    return ChainView<_CT, COLUMN, _ST>(_column) * ChainView<_CT, ROW, _ST>(_row);
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const Chain<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row) {
+    return ChainView<_CT, COLUMN, _ST>(_column) % ChainView<_CT, ROW, _ST>(_row);
+}
+
+/**
+ * \brief Generate a column-based matrix from the outer product of a column and a row, any of them being a view.
+ * 
+ * \param[in] _column The column.
+ * \param[in] _row The row.
+ * 
+ * \return A new column-based matrix representing the result.
+ * 
+ * \see \link OSM::ChainView \endlink
+ */
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const ChainView<_CT, COLUMN, _ST> &_column, const ChainView<_CT, ROW, _ST> &_row) {
+    SparseMatrix<_CT, COLUMN, _ST> result(_column.getUpperBound(), _row.getUpperBound());
+
+    for (typename ChainView<_CT, ROW, _ST>::const_iterator it = _row.begin() ; it != _row.end() ; ++it) {
+        result.setColumn(it->first, Chain<_CT, COLUMN, _ST>(_column * it->second));
+    }
+
+    return result;
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const Chain<_CT, COLUMN, _ST> &_column, const ChainView<_CT, ROW, _ST> &_row) {
+    return ChainView<_CT, COLUMN, _ST>(_column) * _row;
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const ChainView<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row) {
+    return _column * ChainView<_CT, ROW, _ST>(_row);
+}
+
+/**
+ * \brief Generate a row-based matrix from the outer product of a column and a row, any of them being a view.
+ * 
+ * \param[in] _column The column.
+ * \param[in] _row The row.
+ * 
+ * \return A new row-based matrix representing the result.
+ * 
+ * \see \link OSM::ChainView \endlink
+ */
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const ChainView<_CT, COLUMN, _ST> &_column, const ChainView<_CT, ROW, _ST> &_row) {
+    SparseMatrix<_CT, ROW, _ST> result(_column.getUpperBound(), _row.getUpperBound());
+
+    for (typename ChainView<_CT, COLUMN, _ST>::const_iterator it = _column.begin() ; it != _column.end() ; ++it) {
+        result.setRow(it->first, Chain<_CT, ROW, _ST>(_row * it->second));
+    }
+
+    return result;
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const Chain<_CT, COLUMN, _ST> &_column, const ChainView<_CT, ROW, _ST> &_row) {
+    return ChainView<_CT, COLUMN, _ST>(_column) % _row;
+}
+
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const ChainView<_CT, COLUMN, _ST> &_column, const Chain<_CT, ROW, _ST> &_row) {
+    return _column % ChainView<_CT, ROW, _ST>(_row);
+}
+
+
+/**
+ * \class SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>
+ * \brief Sparse matrix indexed both by columns and by rows.
+ * 
+ * Stores the matrix twice, as a column-based matrix and as a row-based matrix, and keeps both up to date on every write.
+ * Getting or setting a row or a column costs the number of coefficients of the chain, in both directions,
+ * at the price of twice the memory and of writes updating both views.
+ * 
+ * \note There is no mutable chain access, coefficients are modified through setters so that both views stay in sync.
+ * \note Products use the view matching the other operand orientation, their result is single-indexed.
+ * 
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+ */
+template <typename _CoefficientType, typename _StorageType>
+class SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType> {
+
+public:
+    typedef SparseMatrix<_CoefficientType, COLUMN, _StorageType> ColumnMatrix;
+    typedef SparseMatrix<_CoefficientType, ROW, _StorageType> RowMatrix;
+
+private:
+    /** \brief The column-based view. */
+    ColumnMatrix columns;
+
+    /** \brief The row-based view. */
+    RowMatrix rows;
+
+public:
+    /**
+     * \brief Create new SparseMatrix object.
+     * 
+     * Default constructor, initialize an empty Matrix indexed both ways.
+     * The default matrix size is 128x128.
+     */
+    SparseMatrix();
+
+    /**
+     * \brief Create new SparseMatrix object.
+     * 
+     * Constructor with size, initialize an empty Matrix indexed both ways.
+     * 
+     * \param[in] _rowCount The number of rows to preallocate.
+     * \param[in] _columnCount The number of columns to preallocate.
+     */
+    SparseMatrix(const int _rowCount, const int _columnCount);
+
+    /**
+     * \brief Create new SparseMatrix object.
+     * 
+     * Conversion constructor, builds the row-based view from a column-based matrix.
+     * 
+     * \param[in] _columns The column-based matrix.
+     */
+    explicit SparseMatrix(const ColumnMatrix &_columns);
+
+    /**
+     * \brief Create new SparseMatrix object.
+     * 
+     * Conversion constructor, builds the column-based view from a row-based matrix.
+     * 
+     * \param[in] _rows The row-based matrix.
+     */
+    explicit SparseMatrix(const RowMatrix &_rows);
+
+    /**
+     * \brief Builds a matrix from (row, column, value) triplets.
+     * 
+     * \param[in] _rowCount The number of rows.
+     * \param[in] _columnCount The number of columns.
+     * \param[in] _triplets The triplets, in any order.
+     * \param[in] _threadPool The pool used for the construction and set on the matrix, null for sequential processing.
+     * 
+     * \return The matrix.
+     * 
+     * \throws std::out_of_range If a triplet is out of the matrix.
+     * 
+     * \see \link OSM::SparseMatrix::fromTriplets \endlink
+     */
+    static SparseMatrix fromTriplets(const int _rowCount, const int _columnCount, const std::vector<Triplet<_CoefficientType>> &_triplets, ThreadPool *_threadPool = nullptr);
+
+    /**
+     * \brief Add a matrix and assign.
+     * 
+     * \warning Will raise an error if the matrices do not have the same dimensions.
+     * 
+     * \param[in] _other The other matrix.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    SparseMatrix& operator+=(const SparseMatrix &_other);
+
+    /**
+     * \brief Substract a matrix and assign.
+     * 
+     * \warning Will raise an error if the matrices do not have the same dimensions.
+     * 
+     * \param[in] _other The other matrix.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    SparseMatrix& operator-=(const SparseMatrix &_other);
+
+    /**
+     * \brief Apply factor on each coefficients and assign.
+     * 
+     * \warning Will raise an error if _lambda is 0.
+     * 
+     * \param[in] _lambda The factor to apply.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    SparseMatrix& operator*=(const int _lambda);
+
+    /**
+     * \brief Multiply by a matrix and assign.
+     * 
+     * \warning Will raise an error if the matrix column count is not the other matrix row count.
+     * 
+     * \param[in] _other The other matrix.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    template <int _CTF>
+    SparseMatrix& operator*=(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other);
+
+    /**
+     * \brief Get a coefficient from the matrix.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _row The coefficient row.
+     * \param[in] _column The coefficient column.
+     * 
+     * \return The coefficient, 0 if not stored.
+     */
+    _CoefficientType getCoefficient(const int _row, const int _column) const;
+
+    /**
+     * \brief Set a coefficient in both views.
+     * 
+     * \note Setting a coefficient to 0 removes it.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _row The coefficient row.
+     * \param[in] _column The coefficient column.
+     * \param[in] _value The new coefficient.
+     */
+    void setCoefficient(const int _row, const int _column, const _CoefficientType _value);
+
+    /**
+     * \brief Get a column from the matrix.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The column index.
+     * 
+     * \return A view on the column stored at given index.
+     */
+    ChainView<_CoefficientType, COLUMN, _StorageType> getColumn(const int _index) const;
+
+    /**
+     * \brief Get a row from the matrix.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The row index.
+     * 
+     * \return A view on the row stored at given index.
+     */
+    ChainView<_CoefficientType, ROW, _StorageType> getRow(const int _index) const;
+
+    /**
+     * \brief Set a column in both views.
+     * 
+     * Only the rows crossing the previous or the new column are updated.
+     * 
+     * \warning The matrix will perform boundary check, on the index and on the chain entries.
+     * 
+     * \param[in] _index The column index.
+     * \param[in] _chain The new column, or a view on it.
+     */
+    void setColumn(const int _index, const ChainView<_CoefficientType, COLUMN, _StorageType> &_chain);
+
+    /**
+     * \brief Set a row in both views.
+     * 
+     * Only the columns crossing the previous or the new row are updated.
+     * 
+     * \warning The matrix will perform boundary check, on the index and on the chain entries.
+     * 
+     * \param[in] _index The row index.
+     * \param[in] _chain The new row, or a view on it.
+     */
+    void setRow(const int _index, const ChainView<_CoefficientType, ROW, _StorageType> &_chain);
+
+    /**
+     * \brief Removes all coefficients of a column.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The column index.
+     */
+    void nullifyColumn(const int _index);
+
+    /**
+     * \brief Removes all coefficients of a row.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The row index.
+     */
+    void nullifyRow(const int _index);
+
+    /**
+     * \brief Checks if a column has no coefficient.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The column index.
+     * 
+     * \return True if the column is empty.
+     */
+    bool isNullColumn(const int _index) const;
+
+    /**
+     * \brief Checks if a row has no coefficient.
+     * 
+     * \warning The matrix will perform boundary check.
+     * 
+     * \param[in] _index The row index.
+     * 
+     * \return True if the row is empty.
+     */
+    bool isNullRow(const int _index) const;
+
+    /**
+     * \brief Get a submatrix from the matrix and assign.
+     * 
+     * Removes the rows and the columns with the given indexes from both views, the remaining indexes are shifted.
+     * 
+     * \note Will not alter the matrix if given vector is empty.
+     * 
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    SparseMatrix& operator/=(const std::vector<int> &_indexes);
+
+    /**
+     * \brief Get a submatrix from the matrix and assign.
+     * 
+     * Removes the rows and the columns with the given indexes from both views, the remaining indexes are shifted.
+     * 
+     * \note Will not alter the matrix if given array is empty.
+     * 
+     * \warning The indexes array must be terminated by a negative index.
+     * 
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return The modified matrix representing the result.
+     */
+    SparseMatrix& operator/=(const int *_indexes);
+
+    /**
+     * \brief Get a submatrix from the matrix and assign.
+     * 
+     * Removes the rows and the columns with the indexes of the set from both views, the remaining indexes are shifted.
+     * 
+     * \param[in] _indexes The indexes to remove.
+     * 
+     * \return The modified matrix representing the result.
+     * 
+     * \see \link OSM::IndexSet \endlink
+     */
+    SparseMatrix& operator/=(const IndexSet &_indexes);
+
+    /**
+     * \brief Restricts the matrix to a set of indexes.
+     * 
+     * Keeps the rows and the columns with the indexes of the set only in both views, renumbered among them.
+     * 
+     * \param[in] _indexes The indexes to keep.
+     * 
+     * \return A new matrix representing the result.
+     * 
+     * \see \link OSM::IndexSet \endlink
+     */
+    SparseMatrix restriction(const IndexSet &_indexes) const;
+
+    /**
+     * \brief Permutes the rows and the columns of the matrix in both views.
+     * 
+     * \warning Will raise an error if the permutation sizes are not the row and column counts.
+     * 
+     * \param[in] _rows The permutation of the rows.
+     * \param[in] _columns The permutation of the columns.
+     * 
+     * \return A new matrix representing the result.
+     * 
+     * \see \link OSM::Permutation \endlink
+     */
+    SparseMatrix permuted(const Permutation &_rows, const Permutation &_columns) const;
+
+    /**
+     * \brief Gives back the memory left unused by cancellations.
+     * 
+     * Every chain storage is shrunk to its size, in parallel when the matrix has a thread pool, the chain states are
+     * rebuilt and the blocks cached by the OSM::ChainPool are released.
+     * 
+     * \see \link OSM::ChainPool \endlink
+     */
+    void shrinkToFit();
+
+    /**
+     * \brief Transpose a matrix.
+     * 
+     * The views are exchanged, no coefficient is moved between chains.
+     * 
+     * \return A new matrix indexed both ways representing the transposed matrix.
+     */
+    SparseMatrix transpose() const;
+
+    /**
+     * \brief Get the column-based view of the matrix.
+     * 
+     * \return The column-based matrix.
+     */
+    inline const ColumnMatrix& getColumnMatrix() const noexcept;
+
+    /**
+     * \brief Get the row-based view of the matrix.
+     * 
+     * \return The row-based matrix.
+     */
+    inline const RowMatrix& getRowMatrix() const noexcept;
+
+    /**
+     * \brief Get the number of rows of the matrix.
+     * 
+     * \return The number of rows.
+     */
+    inline int getRowCount() const noexcept;
+
+    /**
+     * \brief Get the number of columns of the matrix.
+     * 
+     * \return The number of columns.
+     */
+    inline int getColumnCount() const noexcept;
+
+    /**
+     * \brief Set the thread pool used by the operations on both views.
+     * 
+     * \param[in] _threadPool The pool to use, null for sequential processing.
+     * 
+     * \see \link OSM::ThreadPool \endlink
+     */
+    inline void setThreadPool(ThreadPool *_threadPool) noexcept;
+
+    /**
+     * \brief Get the thread pool used by the operations on both views.
+     * 
+     * \return The pool, null if the matrix is processed sequentially.
+     */
+    inline ThreadPool* getThreadPool() const noexcept;
+
+    /**
+     * \brief Calls a function on each non empty column, by increasing index.
+     * 
+     * \param[in] _function The function, called with the column index and the column.
+     * 
+     * \see \link OSM::SparseMatrix::forEachNonEmpty \endlink
+     */
+    template <typename _Function>
+    void forEachNonEmptyColumn(const _Function &_function) const { columns.forEachNonEmpty(_function); }
+
+    /**
+     * \brief Calls a function on each non empty row, by increasing index.
+     * 
+     * \param[in] _function The function, called with the row index and the row.
+     * 
+     * \see \link OSM::SparseMatrix::forEachNonEmpty \endlink
+     */
+    template <typename _Function>
+    void forEachNonEmptyRow(const _Function &_function) const { rows.forEachNonEmpty(_function); }
+
+    /**
+     * \brief Multiplies the matrix with a dense vector, with gathered dot products on the row-based view.
+     * 
+     * \param[in] _vector The dense vector.
+     * 
+     * \return The dense product, of size the row count.
+     * 
+     * \see \link OSM::SparseMatrix::multiply \endlink
+     */
+    std::vector<_CoefficientType> multiply(const std::vector<_CoefficientType> &_vector) const { return rows.multiply(_vector); }
+
+    /**
+     * \brief Multiplies the matrix with a row-major dense block of vectors, on the row-based view.
+     * 
+     * \param[in] _block The dense block, of columnCount rows.
+     * \param[in] _vectorCount The number of vectors of the block.
+     * 
+     * \return The dense product, of rowCount rows.
+     * 
+     * \see \link OSM::SparseMatrix::multiply \endlink
+     */
+    std::vector<_CoefficientType> multiply(const std::vector<_CoefficientType> &_block, const int _vectorCount) const { return rows.multiply(_block, _vectorCount); }
+};
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::SparseMatrix() : SparseMatrix(128, 128) {}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::SparseMatrix(const int _rowCount, const int _columnCount) :
+    columns(_rowCount, _columnCount),
+    rows(_rowCount, _columnCount) {}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::SparseMatrix(const ColumnMatrix &_columns) :
+    columns(_columns),
+    rows(_columns.reoriented()) {}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::SparseMatrix(const RowMatrix &_rows) :
+    columns(_rows.reoriented()),
+    rows(_rows) {}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::fromTriplets(const int _rowCount, const int _columnCount, const std::vector<Triplet<_CoefficientType>> &_triplets, ThreadPool *_threadPool) {
+    SparseMatrix result(0, 0);
+
+    result.columns = ColumnMatrix::fromTriplets(_rowCount, _columnCount, _triplets, _threadPool);
+    result.rows = RowMatrix::fromTriplets(_rowCount, _columnCount, _triplets, _threadPool);
+
+    return result;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator+=(const SparseMatrix &_other) {
+    columns += _other.columns;
+    rows += _other.rows;
+
+    return *this;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator-=(const SparseMatrix &_other) {
+    columns -= _other.columns;
+    rows -= _other.rows;
+
+    return *this;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator*=(const int _lambda) {
+    columns *= _lambda;
+    rows *= _lambda;
+
+    return *this;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+template <int _CTF>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator*=(const SparseMatrix<_CoefficientType, _CTF, _StorageType> &_other) {
+    *this = SparseMatrix(*this * _other);
+
+    return *this;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+_CoefficientType SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getCoefficient(const int _row, const int _column) const {
+    columns.checkChainIndex(_column);
+    rows.checkChainIndex(_row);
+
+    return columns.chains[_column].chainData.get(_row);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::setCoefficient(const int _row, const int _column, const _CoefficientType _value) {
+    columns.checkChainIndex(_column);
+    rows.checkChainIndex(_row);
+
+    if (_value == _CoefficientType(0)) {
+        columns.chains[_column].chainData.erase(_row);
+        rows.chains[_row].chainData.erase(_column);
+    } else {
+        columns.chains[_column].chainData.access(_row) = _value;
+        rows.chains[_row].chainData.access(_column) = _value;
+    }
+
+    columns.updateChainState(_column, columns.chains[_column].size() == 0);
+    rows.updateChainState(_row, rows.chains[_row].size() == 0);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+ChainView<_CoefficientType, COLUMN, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getColumn(const int _index) const {
+    return columns.getColumn(_index);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+ChainView<_CoefficientType, ROW, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getRow(const int _index) const {
+    return rows.getRow(_index);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::setColumn(const int _index, const ChainView<_CoefficientType, COLUMN, _StorageType> &_chain) {
+    columns.checkChainIndex(_index);
+
+    for (typename ChainView<_CoefficientType, COLUMN, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+        rows.checkChainIndex(it->first);
+    }
+
+    const Chain<_CoefficientType, COLUMN, _StorageType> &previous = columns.chains[_index];
+
+    for (typename Chain<_CoefficientType, COLUMN, _StorageType>::const_iterator it = previous.begin() ; it != previous.end() ; ++it) {
+        rows.chains[it->first].chainData.erase(_index);
+        rows.updateChainState(it->first, rows.chains[it->first].size() == 0);
+    }
+
+    columns.setColumn(_index, _chain);
+
+    for (typename ChainView<_CoefficientType, COLUMN, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+        rows.chains[it->first].chainData.access(_index) = it->second;
+        rows.updateChainState(it->first, false);
+    }
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::setRow(const int _index, const ChainView<_CoefficientType, ROW, _StorageType> &_chain) {
+    rows.checkChainIndex(_index);
+
+    for (typename ChainView<_CoefficientType, ROW, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+        columns.checkChainIndex(it->first);
+    }
+
+    const Chain<_CoefficientType, ROW, _StorageType> &previous = rows.chains[_index];
+
+    for (typename Chain<_CoefficientType, ROW, _StorageType>::const_iterator it = previous.begin() ; it != previous.end() ; ++it) {
+        columns.chains[it->first].chainData.erase(_index);
+        columns.updateChainState(it->first, columns.chains[it->first].size() == 0);
+    }
+
+    rows.setRow(_index, _chain);
+
+    for (typename ChainView<_CoefficientType, ROW, _StorageType>::const_iterator it = _chain.begin() ; it != _chain.end() ; ++it) {
+        columns.chains[it->first].chainData.access(_index) = it->second;
+        columns.updateChainState(it->first, false);
+    }
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::nullifyColumn(const int _index) {
+    setColumn(_index, Chain<_CoefficientType, COLUMN, _StorageType>(getRowCount()));
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::nullifyRow(const int _index) {
+    setRow(_index, Chain<_CoefficientType, ROW, _StorageType>(getColumnCount()));
+}
+
+template <typename _CoefficientType, typename _StorageType>
+bool SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::isNullColumn(const int _index) const {
+    columns.checkChainIndex(_index);
+
+    return columns.chains[_index].size() == 0;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+bool SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::isNullRow(const int _index) const {
+    rows.checkChainIndex(_index);
+
+    return rows.chains[_index].size() == 0;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator/=(const std::vector<int> &_indexes) {
+    return *this /= IndexSet(std::max(getRowCount(), getColumnCount()), _indexes);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator/=(const int *_indexes) {
+    std::vector<int> indexes;
+
+    for (const int *index = _indexes ; *index >= 0 ; index++) {
+        indexes.push_back(*index);
+    }
+
+    return *this /= indexes;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::operator/=(const IndexSet &_indexes) {
+    columns /= _indexes;
+    rows /= _indexes;
+
+    return *this;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::restriction(const IndexSet &_indexes) const {
+    SparseMatrix result;
+    result.columns = columns.restriction(_indexes);
+    result.rows = rows.restriction(_indexes);
+
+    return result;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::permuted(const Permutation &_rows, const Permutation &_columns) const {
+    SparseMatrix result;
+    result.columns = columns.permuted(_rows, _columns);
+    result.rows = rows.permuted(_rows, _columns);
+
+    return result;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::shrinkToFit() {
+    columns.shrinkToFit();
+    rows.shrinkToFit();
+}
+
+template <typename _CoefficientType, typename _StorageType>
+SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType> SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::transpose() const {
+    SparseMatrix result(0, 0);
+
+    result.columns = rows.transpose();
+    result.rows = columns.transpose();
+
+    return result;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline const typename SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::ColumnMatrix& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getColumnMatrix() const noexcept {
+    return columns;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline const typename SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::RowMatrix& SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getRowMatrix() const noexcept {
+    return rows;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline int SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getRowCount() const noexcept {
+    return columns.rowCount;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline int SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getColumnCount() const noexcept {
+    return columns.columnCount;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline void SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::setThreadPool(ThreadPool *_threadPool) noexcept {
+    columns.setThreadPool(_threadPool);
+    rows.setThreadPool(_threadPool);
+}
+
+template <typename _CoefficientType, typename _StorageType>
+inline ThreadPool* SparseMatrix<_CoefficientType, COLUMN | ROW, _StorageType>::getThreadPool() const noexcept {
+    return columns.getThreadPool();
+}
+
+/**
+ * \brief Perform matrix multiplication with a matrix indexed both ways.
+ * 
+ * The view of the matrix indexed both ways matching the other operand chain type is used.
+ * 
+ * \param[in] _first The first matrix, indexed both ways.
+ * \param[in] _second The second matrix.
+ * 
+ * \return The result of the matrix multiplication, column-based.
+ */
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const SparseMatrix<_CT, COLUMN | ROW, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second) {
+    if constexpr (_CTF == COLUMN) {
+        return _first.getColumnMatrix() * _second;
+    } else {
+        return _first.getRowMatrix() * _second;
+    }
+}
+
+/**
+ * \brief Perform matrix multiplication with a matrix indexed both ways.
+ * 
+ * The view of the matrix indexed both ways matching the other operand chain type is used.
+ * 
+ * \param[in] _first The first matrix.
+ * \param[in] _second The second matrix, indexed both ways.
+ * 
+ * \return The result of the matrix multiplication, column-based.
+ */
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, COLUMN | ROW, _ST> &_second) {
+    if constexpr (_CTF == COLUMN) {
+        return _first * _second.getColumnMatrix();
+    } else {
+        return _first * _second.getRowMatrix();
+    }
+}
+
+/**
+ * \brief Perform matrix multiplication between matrices indexed both ways.
+ * 
+ * Both column-based views are used.
+ * 
+ * \param[in] _first The first matrix.
+ * \param[in] _second The second matrix.
+ * 
+ * \return The result of the matrix multiplication, column-based.
+ */
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, COLUMN, _ST> operator*(const SparseMatrix<_CT, COLUMN | ROW, _ST> &_first, const SparseMatrix<_CT, COLUMN | ROW, _ST> &_second) {
+    return _first.getColumnMatrix() * _second.getColumnMatrix();
+}
+
+/**
+ * \brief Perform matrix multiplication with a matrix indexed both ways.
+ * 
+ * The view of the matrix indexed both ways matching the other operand chain type is used.
+ * 
+ * \param[in] _first The first matrix, indexed both ways.
+ * \param[in] _second The second matrix.
+ * 
+ * \return The result of the matrix multiplication, row-based.
+ */
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const SparseMatrix<_CT, COLUMN | ROW, _ST> &_first, const SparseMatrix<_CT, _CTF, _ST> &_second) {
+    if constexpr (_CTF == COLUMN) {
+        return _first.getColumnMatrix() % _second;
+    } else {
+        return _first.getRowMatrix() % _second;
+    }
+}
+
+/**
+ * \brief Perform matrix multiplication with a matrix indexed both ways.
+ * 
+ * The view of the matrix indexed both ways matching the other operand chain type is used.
+ * 
+ * \param[in] _first The first matrix.
+ * \param[in] _second The second matrix, indexed both ways.
+ * 
+ * \return The result of the matrix multiplication, row-based.
+ */
+template <typename _CT, int _CTF, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const SparseMatrix<_CT, _CTF, _ST> &_first, const SparseMatrix<_CT, COLUMN | ROW, _ST> &_second) {
+    if constexpr (_CTF == COLUMN) {
+        return _first % _second.getColumnMatrix();
+    } else {
+        return _first % _second.getRowMatrix();
+    }
+}
+
+/**
+ * \brief Perform matrix multiplication between matrices indexed both ways.
+ * 
+ * Both row-based views are used.
+ * 
+ * \param[in] _first The first matrix.
+ * \param[in] _second The second matrix.
+ * 
+ * \return The result of the matrix multiplication, row-based.
+ */
+template <typename _CT, typename _ST>
+SparseMatrix<_CT, ROW, _ST> operator%(const SparseMatrix<_CT, COLUMN | ROW, _ST> &_first, const SparseMatrix<_CT, COLUMN | ROW, _ST> &_second) {
+    return _first.getRowMatrix() % _second.getRowMatrix();
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,2215 @@
+/**
+ * \file Storage.hpp
+ * \brief Storage policies of the chain entries.
+ *
+ * Define everything for the Chain storage policies
+ */
+
+#ifndef __OSM_STORAGE__
+#define __OSM_STORAGE__
+
+
+#include "__base.hpp"
+#include "SmallVector.hpp"
+#include "Coefficient.hpp"
+#include "SparseKernels.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \brief A storage and the factor applied to it, a term of a linear combination.
+ *
+ * \see \link OSM::ChainExpression \endlink
+ */
+template <typename _StorageType, typename _CoefficientType>
+struct ScaledStorage {
+    /** \brief The combined storage. */
+    const _StorageType *storage;
+
+    /** \brief The factor applied to the storage. */
+    _CoefficientType factor;
+};
+
+/**
+ * \brief Stateless allocator of over-aligned arrays, used for the tiles of OSM::HybridStorage.
+ *
+ * \tparam _Type The allocated type.
+ * \tparam _Alignment The alignment of the arrays in bytes.
+ */
+template <typename _Type, std::size_t _Alignment>
+struct AlignedAllocator {
+    typedef _Type value_type;
+    typedef std::true_type is_always_equal;
+
+    template <typename _Other>
+    struct rebind {
+        typedef AlignedAllocator<_Other, _Alignment> other;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename _Other>
+    AlignedAllocator(const AlignedAllocator<_Other, _Alignment>&) noexcept {}
+
+    _Type* allocate(const std::size_t _count) { return static_cast<_Type*>(::operator new(_count * sizeof(_Type), std::align_val_t(_Alignment))); }
+    void deallocate(_Type *_pointer, const std::size_t) noexcept { ::operator delete(_pointer, std::align_val_t(_Alignment)); }
+
+    bool operator==(const AlignedAllocator&) const noexcept { return true; }
+    bool operator!=(const AlignedAllocator&) const noexcept { return false; }
+};
+
+/**
+ * \class SortedStorage
+ * \brief Sorted flat-array storage policy for chains.
+ *
+ * Stores the chain as two contiguous arrays sorted by index, one for the indexes and one for the coefficients.
+ * Addition and substraction are linear merges over those arrays, the dot product an intersection of the index arrays.
+ *
+ * With a non zero _InlineCapacity, the first entries are stored inside the storage object itself and the arrays
+ * only move to the heap when they overflow, so short chains never allocate.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _InlineCapacity The number of entries stored inline before moving to the heap (default is 0)
+ * \tparam _Allocator The stateless allocator of the arrays, rebound for the indexes (default is std::allocator)
+ *
+ * \see \link OSM::SmallVector \endlink
+ * \see \link OSM::PoolAllocator \endlink
+ */
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+class SortedStorage {
+
+public:
+    /**
+     * \brief Pointer-like wrapper returned by the iterators arrow operator.
+     *
+     * The entries are not stored as pairs, the iterator builds a pair of references on the fly.
+     */
+    template <typename _Reference>
+    struct ArrowProxy {
+        /** \brief The proxied entry. */
+        _Reference entry;
+
+        /** \brief Access the proxied entry. */
+        _Reference* operator->() noexcept { return &entry; }
+    };
+
+    /**
+     * \class Iterator
+     * \brief Iterator over the (index, coefficient) entries of the storage.
+     *
+     * Dereferencing gives a pair of references, so `it->first` is the index and `it->second` the coefficient.
+     *
+     * \tparam _IsConst Whether the coefficients can be modified through the iterator.
+     */
+    template <bool _IsConst>
+    class Iterator {
+
+    public:
+        typedef typename std::conditional<_IsConst, const _CoefficientType, _CoefficientType>::type value_coefficient;
+        typedef std::pair<const int&, value_coefficient&> reference;
+        typedef std::pair<const int, _CoefficientType> value_type;
+        typedef ArrowProxy<reference> pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::bidirectional_iterator_tag iterator_category;
+
+    private:
+        /** \brief The current index. */
+        const int *index;
+
+        /** \brief The current coefficient. */
+        value_coefficient *coefficient;
+
+    public:
+        Iterator() noexcept : index(nullptr), coefficient(nullptr) {}
+        Iterator(const int *_index, value_coefficient *_coefficient) noexcept : index(_index), coefficient(_coefficient) {}
+
+        /** \brief Allow conversion from mutable iterator to constant iterator. */
+        template <bool _OtherIsConst, typename = typename std::enable_if<_IsConst && !_OtherIsConst>::type>
+        Iterator(const Iterator<_OtherIsConst> &_other) noexcept : index(_other.index), coefficient(_other.coefficient) {}
+
+        reference operator*() const noexcept { return reference(*index, *coefficient); }
+        pointer operator->() const noexcept { return pointer{reference(*index, *coefficient)}; }
+
+        Iterator& operator++() noexcept { ++index; ++coefficient; return *this; }
+        Iterator operator++(int) noexcept { Iterator copy = *this; ++(*this); return copy; }
+        Iterator& operator--() noexcept { --index; --coefficient; return *this; }
+        Iterator operator--(int) noexcept { Iterator copy = *this; --(*this); return copy; }
+
+        bool operator==(const Iterator &_other) const noexcept { return index == _other.index; }
+        bool operator!=(const Iterator &_other) const noexcept { return index != _other.index; }
+
+        template <bool>
+        friend class Iterator;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    /** \brief The type returned by OSM::SortedStorage::access. */
+    typedef _CoefficientType& reference;
+
+    /** \brief Whether the entries are stored in the flat arrays returned by indexData and coefficientData. */
+    static constexpr bool CONTIGUOUS = true;
+
+    /** \brief The array type used for the indexes. */
+    typedef typename std::conditional<
+        _InlineCapacity == 0,
+        std::vector<int, typename std::allocator_traits<_Allocator>::template rebind_alloc<int>>,
+        SmallVector<int, _InlineCapacity, typename std::allocator_traits<_Allocator>::template rebind_alloc<int>>
+    >::type IndexContainer;
+
+    /** \brief The array type used for the coefficients. */
+    typedef typename std::conditional<
+        _InlineCapacity == 0,
+        std::vector<_CoefficientType, typename std::allocator_traits<_Allocator>::template rebind_alloc<_CoefficientType>>,
+        SmallVector<_CoefficientType, _InlineCapacity, typename std::allocator_traits<_Allocator>::template rebind_alloc<_CoefficientType>>
+    >::type CoefficientContainer;
+
+private:
+    /** \brief The sorted indexes of the non zero coefficients. */
+    IndexContainer indexes;
+
+    /** \brief The coefficients, stored in the same order as the indexes. */
+    CoefficientContainer coefficients;
+
+public:
+    /**
+     * \brief Number of stored coefficients.
+     *
+     * \return The number of stored coefficients.
+     */
+    std::size_t size() const noexcept { return indexes.size(); }
+
+    /**
+     * \brief Checks if the storage holds no coefficient.
+     *
+     * \return true if the storage is empty, false otherwise.
+     */
+    bool empty() const noexcept { return indexes.empty(); }
+
+    /**
+     * \brief Removes all coefficients.
+     *
+     * \note Keeps the allocated capacity.
+     */
+    void clear() noexcept;
+
+    /**
+     * \brief Preallocates room for coefficients.
+     *
+     * \param[in] _capacity The number of coefficients to preallocate.
+     */
+    void reserve(const std::size_t _capacity);
+
+    /** \brief Number of coefficients the storage holds without reallocating. */
+    std::size_t capacity() const noexcept { return indexes.capacity(); }
+
+    /**
+     * \brief Gives back the capacity left unused, after cancellations for instance.
+     */
+    void shrinkToFit();
+
+    /**
+     * \brief Get a coefficient from the storage.
+     *
+     * \param[in] _index The coefficient index.
+     *
+     * \return The stored coefficient, 0 if the index is not stored.
+     */
+    _CoefficientType get(const int _index) const;
+
+    /**
+     * \brief Greatest stored index.
+     *
+     * \return The last index, -1 if the storage is empty.
+     */
+    int lastIndex() const noexcept { return indexes.empty() ? -1 : indexes.back(); }
+
+    /**
+     * \brief Access a coefficient from the storage.
+     *
+     * Inserts a null coefficient if the index is not stored.
+     *
+     * \warning The reference is invalidated by the next insertion or removal.
+     *
+     * \param[in] _index The coefficient index.
+     *
+     * \return The reference to the stored coefficient.
+     */
+    _CoefficientType& access(const int _index);
+
+    /**
+     * \brief Removes a coefficient from the storage.
+     *
+     * \param[in] _index The coefficient index.
+     */
+    void erase(const int _index);
+
+    /**
+     * \brief Appends a coefficient at the end of the storage.
+     *
+     * \pre The index is greater than every stored index.
+     *
+     * \param[in] _index The coefficient index.
+     * \param[in] _coefficient The coefficient.
+     */
+    void append(const int _index, const _CoefficientType _coefficient) {
+        indexes.push_back(_index);
+        coefficients.push_back(_coefficient);
+    }
+
+    /**
+     * \brief Adds sorted entries to the storage.
+     *
+     * Performs an in-place backward merge, entries cancelling to zero are dropped.
+     *
+     * \pre The given indexes are sorted and unique.
+     *
+     * \param[in] _otherIndexes The indexes to add.
+     * \param[in] _otherCoefficients The coefficients to add.
+     * \param[in] _otherSize The number of entries to add.
+     */
+    void add(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize);
+
+    /**
+     * \brief Substracts sorted entries from the storage.
+     *
+     * Performs an in-place backward merge, entries cancelling to zero are dropped.
+     *
+     * \pre The given indexes are sorted and unique.
+     *
+     * \param[in] _otherIndexes The indexes to substract.
+     * \param[in] _otherCoefficients The coefficients to substract.
+     * \param[in] _otherSize The number of entries to substract.
+     */
+    void subtract(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize);
+
+    /**
+     * \brief Adds another storage.
+     *
+     * \param[in] _other The storage to add.
+     */
+    void add(const SortedStorage &_other);
+
+    /**
+     * \brief Substracts another storage.
+     *
+     * \param[in] _other The storage to substract.
+     */
+    void subtract(const SortedStorage &_other);
+
+    /**
+     * \brief Adds scaled sorted entries to the storage.
+     *
+     * Fused `this += _lambda * other` in a single in-place backward merge, entries cancelling to zero are dropped.
+     *
+     * \pre The given indexes are sorted and unique.
+     *
+     * \param[in] _lambda The factor applied to the added entries.
+     * \param[in] _otherIndexes The indexes to add.
+     * \param[in] _otherCoefficients The coefficients to add.
+     * \param[in] _otherSize The number of entries to add.
+     */
+    void addScaled(const _CoefficientType _lambda, const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize);
+
+    /**
+     * \brief Adds another scaled storage.
+     *
+     * \param[in] _lambda The factor applied to the other storage.
+     * \param[in] _other The storage to add.
+     */
+    void addScaled(const _CoefficientType _lambda, const SortedStorage &_other);
+
+    /**
+     * \brief Overwrites the storage with a linear combination of storages.
+     *
+     * All terms are merged together in a single pass appending to the cleared storage,
+     * entries cancelling to zero are dropped. The storage may be one of the terms.
+     *
+     * \param[in] _terms The scaled storages to sum.
+     * \param[in] _termCount The number of terms.
+     */
+    void assignCombination(const ScaledStorage<SortedStorage, _CoefficientType> *_terms, const std::size_t _termCount);
+
+    /**
+     * \brief Apply factor on each coefficients.
+     *
+     * \note Clears the storage if _lambda is 0.
+     *
+     * \param[in] _lambda The factor to apply.
+     */
+    void scale(const _CoefficientType _lambda);
+
+    /**
+     * \brief Renumbers the indexes, dropping some of them.
+     *
+     * \pre The map is increasing on the kept indexes.
+     *
+     * \param[in] _map Function giving the new index of an index, -1 to drop it.
+     *
+     * \see \link OSM::IndexSet \endlink
+     */
+    template <typename _IndexMap>
+    void remapIndexes(const _IndexMap &_map);
+
+    /**
+     * \brief Renumbers the indexes with any injective map, sorting them again.
+     *
+     * \param[in] _map Function giving the new index of an index.
+     *
+     * \see \link OSM::Permutation \endlink
+     */
+    template <typename _IndexMap>
+    void permuteIndexes(const _IndexMap &_map);
+
+    /**
+     * \brief Perform dot product between two sets of sorted entries.
+     *
+     * Intersection of the two index arrays, a linear merge or a galloping search when their sizes are far apart.
+     *
+     * \see \link OSM::SparseKernels::intersectionDot \endlink
+     *
+     * \pre The given indexes are sorted and unique.
+     *
+     * \return The result of type _CoefficientType.
+     */
+    static _CoefficientType dot(
+        const int *_firstIndexes, const _CoefficientType *_firstCoefficients, const std::size_t _firstSize,
+        const int *_secondIndexes, const _CoefficientType *_secondCoefficients, const std::size_t _secondSize
+    );
+
+    /**
+     * \brief Perform dot product between two storages.
+     *
+     * \param[in] _first The first storage.
+     * \param[in] _second The second storage.
+     *
+     * \return The result of type _CoefficientType.
+     */
+    static _CoefficientType dot(const SortedStorage &_first, const SortedStorage &_second);
+
+    /** \brief Raw pointer to the sorted indexes. */
+    const int* indexData() const noexcept { return indexes.data(); }
+
+    /** \brief Raw pointer to the coefficients. */
+    const _CoefficientType* coefficientData() const noexcept { return coefficients.data(); }
+
+    /** \brief Raw pointer to the coefficients. */
+    _CoefficientType* coefficientData() noexcept { return coefficients.data(); }
+
+    iterator begin() noexcept { return iterator(indexes.data(), coefficients.data()); }
+    const_iterator begin() const noexcept { return const_iterator(indexes.data(), coefficients.data()); }
+    iterator end() noexcept { return iterator(indexes.data() + indexes.size(), coefficients.data() + coefficients.size()); }
+    const_iterator end() const noexcept { return const_iterator(indexes.data() + indexes.size(), coefficients.data() + coefficients.size()); }
+
+private:
+    /**
+     * \brief Merge sorted entries into the storage, from the back.
+     *
+     * The storage is grown to hold both inputs, entries are written from the end so that no read entry is overwritten,
+     * then the result is shifted to the front.
+     *
+     * \param[in] _factor The factor applied to the merged entries.
+     */
+    void merge(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize, const _CoefficientType _factor);
+};
+
+/**
+ * \class MapStorage
+ * \brief Hash map storage policy for chains.
+ *
+ * Stores the chain in a std::unordered_map, giving constant time random access.
+ *
+ * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+ * \tparam _Allocator The stateless allocator of the map nodes and buckets (default is std::allocator)
+ */
+template <typename _CoefficientType, typename _Allocator>
+class MapStorage {
+
+public:
+    /** \brief The map type, using the allocator rebound to its entries. */
+    typedef std::unordered_map<
+        int, _CoefficientType, std::hash<int>, std::equal_to<int>,
+        typename std::allocator_traits<_Allocator>::template rebind_alloc<std::pair<const int, _CoefficientType>>
+    > Map;
+
+    typedef typename Map::iterator iterator;
+    typedef typename Map::const_iterator const_iterator;
+
+    /** \brief The type returned by OSM::MapStorage::access. */
+    typedef _CoefficientType& reference;
+
+    /** \brief Whether the entries are stored in flat arrays. */
+    static constexpr bool CONTIGUOUS = false;
+
+private:
+    /** \brief The inner representation and storage of data. */
+    Map data;
+
+public:
+    /** \brief Number of stored coefficients. */
+    std::size_t size() const noexcept { return data.size(); }
+
+    /** \brief Checks if the storage holds no coefficient. */
+    bool empty() const noexcept { return data.empty(); }
+
+    /** \brief Removes all coefficients. */
+    void clear() noexcept { data.clear(); }
+
+    /** \brief Preallocates room for coefficients. */
+    void reserve(const std::size_t _capacity) { data.reserve(_capacity); }
+
+    /** \brief Number of buckets, a change of it is a rehash. */
+    std::size_t capacity() const noexcept { return data.bucket_count(); }
+
+    /** \brief Gives back the buckets left unused, after cancellations for instance. */
+    void shrinkToFit() { data.rehash(0); }
+
+    /** \brief Get a coefficient, 0 if the index is not stored. */
+    _CoefficientType get(const int _index) const;
+
+    /** \brief Greatest stored index, -1 if the storage is empty. */
+    int lastIndex() const noexcept;
+
+    /** \brief Access a coefficient, inserts a null coefficient if the index is not stored. */
+    _CoefficientType& access(const int _index) { return data[_index]; }
+
+    /** \brief Removes a coefficient. */
+    void erase(const int _index) { data.erase(_index); }
+
+    /** \brief Inserts a coefficient, the index must not be stored yet. */
+    void append(const int _index, const _CoefficientType _coefficient) { data.emplace(_index, _coefficient); }
+
+    /** \brief Adds another storage, entries cancelling to zero are dropped. */
+    void add(const MapStorage &_other);
+
+    /** \brief Substracts another storage, entries cancelling to zero are dropped. */
+    void subtract(const MapStorage &_other);
+
+    /** \brief Adds another storage scaled by _lambda, entries cancelling to zero are dropped. */
+    void addScaled(const _CoefficientType _lambda, const MapStorage &_other);
+
+    /** \brief Overwrites the storage with a linear combination of storages, which may include the storage itself. */
+    void assignCombination(const ScaledStorage<MapStorage, _CoefficientType> *_terms, const std::size_t _termCount);
+
+    /** \brief Apply factor on each coefficients, clears the storage if _lambda is 0. */
+    void scale(const _CoefficientType _lambda);
+
+    /** \brief Renumbers the indexes with an increasing map, dropping the ones mapped to -1. */
+    template <typename _IndexMap>
+    void remapIndexes(const _IndexMap &_map);
+
+    /** \brief Renumbers the indexes with any injective map, the map keeps no order. */
+    template <typename _IndexMap>
+    void permuteIndexes(const _IndexMap &_map) { remapIndexes(_map); }
+
+    /** \brief Perform dot product between two storages, looking up the smallest one into the largest one. */
+    static _CoefficientType dot(const MapStorage &_first, const MapStorage &_second);
+
+    iterator begin() noexcept { return data.begin(); }
+    const_iterator begin() const noexcept { return data.begin(); }
+    iterator end() noexcept { return data.end(); }
+    const_iterator end() const noexcept { return data.end(); }
+};
+
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::clear() noexcept {
+    indexes.clear();
+    coefficients.clear();
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::reserve(const std::size_t _capacity) {
+    indexes.reserve(_capacity);
+    coefficients.reserve(_capacity);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::shrinkToFit() {
+    if constexpr (_InlineCapacity == 0) {
+        indexes.shrink_to_fit();
+        coefficients.shrink_to_fit();
+    } else {
+        indexes.shrinkToFit();
+        coefficients.shrinkToFit();
+    }
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+_CoefficientType SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::get(const int _index) const {
+    typename IndexContainer::const_iterator position = std::lower_bound(indexes.begin(), indexes.end(), _index);
+
+    if (position == indexes.end() || *position != _index) {
+        return _CoefficientType(0);
+    }
+
+    return coefficients[position - indexes.begin()];
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+_CoefficientType& SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::access(const int _index) {
+    typename IndexContainer::iterator position = std::lower_bound(indexes.begin(), indexes.end(), _index);
+    std::ptrdiff_t offset = position - indexes.begin();
+
+    if (position == indexes.end() || *position != _index) {
+        indexes.insert(position, _index);
+        coefficients.insert(coefficients.begin() + offset, _CoefficientType(0));
+    }
+
+    return coefficients[offset];
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::erase(const int _index) {
+    typename IndexContainer::iterator position = std::lower_bound(indexes.begin(), indexes.end(), _index);
+
+    if (position == indexes.end() || *position != _index) {
+        return;
+    }
+
+    coefficients.erase(coefficients.begin() + (position - indexes.begin()));
+    indexes.erase(position);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::merge(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize, const _CoefficientType _factor) {
+    if (_otherSize == 0 || _factor == _CoefficientType(0)) {
+        return;
+    }
+
+    std::ptrdiff_t first = indexes.size() - 1;
+    std::ptrdiff_t second = _otherSize - 1;
+    std::ptrdiff_t write = indexes.size() + _otherSize;
+
+    indexes.resize(write);
+    coefficients.resize(write);
+
+    while (second >= 0) {
+        if (first >= 0 && indexes[first] > _otherIndexes[second]) {
+            --write;
+            indexes[write] = indexes[first];
+            coefficients[write] = coefficients[first];
+            --first;
+        } else if (first >= 0 && indexes[first] == _otherIndexes[second]) {
+            _CoefficientType value = coefficients[first] + _factor * _otherCoefficients[second];
+
+            if (value != _CoefficientType(0)) {
+                --write;
+                indexes[write] = indexes[first];
+                coefficients[write] = value;
+            }
+            --first;
+            --second;
+        } else {
+            _CoefficientType value = _factor * _otherCoefficients[second];
+
+            if (value != _CoefficientType(0)) {
+                --write;
+                indexes[write] = _otherIndexes[second];
+                coefficients[write] = value;
+            }
+            --second;
+        }
+    }
+
+    // The remaining entries of the storage are already in place if nothing was dropped.
+    if (write == first + 1) {
+        return;
+    }
+
+    while (first >= 0) {
+        --write;
+        indexes[write] = indexes[first];
+        coefficients[write] = coefficients[first];
+        --first;
+    }
+
+    indexes.erase(indexes.begin(), indexes.begin() + write);
+    coefficients.erase(coefficients.begin(), coefficients.begin() + write);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::add(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize) {
+    merge(_otherIndexes, _otherCoefficients, _otherSize, _CoefficientType(1));
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::subtract(const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize) {
+    merge(_otherIndexes, _otherCoefficients, _otherSize, _CoefficientType(-1));
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::add(const SortedStorage &_other) {
+    if (&_other == this) {
+        scale(_CoefficientType(2));
+        return;
+    }
+
+    merge(_other.indexes.data(), _other.coefficients.data(), _other.size(), _CoefficientType(1));
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::subtract(const SortedStorage &_other) {
+    if (&_other == this) {
+        clear();
+        return;
+    }
+
+    merge(_other.indexes.data(), _other.coefficients.data(), _other.size(), _CoefficientType(-1));
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::addScaled(const _CoefficientType _lambda, const int *_otherIndexes, const _CoefficientType *_otherCoefficients, const std::size_t _otherSize) {
+    merge(_otherIndexes, _otherCoefficients, _otherSize, _lambda);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::addScaled(const _CoefficientType _lambda, const SortedStorage &_other) {
+    if (&_other == this) {
+        scale(_CoefficientType(1) + _lambda);
+        return;
+    }
+
+    merge(_other.indexes.data(), _other.coefficients.data(), _other.size(), _lambda);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::assignCombination(const ScaledStorage<SortedStorage, _CoefficientType> *_terms, const std::size_t _termCount) {
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        if (_terms[term].storage == this) {
+            SortedStorage result;
+            result.assignCombination(_terms, _termCount);
+            *this = std::move(result);
+            return;
+        }
+    }
+
+    std::size_t totalSize = 0;
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        totalSize += _terms[term].storage->size();
+    }
+
+    clear();
+    reserve(totalSize);
+
+    // A cursor per term, the next index is found by a linear scan as combinations are short.
+    SmallVector<std::size_t, 8> cursors;
+    cursors.resize(_termCount);
+
+    while (true) {
+        int index = 0;
+        bool found = false;
+
+        for (std::size_t term = 0 ; term < _termCount ; term++) {
+            const SortedStorage &storage = *_terms[term].storage;
+
+            if (cursors[term] < storage.size() && (!found || storage.indexes[cursors[term]] < index)) {
+                index = storage.indexes[cursors[term]];
+                found = true;
+            }
+        }
+
+        if (!found) {
+            return;
+        }
+
+        _CoefficientType value = _CoefficientType(0);
+        for (std::size_t term = 0 ; term < _termCount ; term++) {
+            const SortedStorage &storage = *_terms[term].storage;
+
+            if (cursors[term] < storage.size() && storage.indexes[cursors[term]] == index) {
+                value += storage.coefficients[cursors[term]] * _terms[term].factor;
+                cursors[term]++;
+            }
+        }
+
+        if (value != _CoefficientType(0)) {
+            append(index, value);
+        }
+    }
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::scale(const _CoefficientType _lambda) {
+    if (_lambda == _CoefficientType(0)) {
+        clear();
+        return;
+    }
+
+    for (_CoefficientType &coefficient : coefficients) {
+        coefficient *= _lambda;
+    }
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+template <typename _IndexMap>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::remapIndexes(const _IndexMap &_map) {
+    std::size_t write = 0;
+
+    for (std::size_t read = 0 ; read < indexes.size() ; read++) {
+        const int index = _map(indexes[read]);
+
+        if (index >= 0) {
+            indexes[write] = index;
+            coefficients[write] = coefficients[read];
+            write++;
+        }
+    }
+
+    indexes.resize(write);
+    coefficients.resize(write);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+template <typename _IndexMap>
+void SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::permuteIndexes(const _IndexMap &_map) {
+    bool sorted = true;
+
+    for (std::size_t entry = 0 ; entry < indexes.size() ; entry++) {
+        indexes[entry] = _map(indexes[entry]);
+        sorted = sorted && (entry == 0 || indexes[entry - 1] < indexes[entry]);
+    }
+
+    if (sorted) {
+        return;
+    }
+
+    std::vector<std::pair<int, _CoefficientType>> entries;
+    entries.reserve(indexes.size());
+
+    for (std::size_t entry = 0 ; entry < indexes.size() ; entry++) {
+        entries.emplace_back(indexes[entry], coefficients[entry]);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const std::pair<int, _CoefficientType> &_first, const std::pair<int, _CoefficientType> &_second) {
+        return _first.first < _second.first;
+    });
+
+    for (std::size_t entry = 0 ; entry < entries.size() ; entry++) {
+        indexes[entry] = entries[entry].first;
+        coefficients[entry] = entries[entry].second;
+    }
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+_CoefficientType SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::dot(
+    const int *_firstIndexes, const _CoefficientType *_firstCoefficients, const std::size_t _firstSize,
+    const int *_secondIndexes, const _CoefficientType *_secondCoefficients, const std::size_t _secondSize
+) {
+    return SparseKernels<_CoefficientType>::intersectionDot(_firstIndexes, _firstCoefficients, _firstSize, _secondIndexes, _secondCoefficients, _secondSize);
+}
+
+template <typename _CoefficientType, std::size_t _InlineCapacity, typename _Allocator>
+_CoefficientType SortedStorage<_CoefficientType, _InlineCapacity, _Allocator>::dot(const SortedStorage &_first, const SortedStorage &_second) {
+    return dot(
+        _first.indexes.data(), _first.coefficients.data(), _first.size(),
+        _second.indexes.data(), _second.coefficients.data(), _second.size()
+    );
+}
+
+
+template <typename _CoefficientType, typename _Allocator>
+_CoefficientType MapStorage<_CoefficientType, _Allocator>::get(const int _index) const {
+    const_iterator position = data.find(_index);
+
+    if (position == data.end()) {
+        return _CoefficientType(0);
+    }
+
+    return position->second;
+}
+
+template <typename _CoefficientType, typename _Allocator>
+int MapStorage<_CoefficientType, _Allocator>::lastIndex() const noexcept {
+    int last = -1;
+
+    for (const std::pair<const int, _CoefficientType> &entry : data) {
+        last = std::max(last, entry.first);
+    }
+
+    return last;
+}
+
+template <typename _CoefficientType, typename _Allocator>
+void MapStorage<_CoefficientType, _Allocator>::add(const MapStorage &_other) {
+    if (&_other == this) {
+        scale(_CoefficientType(2));
+        return;
+    }
+
+    for (const std::pair<const int, _CoefficientType> &entry : _other.data) {
+        _CoefficientType &coefficient = data[entry.first];
+        coefficient += entry.second;
+
+        if (coefficient == _CoefficientType(0)) {
+            data.erase(entry.first);
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _Allocator>
+void MapStorage<_CoefficientType, _Allocator>::subtract(const MapStorage &_other) {
+    if (&_other == this) {
+        clear();
+        return;
+    }
+
+    for (const std::pair<const int, _CoefficientType> &entry : _other.data) {
+        _CoefficientType &coefficient = data[entry.first];
+        coefficient -= entry.second;
+
+        if (coefficient == _CoefficientType(0)) {
+            data.erase(entry.first);
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _Allocator>
+void MapStorage<_CoefficientType, _Allocator>::addScaled(const _CoefficientType _lambda, const MapStorage &_other) {
+    if (&_other == this) {
+        scale(_CoefficientType(1) + _lambda);
+        return;
+    }
+
+    if (_lambda == _CoefficientType(0)) {
+        return;
+    }
+
+    for (const std::pair<const int, _CoefficientType> &entry : _other.data) {
+        _CoefficientType &coefficient = data[entry.first];
+        coefficient += _lambda * entry.second;
+
+        if (coefficient == _CoefficientType(0)) {
+            data.erase(entry.first);
+        }
+    }
+}
+
+template <typename _CoefficientType, typename _Allocator>
+void MapStorage<_CoefficientType, _Allocator>::assignCombination(const ScaledStorage<MapStorage, _CoefficientType> *_terms, const std::size_t _termCount) {
+    Map result;
+
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        for (const std::pair<const int, _CoefficientType> &entry : _terms[term].storage->data) {
+            result[entry.first] += entry.second * _terms[term].factor;
+        }
+    }
+
+    for (typename Map::iterator it = result.begin() ; it != result.end() ; ) {
+        if (it->second == _CoefficientType(0)) {
+            it = result.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    data.swap(result);
+}
+
+template <typename _CoefficientType, typename _Allocator>
+void MapStorage<_CoefficientType, _Allocator>::scale(const _CoefficientType _lambda) {
+    if (_lambda == _CoefficientType(0)) {
+        clear();
+        return;
+    }
+
+    for (std::pair<const int, _CoefficientType> &entry : data) {
+        entry.second *= _lambda;
+    }
+}
+
+template <typename _CoefficientType, typename _Allocator>
+template <typename _IndexMap>
+void MapStorage<_CoefficientType, _Allocator>::remapIndexes(const _IndexMap &_map) {
+    Map remaining;
+    remaining.reserve(data.size());
+
+    for (const std::pair<const int, _CoefficientType> &entry : data) {
+        const int index = _map(entry.first);
+
+        if (index >= 0) {
+            remaining.emplace(index, entry.second);
+        }
+    }
+
+    data.swap(remaining);
+}
+
+template <typename _CoefficientType, typename _Allocator>
+_CoefficientType MapStorage<_CoefficientType, _Allocator>::dot(const MapStorage &_first, const MapStorage &_second) {
+    const MapStorage &smallest = _first.size() < _second.size() ? _first : _second;
+    const MapStorage &largest = _first.size() < _second.size() ? _second : _first;
+    _CoefficientType result = _CoefficientType(0);
+
+    for (const std::pair<const int, _CoefficientType> &entry : smallest.data) {
+        const_iterator position = largest.data.find(entry.first);
+
+        if (position != largest.data.end()) {
+            result += entry.second * position->second;
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * \class Z2Storage
+ * \brief Index set storage policy for Z/2Z chains.
+ *
+ * All stored coefficients of a Z/2Z chain are 1, so only the set of indexes is stored: as a sorted index array
+ * for sparse chains, or as a bitset for dense ones. The representation is chosen after each bulk operation from the
+ * chain density, the bitset being used when it is smaller than the index array.
+ * Addition and substraction are both a symmetric difference, performed over 64-bit words on bitsets.
+ *
+ * \see \link OSM::Z2Coefficient \endlink
+ */
+class Z2Storage {
+
+public:
+    /** \brief The minimal number of indexes before considering a bitset. */
+    static constexpr std::size_t MINIMAL_DENSE_SIZE = 64;
+
+    /** \brief Whether the entries are stored in flat arrays. */
+    static constexpr bool CONTIGUOUS = false;
+
+    /**
+     * \brief Proxy to a coefficient of the storage, returned by OSM::Z2Storage::access.
+     *
+     * Assigning the proxy inserts or removes the index.
+     */
+    class Reference {
+
+    private:
+        /** \brief The referenced storage. */
+        Z2Storage *storage;
+
+        /** \brief The referenced index. */
+        int index;
+
+    public:
+        Reference(Z2Storage *_storage, const int _index) noexcept : storage(_storage), index(_index) {}
+
+        operator Z2Coefficient() const { return storage->get(index); }
+
+        Reference& operator=(const Z2Coefficient _value) { storage->set(index, _value != Z2Coefficient(0)); return *this; }
+        Reference& operator=(const Reference &_other) { return *this = Z2Coefficient(_other); }
+        Reference& operator+=(const Z2Coefficient _value) { return *this = Z2Coefficient(*this) + _value; }
+        Reference& operator-=(const Z2Coefficient _value) { return *this = Z2Coefficient(*this) - _value; }
+        Reference& operator*=(const Z2Coefficient _value) { return *this = Z2Coefficient(*this) * _value; }
+    };
+
+    /** \brief Pointer-like wrapper returned by the iterators arrow operator. */
+    struct ArrowProxy {
+        /** \brief The proxied entry. */
+        std::pair<int, Z2Coefficient> entry;
+
+        /** \brief Access the proxied entry. */
+        const std::pair<int, Z2Coefficient>* operator->() const noexcept { return &entry; }
+    };
+
+    /**
+     * \class Iterator
+     * \brief Iterator over the (index, 1) entries of the storage, by increasing index.
+     *
+     * Walks the index array of a sparse storage, or the set bits of a dense one.
+     */
+    class Iterator {
+
+    public:
+        typedef std::pair<int, Z2Coefficient> reference;
+        typedef std::pair<const int, Z2Coefficient> value_type;
+        typedef ArrowProxy pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+    private:
+        /** \brief The current index of a sparse storage, null for a dense one. */
+        const int *index;
+
+        /** \brief The first word of a dense storage. */
+        const uint64_t *firstWord;
+
+        /** \brief The current word of a dense storage. */
+        const uint64_t *word;
+
+        /** \brief The end of the words of a dense storage. */
+        const uint64_t *lastWord;
+
+        /** \brief The bits of the current word not visited yet, the current one being the lowest. */
+        uint64_t bits;
+
+    public:
+        Iterator() noexcept : index(nullptr), firstWord(nullptr), word(nullptr), lastWord(nullptr), bits(0) {}
+
+        /** \brief Iterator over a sparse storage. */
+        explicit Iterator(const int *_index) noexcept : index(_index), firstWord(nullptr), word(nullptr), lastWord(nullptr), bits(0) {}
+
+        /** \brief Iterator over a dense storage, skips to the first set bit from _word. */
+        Iterator(const uint64_t *_firstWord, const uint64_t *_word, const uint64_t *_lastWord) noexcept :
+            index(nullptr), firstWord(_firstWord), word(_word), lastWord(_lastWord), bits(_word != _lastWord ? *_word : 0) {
+            skipEmptyWords();
+        }
+
+        int currentIndex() const noexcept {
+            return index != nullptr ? *index : static_cast<int>((word - firstWord) * 64) + countTrailingZeros(bits);
+        }
+
+        reference operator*() const noexcept { return reference(currentIndex(), Z2Coefficient(1)); }
+        pointer operator->() const noexcept { return pointer{reference(currentIndex(), Z2Coefficient(1))}; }
+
+        Iterator& operator++() noexcept {
+            if (index != nullptr) {
+                ++index;
+            } else {
+                bits &= bits - 1;
+                skipEmptyWords();
+            }
+            return *this;
+        }
+        Iterator operator++(int) noexcept { Iterator copy = *this; ++(*this); return copy; }
+
+        bool operator==(const Iterator &_other) const noexcept { return index == _other.index && word == _other.word && bits == _other.bits; }
+        bool operator!=(const Iterator &_other) const noexcept { return !(*this == _other); }
+
+    private:
+        void skipEmptyWords() noexcept {
+            while (bits == 0 && word != lastWord && ++word != lastWord) {
+                bits = *word;
+            }
+        }
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /** \brief The type returned by OSM::Z2Storage::access. */
+    typedef Reference reference;
+
+private:
+    /** \brief The sorted indexes, when sparse. */
+    std::vector<int> indexes;
+
+    /** \brief The bitset, when dense, without trailing null words. */
+    std::vector<uint64_t> words;
+
+    /** \brief The number of set bits, when dense. */
+    std::size_t count = 0;
+
+    /** \brief Whether the storage is a bitset. */
+    bool dense = false;
+
+public:
+    /** \brief Number of stored coefficients. */
+    std::size_t size() const noexcept { return dense ? count : indexes.size(); }
+
+    /** \brief Checks if the storage holds no coefficient. */
+    bool empty() const noexcept { return size() == 0; }
+
+    /** \brief Checks if the storage is currently a bitset. */
+    bool isDense() const noexcept { return dense; }
+
+    /** \brief Removes all coefficients, the storage becomes sparse. */
+    void clear() noexcept;
+
+    /** \brief Preallocates room for coefficients, when sparse. */
+    void reserve(const std::size_t _capacity);
+
+    /** \brief Number of indexes the storage holds without reallocating, every index of the words when dense. */
+    std::size_t capacity() const noexcept { return dense ? 64 * words.capacity() : indexes.capacity(); }
+
+    /** \brief Chooses the representation from the density and gives back the capacity left unused. */
+    void shrinkToFit();
+
+    /** \brief Get a coefficient, 0 if the index is not stored. */
+    Z2Coefficient get(const int _index) const;
+
+    /** \brief Greatest stored index, -1 if the storage is empty. */
+    int lastIndex() const noexcept;
+
+    /** \brief Access a coefficient through a proxy, assigning 0 removes the index. */
+    Reference access(const int _index) noexcept { return Reference(this, _index); }
+
+    /** \brief Removes a coefficient. */
+    void erase(const int _index) { set(_index, false); }
+
+    /** \brief Appends a coefficient, the index must be greater than every stored index. */
+    void append(const int _index, const Z2Coefficient _coefficient);
+
+    /** \brief Adds another storage, a symmetric difference of the index sets. */
+    void add(const Z2Storage &_other);
+
+    /** \brief Substracts another storage, the same as adding it. */
+    void subtract(const Z2Storage &_other) { add(_other); }
+
+    /** \brief Adds another storage scaled by _lambda, does nothing if _lambda is 0. */
+    void addScaled(const Z2Coefficient _lambda, const Z2Storage &_other);
+
+    /** \brief Overwrites the storage with a linear combination of storages, which may include the storage itself. */
+    void assignCombination(const ScaledStorage<Z2Storage, Z2Coefficient> *_terms, const std::size_t _termCount);
+
+    /** \brief Apply factor on each coefficients, clears the storage if _lambda is 0. */
+    void scale(const Z2Coefficient _lambda);
+
+    /** \brief Renumbers the indexes with an increasing map, dropping the ones mapped to -1. */
+    template <typename _IndexMap>
+    void remapIndexes(const _IndexMap &_map);
+
+    /** \brief Renumbers the indexes with any injective map, sorting them again. */
+    template <typename _IndexMap>
+    void permuteIndexes(const _IndexMap &_map);
+
+    /** \brief Perform dot product between two storages, the parity of their intersection. */
+    static Z2Coefficient dot(const Z2Storage &_first, const Z2Storage &_second);
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+private:
+    /**
+     * \brief Inserts or removes an index.
+     *
+     * \param[in] _index The index.
+     * \param[in] _value Whether the index is stored.
+     */
+    void set(const int _index, const bool _value);
+
+    /** \brief Symmetric difference with another storage, without choosing the representation. */
+    void toggle(const Z2Storage &_other);
+
+    /** \brief Converts the storage to a bitset. */
+    void toDense();
+
+    /** \brief Converts the storage to a sorted index array. */
+    void toSparse();
+
+    /** \brief Chooses the representation from the density. */
+    void normalize();
+};
+
+
+inline void Z2Storage::clear() noexcept {
+    indexes.clear();
+    words.clear();
+    count = 0;
+    dense = false;
+}
+
+inline void Z2Storage::reserve(const std::size_t _capacity) {
+    if (!dense) {
+        indexes.reserve(_capacity);
+    }
+}
+
+inline Z2Coefficient Z2Storage::get(const int _index) const {
+    if (dense) {
+        const std::size_t word = _index / 64;
+        return Z2Coefficient(_index >= 0 && word < words.size() && (words[word] >> (_index % 64) & 1) != 0);
+    }
+
+    return Z2Coefficient(std::binary_search(indexes.begin(), indexes.end(), _index));
+}
+
+inline int Z2Storage::lastIndex() const noexcept {
+    if (dense) {
+        return words.empty() ? -1 : static_cast<int>(words.size() * 64 - 1) - countLeadingZeros(words.back());
+    }
+
+    return indexes.empty() ? -1 : indexes.back();
+}
+
+inline void Z2Storage::set(const int _index, const bool _value) {
+    if (dense) {
+        const std::size_t word = _index / 64;
+        const uint64_t mask = uint64_t(1) << (_index % 64);
+
+        if (word >= words.size()) {
+            if (!_value) {
+                return;
+            }
+            words.resize(word + 1, 0);
+        }
+
+        if (((words[word] & mask) != 0) == _value) {
+            return;
+        }
+
+        words[word] ^= mask;
+        if (_value) {
+            count++;
+        } else {
+            count--;
+        }
+
+        while (!words.empty() && words.back() == 0) {
+            words.pop_back();
+        }
+        return;
+    }
+
+    std::vector<int>::iterator position = std::lower_bound(indexes.begin(), indexes.end(), _index);
+    const bool stored = position != indexes.end() && *position == _index;
+
+    if (_value && !stored) {
+        indexes.insert(position, _index);
+    } else if (!_value && stored) {
+        indexes.erase(position);
+    }
+}
+
+inline void Z2Storage::append(const int _index, const Z2Coefficient _coefficient) {
+    if (_coefficient == Z2Coefficient(0)) {
+        return;
+    }
+
+    if (dense) {
+        set(_index, true);
+    } else {
+        indexes.push_back(_index);
+    }
+}
+
+inline void Z2Storage::toggle(const Z2Storage &_other) {
+    if (_other.empty()) {
+        return;
+    }
+
+    if (!dense && _other.dense) {
+        toDense();
+    }
+
+    if (dense) {
+        if (_other.dense) {
+            if (words.size() < _other.words.size()) {
+                words.resize(_other.words.size(), 0);
+            }
+
+            std::size_t bitCount = 0;
+            for (std::size_t word = 0 ; word < words.size() ; word++) {
+                if (word < _other.words.size()) {
+                    words[word] ^= _other.words[word];
+                }
+                bitCount += populationCount(words[word]);
+            }
+            count = bitCount;
+
+            while (!words.empty() && words.back() == 0) {
+                words.pop_back();
+            }
+        } else {
+            for (int index : _other.indexes) {
+                set(index, get(index) == Z2Coefficient(0));
+            }
+        }
+        return;
+    }
+
+    // Both sparse, in-place backward merge keeping the indexes stored only once.
+    std::ptrdiff_t first = indexes.size() - 1;
+    std::ptrdiff_t second = _other.indexes.size() - 1;
+    std::ptrdiff_t write = indexes.size() + _other.indexes.size();
+
+    indexes.resize(write);
+
+    while (second >= 0) {
+        if (first >= 0 && indexes[first] > _other.indexes[second]) {
+            indexes[--write] = indexes[first--];
+        } else if (first >= 0 && indexes[first] == _other.indexes[second]) {
+            --first;
+            --second;
+        } else {
+            indexes[--write] = _other.indexes[second--];
+        }
+    }
+
+    if (write == first + 1) {
+        return;
+    }
+
+    while (first >= 0) {
+        indexes[--write] = indexes[first--];
+    }
+
+    indexes.erase(indexes.begin(), indexes.begin() + write);
+}
+
+inline void Z2Storage::add(const Z2Storage &_other) {
+    if (&_other == this) {
+        clear();
+        return;
+    }
+
+    toggle(_other);
+    normalize();
+}
+
+inline void Z2Storage::addScaled(const Z2Coefficient _lambda, const Z2Storage &_other) {
+    if (_lambda != Z2Coefficient(0)) {
+        add(_other);
+    }
+}
+
+inline void Z2Storage::assignCombination(const ScaledStorage<Z2Storage, Z2Coefficient> *_terms, const std::size_t _termCount) {
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        if (_terms[term].storage == this) {
+            Z2Storage result;
+            result.assignCombination(_terms, _termCount);
+            *this = std::move(result);
+            return;
+        }
+    }
+
+    clear();
+
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        if (_terms[term].factor != Z2Coefficient(0)) {
+            toggle(*_terms[term].storage);
+        }
+    }
+
+    normalize();
+}
+
+inline void Z2Storage::scale(const Z2Coefficient _lambda) {
+    if (_lambda == Z2Coefficient(0)) {
+        clear();
+    }
+}
+
+template <typename _IndexMap>
+void Z2Storage::remapIndexes(const _IndexMap &_map) {
+    toSparse();
+
+    std::size_t write = 0;
+
+    for (std::size_t read = 0 ; read < indexes.size() ; read++) {
+        const int index = _map(indexes[read]);
+
+        if (index >= 0) {
+            indexes[write++] = index;
+        }
+    }
+
+    indexes.resize(write);
+    normalize();
+}
+
+template <typename _IndexMap>
+void Z2Storage::permuteIndexes(const _IndexMap &_map) {
+    toSparse();
+
+    for (int &index : indexes) {
+        index = _map(index);
+    }
+
+    std::sort(indexes.begin(), indexes.end());
+    normalize();
+}
+
+inline Z2Coefficient Z2Storage::dot(const Z2Storage &_first, const Z2Storage &_second) {
+    std::size_t common = 0;
+
+    if (_first.dense && _second.dense) {
+        const std::size_t wordCount = std::min(_first.words.size(), _second.words.size());
+
+        for (std::size_t word = 0 ; word < wordCount ; word++) {
+            common += populationCount(_first.words[word] & _second.words[word]);
+        }
+    } else if (_first.dense || _second.dense) {
+        const Z2Storage &bitset = _first.dense ? _first : _second;
+        const Z2Storage &sparse = _first.dense ? _second : _first;
+
+        for (int index : sparse.indexes) {
+            common += static_cast<int>(bitset.get(index));
+        }
+    } else {
+        std::size_t first = 0;
+        std::size_t second = 0;
+
+        while (first < _first.indexes.size() && second < _second.indexes.size()) {
+            if (_first.indexes[first] < _second.indexes[second]) {
+                first++;
+            } else if (_first.indexes[first] > _second.indexes[second]) {
+                second++;
+            } else {
+                common++;
+                first++;
+                second++;
+            }
+        }
+    }
+
+    return Z2Coefficient(static_cast<int>(common & 1));
+}
+
+inline Z2Storage::const_iterator Z2Storage::begin() const noexcept {
+    if (dense) {
+        return const_iterator(words.data(), words.data(), words.data() + words.size());
+    }
+
+    return const_iterator(indexes.data());
+}
+
+inline Z2Storage::const_iterator Z2Storage::end() const noexcept {
+    if (dense) {
+        return const_iterator(words.data(), words.data() + words.size(), words.data() + words.size());
+    }
+
+    return const_iterator(indexes.data() + indexes.size());
+}
+
+inline void Z2Storage::shrinkToFit() {
+    normalize();
+    indexes.shrink_to_fit();
+    words.shrink_to_fit();
+}
+
+inline void Z2Storage::toDense() {
+    if (dense) {
+        return;
+    }
+
+    words.assign(indexes.empty() ? 0 : indexes.back() / 64 + 1, 0);
+    for (int index : indexes) {
+        words[index / 64] |= uint64_t(1) << (index % 64);
+    }
+
+    count = indexes.size();
+    indexes.clear();
+    dense = true;
+}
+
+inline void Z2Storage::toSparse() {
+    if (!dense) {
+        return;
+    }
+
+    indexes.clear();
+    indexes.reserve(count);
+    for (const_iterator it = begin() ; it != end() ; ++it) {
+        indexes.push_back(it->first);
+    }
+
+    words.clear();
+    count = 0;
+    dense = false;
+}
+
+inline void Z2Storage::normalize() {
+    // A word holds 64 indexes against 2 indexes in the sorted array, hysteresis avoids switching back and forth.
+    if (dense) {
+        if (count < MINIMAL_DENSE_SIZE / 2 || words.size() > count) {
+            toSparse();
+        }
+    } else if (indexes.size() >= MINIMAL_DENSE_SIZE && 2 * (indexes.back() / 64 + 1) <= static_cast<int>(indexes.size())) {
+        toDense();
+    }
+}
+
+
+/**
+ * \class HybridStorage
+ * \brief Storage policy switching between sorted arrays and a dense tile by density.
+ *
+ * A sparse chain is stored as an OSM::SortedStorage. Once at least half of the indexes of its range are stored, the
+ * chain moves to a dense tile: an aligned array of coefficients covering its range, starting at a multiple of
+ * TILE_WIDTH, where null coefficients are simply zeros. It goes back to sorted arrays when less than a quarter of the
+ * tile is used, or when it holds less than half of MINIMAL_DENSE_SIZE coefficients.
+ *
+ * The representation is chosen after each bulk operation, as done by OSM::Z2Storage, and while appending. The tiles
+ * of two chains start at multiples of TILE_WIDTH, so their common range is aligned in both and tile-tile additions and
+ * dot products run through the OSM::SparseKernels tile kernels. Iteration skips the zeros of a tile, the caller never
+ * sees the representation.
+ *
+ * \tparam _CoefficientType The chain's coefficient types.
+ *
+ * \see \link OSM::SortedStorage \endlink
+ * \see \link OSM::SparseKernels \endlink
+ */
+template <typename _CoefficientType>
+class HybridStorage {
+
+public:
+    /** \brief The minimal number of coefficients before considering a tile. */
+    static constexpr std::size_t MINIMAL_DENSE_SIZE = 64;
+
+    /** \brief The alignment of the tiles in bytes, the width of an AVX-512 register. */
+    static constexpr std::size_t TILE_ALIGNMENT = 64;
+
+    /** \brief The number of coefficients of an aligned line of a tile, tiles start at a multiple of it. */
+    static constexpr int TILE_WIDTH = sizeof(_CoefficientType) < TILE_ALIGNMENT ? static_cast<int>(TILE_ALIGNMENT / sizeof(_CoefficientType)) : 1;
+
+    /** \brief Whether the entries are stored in flat arrays. */
+    static constexpr bool CONTIGUOUS = false;
+
+    /** \brief The storage of sparse chains. */
+    typedef SortedStorage<_CoefficientType> SparseStorage;
+
+    /** \brief The array type of the tiles. */
+    typedef std::vector<_CoefficientType, AlignedAllocator<_CoefficientType, TILE_ALIGNMENT>> Tile;
+
+    /**
+     * \brief Proxy to a coefficient of the storage, returned by OSM::HybridStorage::access.
+     *
+     * Assigning the proxy inserts, modifies or removes the coefficient.
+     */
+    class Reference {
+
+    private:
+        /** \brief The referenced storage. */
+        HybridStorage *storage;
+
+        /** \brief The referenced index. */
+        int index;
+
+    public:
+        Reference(HybridStorage *_storage, const int _index) noexcept : storage(_storage), index(_index) {}
+
+        operator _CoefficientType() const { return storage->get(index); }
+
+        Reference& operator=(const _CoefficientType _value) { storage->set(index, _value); return *this; }
+        Reference& operator=(const Reference &_other) { return *this = _CoefficientType(_other); }
+        Reference& operator+=(const _CoefficientType _value) { return *this = _CoefficientType(*this) + _value; }
+        Reference& operator-=(const _CoefficientType _value) { return *this = _CoefficientType(*this) - _value; }
+        Reference& operator*=(const _CoefficientType _value) { return *this = _CoefficientType(*this) * _value; }
+    };
+
+    /** \brief Pointer-like wrapper returned by the iterators arrow operator. */
+    struct ArrowProxy {
+        /** \brief The proxied entry. */
+        std::pair<int, _CoefficientType> entry;
+
+        /** \brief Access the proxied entry. */
+        const std::pair<int, _CoefficientType>* operator->() const noexcept { return &entry; }
+    };
+
+    /**
+     * \class Iterator
+     * \brief Iterator over the non null entries of the storage, by increasing index.
+     *
+     * Walks the sorted arrays of a sparse storage, or the non null coefficients of a tile.
+     */
+    class Iterator {
+
+    public:
+        typedef std::pair<int, _CoefficientType> reference;
+        typedef std::pair<const int, _CoefficientType> value_type;
+        typedef ArrowProxy pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+    private:
+        /** \brief The current index of a sparse storage, null for a tile. */
+        const int *index;
+
+        /** \brief The current coefficient. */
+        const _CoefficientType *coefficient;
+
+        /** \brief The first coefficient of a tile. */
+        const _CoefficientType *firstCoefficient;
+
+        /** \brief The end of a tile. */
+        const _CoefficientType *lastCoefficient;
+
+        /** \brief The index of the first coefficient of a tile. */
+        int offset;
+
+    public:
+        Iterator() noexcept : index(nullptr), coefficient(nullptr), firstCoefficient(nullptr), lastCoefficient(nullptr), offset(0) {}
+
+        /** \brief Iterator over a sparse storage. */
+        Iterator(const int *_index, const _CoefficientType *_coefficient) noexcept :
+            index(_index), coefficient(_coefficient), firstCoefficient(nullptr), lastCoefficient(nullptr), offset(0) {}
+
+        /** \brief Iterator over a tile, skips to the first non null coefficient from _coefficient. */
+        Iterator(const _CoefficientType *_first, const _CoefficientType *_coefficient, const _CoefficientType *_last, const int _offset) noexcept :
+            index(nullptr), coefficient(_coefficient), firstCoefficient(_first), lastCoefficient(_last), offset(_offset) {
+            skipNullCoefficients();
+        }
+
+        int currentIndex() const noexcept {
+            return index != nullptr ? *index : offset + static_cast<int>(coefficient - firstCoefficient);
+        }
+
+        reference operator*() const noexcept { return reference(currentIndex(), *coefficient); }
+        pointer operator->() const noexcept { return pointer{reference(currentIndex(), *coefficient)}; }
+
+        Iterator& operator++() noexcept {
+            ++coefficient;
+            if (index != nullptr) {
+                ++index;
+            } else {
+                skipNullCoefficients();
+            }
+            return *this;
+        }
+        Iterator operator++(int) noexcept { Iterator copy = *this; ++(*this); return copy; }
+
+        bool operator==(const Iterator &_other) const noexcept { return coefficient == _other.coefficient; }
+        bool operator!=(const Iterator &_other) const noexcept { return coefficient != _other.coefficient; }
+
+    private:
+        void skipNullCoefficients() noexcept {
+            while (coefficient != lastCoefficient && *coefficient == _CoefficientType(0)) {
+                ++coefficient;
+            }
+        }
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /** \brief The type returned by OSM::HybridStorage::access. */
+    typedef Reference reference;
+
+private:
+    /** \brief A term of a combination of sparse storages. */
+    typedef ScaledStorage<SparseStorage, _CoefficientType> SparseTerm;
+
+    /** \brief The array type used for the terms of a combination of sparse storages. */
+    typedef typename std::conditional<
+        std::is_trivially_copyable<SparseTerm>::value, SmallVector<SparseTerm, 4>, std::vector<SparseTerm>
+    >::type SparseTermContainer;
+
+    /** \brief The sorted arrays, when sparse. */
+    SparseStorage sparse;
+
+    /** \brief The tile, when dense, slot i holds index offset + i and the last slot is not null. */
+    Tile tile;
+
+    /** \brief The index of the first slot of the tile, a multiple of TILE_WIDTH. */
+    int offset = 0;
+
+    /** \brief The number of non null coefficients of the tile. */
+    std::size_t count = 0;
+
+    /** \brief Whether the storage is a tile. */
+    bool dense = false;
+
+public:
+    /** \brief Number of stored coefficients, the non null ones of a tile. */
+    std::size_t size() const noexcept { return dense ? count : sparse.size(); }
+
+    /** \brief Checks if the storage holds no coefficient. */
+    bool empty() const noexcept { return size() == 0; }
+
+    /** \brief Checks if the storage is currently a tile. */
+    bool isDense() const noexcept { return dense; }
+
+    /** \brief Get the index of the first slot of the tile, 0 when sparse. */
+    int getTileOffset() const noexcept { return offset; }
+
+    /** \brief Get the number of slots of the tile, 0 when sparse. */
+    std::size_t getTileSize() const noexcept { return tile.size(); }
+
+    /** \brief Raw pointer to the tile, when dense. */
+    const _CoefficientType* tileData() const noexcept { return tile.data(); }
+
+    /** \brief Removes all coefficients, the storage becomes sparse. */
+    void clear() noexcept;
+
+    /** \brief Preallocates room for coefficients, when sparse. */
+    void reserve(const std::size_t _capacity);
+
+    /** \brief Number of coefficients the storage holds without reallocating, every slot of the tile when dense. */
+    std::size_t capacity() const noexcept { return dense ? tile.capacity() : sparse.capacity(); }
+
+    /** \brief Chooses the representation from the density and gives back the capacity left unused. */
+    void shrinkToFit();
+
+    /** \brief Get a coefficient, 0 if the index is not stored. */
+    _CoefficientType get(const int _index) const;
+
+    /** \brief Greatest stored index, -1 if the storage is empty. */
+    int lastIndex() const noexcept { return dense ? offset + static_cast<int>(tile.size()) - 1 : sparse.lastIndex(); }
+
+    /** \brief Access a coefficient through a proxy, assigning 0 removes the index. */
+    Reference access(const int _index) noexcept { return Reference(this, _index); }
+
+    /** \brief Removes a coefficient. */
+    void erase(const int _index) { set(_index, _CoefficientType(0)); }
+
+    /** \brief Appends a coefficient, the index must be greater than every stored index. */
+    void append(const int _index, const _CoefficientType _coefficient);
+
+    /** \brief Adds another storage. */
+    void add(const HybridStorage &_other) { addScaled(_CoefficientType(1), _other); }
+
+    /** \brief Substracts another storage. */
+    void subtract(const HybridStorage &_other);
+
+    /** \brief Adds another storage scaled by _lambda, does nothing if _lambda is 0. */
+    void addScaled(const _CoefficientType _lambda, const HybridStorage &_other);
+
+    /** \brief Overwrites the storage with a linear combination of storages, which may include the storage itself. */
+    void assignCombination(const ScaledStorage<HybridStorage, _CoefficientType> *_terms, const std::size_t _termCount);
+
+    /** \brief Apply factor on each coefficients, clears the storage if _lambda is 0. */
+    void scale(const _CoefficientType _lambda);
+
+    /** \brief Renumbers the indexes with an increasing map, dropping the ones mapped to -1. */
+    template <typename _IndexMap>
+    void remapIndexes(const _IndexMap &_map);
+
+    /** \brief Renumbers the indexes with any injective map, sorting them again. */
+    template <typename _IndexMap>
+    void permuteIndexes(const _IndexMap &_map);
+
+    /** \brief Perform dot product between two storages, over the common range of two tiles. */
+    static _CoefficientType dot(const HybridStorage &_first, const HybridStorage &_second);
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+private:
+    /** \brief The first index of the tile holding an index. */
+    static int alignedOffset(const int _index) noexcept { return _index - _index % TILE_WIDTH; }
+
+    /**
+     * \brief Inserts, modifies or removes a coefficient.
+     *
+     * \param[in] _index The index.
+     * \param[in] _value The coefficient, 0 to remove it.
+     */
+    void set(const int _index, const _CoefficientType _value);
+
+    /** \brief Adds another scaled storage, without choosing the representation. */
+    void accumulate(const _CoefficientType _lambda, const HybridStorage &_other);
+
+    /** \brief Lowest index the storage may hold, the tile offset when dense, the storage must not be empty. */
+    int firstSlot() const noexcept { return dense ? offset : sparse.indexData()[0]; }
+
+    /** \brief Grows the tile to cover the indexes from _first to _last. */
+    void cover(const int _first, const int _last);
+
+    /** \brief Writes the non null coefficients of the tile in sorted arrays. */
+    void tileEntries(SparseStorage &_entries) const;
+
+    /** \brief Restores the tile invariants after its coefficients changed, a null tile becomes sparse. */
+    void trim();
+
+    /** \brief Converts the storage to a tile. */
+    void toDense();
+
+    /** \brief Converts the storage to sorted arrays. */
+    void toSparse();
+
+    /** \brief Chooses the representation from the density. */
+    void normalize();
+};
+
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::clear() noexcept {
+    sparse.clear();
+    tile.clear();
+    offset = 0;
+    count = 0;
+    dense = false;
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::reserve(const std::size_t _capacity) {
+    if (!dense) {
+        sparse.reserve(_capacity);
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::shrinkToFit() {
+    normalize();
+    sparse.shrinkToFit();
+    tile.shrink_to_fit();
+}
+
+template <typename _CoefficientType>
+_CoefficientType HybridStorage<_CoefficientType>::get(const int _index) const {
+    if (dense) {
+        return _index >= offset && static_cast<std::size_t>(_index - offset) < tile.size() ? tile[_index - offset] : _CoefficientType(0);
+    }
+
+    return sparse.get(_index);
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::set(const int _index, const _CoefficientType _value) {
+    const bool isNull = _value == _CoefficientType(0);
+
+    if (!dense) {
+        if (isNull) {
+            sparse.erase(_index);
+        } else {
+            sparse.access(_index) = _value;
+        }
+        return;
+    }
+
+    if (_index < offset || static_cast<std::size_t>(_index - offset) >= tile.size()) {
+        if (isNull) {
+            return;
+        }
+        cover(_index, _index);
+    }
+
+    _CoefficientType &slot = tile[_index - offset];
+    const bool wasNull = slot == _CoefficientType(0);
+
+    slot = _value;
+    if (wasNull && !isNull) {
+        count++;
+    } else if (!wasNull && isNull) {
+        count--;
+        trim();
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::append(const int _index, const _CoefficientType _coefficient) {
+    if (dense) {
+        // An index far beyond the tile would mostly allocate zeros
+        if (4 * (count + 1) < static_cast<std::size_t>(_index - offset + 1)) {
+            toSparse();
+            sparse.append(_index, _coefficient);
+        } else {
+            set(_index, _coefficient);
+        }
+        return;
+    }
+
+    sparse.append(_index, _coefficient);
+
+    // Checking at each power of two keeps appending in amortized constant time
+    const std::size_t size = sparse.size();
+    if (size >= MINIMAL_DENSE_SIZE && (size & (size - 1)) == 0) {
+        normalize();
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::cover(const int _first, const int _last) {
+    const int first = std::min(offset, alignedOffset(_first));
+
+    if (first < offset) {
+        Tile grown;
+        grown.reserve(tile.size() + (offset - first));
+        grown.assign(offset - first, _CoefficientType(0));
+        grown.insert(grown.end(), tile.begin(), tile.end());
+
+        tile.swap(grown);
+        offset = first;
+    }
+
+    if (static_cast<std::size_t>(_last - offset) >= tile.size()) {
+        tile.resize(_last - offset + 1, _CoefficientType(0));
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::tileEntries(SparseStorage &_entries) const {
+    _entries.clear();
+    _entries.reserve(count);
+    for (std::size_t slot = 0 ; slot < tile.size() ; slot++) {
+        if (tile[slot] != _CoefficientType(0)) {
+            _entries.append(offset + static_cast<int>(slot), tile[slot]);
+        }
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::trim() {
+    while (!tile.empty() && tile.back() == _CoefficientType(0)) {
+        tile.pop_back();
+    }
+
+    if (tile.empty()) {
+        clear();
+    }
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::accumulate(const _CoefficientType _lambda, const HybridStorage &_other) {
+    if (_other.empty()) {
+        return;
+    }
+
+    if (!dense && !_other.dense) {
+        sparse.addScaled(_lambda, _other.sparse);
+        return;
+    }
+
+    // A sum spanning mostly zeros, as in append, is merged in sorted form instead of growing a tile over its span
+    const int first = empty() ? _other.firstSlot() : std::min(firstSlot(), _other.firstSlot());
+    const int last = std::max(lastIndex(), _other.lastIndex());
+
+    if (4 * (size() + _other.size()) < static_cast<std::size_t>(last - alignedOffset(first) + 1)) {
+        toSparse();
+
+        if (_other.dense) {
+            SparseStorage entries;
+            _other.tileEntries(entries);
+            sparse.addScaled(_lambda, entries);
+        } else {
+            sparse.addScaled(_lambda, _other.sparse);
+        }
+        return;
+    }
+
+    // Only a tile is added to sparse arrays here, the sum starts from its range when the arrays hold no coefficient
+    if (!dense) {
+        toDense();
+    }
+    if (!dense) {
+        offset = _other.offset;
+        dense = true;
+    }
+
+    if (_other.dense) {
+        cover(_other.offset, _other.lastIndex());
+        SparseKernels<_CoefficientType>::tileAddScaled(_lambda, _other.tile.data(), _other.tile.size(), tile.data() + (_other.offset - offset));
+        count = SparseKernels<_CoefficientType>::tileNonZeroCount(tile.data(), tile.size());
+    } else {
+        const int *indexes = _other.sparse.indexData();
+        const _CoefficientType *coefficients = _other.sparse.coefficientData();
+
+        cover(indexes[0], _other.sparse.lastIndex());
+        for (std::size_t entry = 0 ; entry < _other.sparse.size() ; entry++) {
+            _CoefficientType &slot = tile[indexes[entry] - offset];
+            const bool wasNull = slot == _CoefficientType(0);
+
+            slot += _lambda * coefficients[entry];
+            if (wasNull && slot != _CoefficientType(0)) {
+                count++;
+            } else if (!wasNull && slot == _CoefficientType(0)) {
+                count--;
+            }
+        }
+    }
+
+    trim();
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::subtract(const HybridStorage &_other) {
+    if (&_other == this) {
+        clear();
+        return;
+    }
+
+    accumulate(_CoefficientType(-1), _other);
+    normalize();
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::addScaled(const _CoefficientType _lambda, const HybridStorage &_other) {
+    if (&_other == this) {
+        scale(_CoefficientType(1) + _lambda);
+        return;
+    }
+
+    if (_lambda == _CoefficientType(0)) {
+        return;
+    }
+
+    accumulate(_lambda, _other);
+    normalize();
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::assignCombination(const ScaledStorage<HybridStorage, _CoefficientType> *_terms, const std::size_t _termCount) {
+    bool allSparse = true;
+
+    for (std::size_t term = 0 ; term < _termCount ; term++) {
+        if (_terms[term].storage == this) {
+            HybridStorage result;
+            result.assignCombination(_terms, _termCount);
+            *this = std::move(result);
+            return;
+        }
+
+        allSparse = allSparse && !_terms[term].storage->dense;
+    }
+
+    clear();
+
+    // Sparse terms only are merged together in a single pass
+    if (allSparse) {
+        SparseTermContainer sparseTerms;
+
+        sparseTerms.reserve(_termCount);
+        for (std::size_t term = 0 ; term < _termCount ; term++) {
+            sparseTerms.push_back(SparseTerm{&_terms[term].storage->sparse, _terms[term].factor});
+        }
+
+        sparse.assignCombination(sparseTerms.data(), sparseTerms.size());
+        normalize();
+        return;
+    }
+
+    // The tiles go first, the sparse terms are then added in place into the tile
+    for (int pass = 0 ; pass < 2 ; pass++) {
+        for (std::size_t term = 0 ; term < _termCount ; term++) {
+            if (_terms[term].storage->dense == (pass == 0) && _terms[term].factor != _CoefficientType(0)) {
+                accumulate(_terms[term].factor, *_terms[term].storage);
+            }
+        }
+    }
+
+    normalize();
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::scale(const _CoefficientType _lambda) {
+    if (_lambda == _CoefficientType(0)) {
+        clear();
+        return;
+    }
+
+    if (!dense) {
+        sparse.scale(_lambda);
+        return;
+    }
+
+    for (_CoefficientType &coefficient : tile) {
+        coefficient *= _lambda;
+    }
+
+    count = SparseKernels<_CoefficientType>::tileNonZeroCount(tile.data(), tile.size());
+    trim();
+}
+
+template <typename _CoefficientType>
+template <typename _IndexMap>
+void HybridStorage<_CoefficientType>::remapIndexes(const _IndexMap &_map) {
+    toSparse();
+    sparse.remapIndexes(_map);
+    normalize();
+}
+
+template <typename _CoefficientType>
+template <typename _IndexMap>
+void HybridStorage<_CoefficientType>::permuteIndexes(const _IndexMap &_map) {
+    toSparse();
+    sparse.permuteIndexes(_map);
+    normalize();
+}
+
+template <typename _CoefficientType>
+_CoefficientType HybridStorage<_CoefficientType>::dot(const HybridStorage &_first, const HybridStorage &_second) {
+    if (!_first.dense && !_second.dense) {
+        return SparseStorage::dot(_first.sparse, _second.sparse);
+    }
+
+    if (_first.dense && _second.dense) {
+        const int first = std::max(_first.offset, _second.offset);
+        const int last = std::min(_first.lastIndex(), _second.lastIndex());
+
+        if (first > last) {
+            return _CoefficientType(0);
+        }
+
+        return SparseKernels<_CoefficientType>::tileDot(_first.tile.data() + (first - _first.offset), _second.tile.data() + (first - _second.offset), last - first + 1);
+    }
+
+    const HybridStorage &tiled = _first.dense ? _first : _second;
+    const HybridStorage &sorted = _first.dense ? _second : _first;
+    typename SparseKernels<_CoefficientType>::Accumulator sum = typename SparseKernels<_CoefficientType>::Accumulator();
+
+    const int *indexes = sorted.sparse.indexData();
+    const _CoefficientType *coefficients = sorted.sparse.coefficientData();
+    const std::size_t tileSize = tiled.tile.size();
+
+    for (std::size_t entry = 0 ; entry < sorted.sparse.size() ; entry++) {
+        const std::size_t slot = static_cast<std::size_t>(indexes[entry] - tiled.offset);
+
+        if (indexes[entry] >= tiled.offset && slot < tileSize) {
+            SparseKernels<_CoefficientType>::Reduction::accumulate(sum, coefficients[entry], tiled.tile[slot]);
+        }
+    }
+
+    return SparseKernels<_CoefficientType>::Reduction::reduce(sum);
+}
+
+template <typename _CoefficientType>
+typename HybridStorage<_CoefficientType>::const_iterator HybridStorage<_CoefficientType>::begin() const noexcept {
+    if (dense) {
+        return const_iterator(tile.data(), tile.data(), tile.data() + tile.size(), offset);
+    }
+
+    return const_iterator(sparse.indexData(), sparse.coefficientData());
+}
+
+template <typename _CoefficientType>
+typename HybridStorage<_CoefficientType>::const_iterator HybridStorage<_CoefficientType>::end() const noexcept {
+    if (dense) {
+        return const_iterator(tile.data(), tile.data() + tile.size(), tile.data() + tile.size(), offset);
+    }
+
+    return const_iterator(sparse.indexData() + sparse.size(), sparse.coefficientData() + sparse.size());
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::toDense() {
+    if (dense || sparse.empty()) {
+        return;
+    }
+
+    const int *indexes = sparse.indexData();
+    const _CoefficientType *coefficients = sparse.coefficientData();
+
+    offset = alignedOffset(indexes[0]);
+    tile.assign(sparse.lastIndex() - offset + 1, _CoefficientType(0));
+    for (std::size_t entry = 0 ; entry < sparse.size() ; entry++) {
+        tile[indexes[entry] - offset] = coefficients[entry];
+    }
+
+    count = SparseKernels<_CoefficientType>::tileNonZeroCount(tile.data(), tile.size());
+    sparse.clear();
+    dense = true;
+    trim();
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::toSparse() {
+    if (!dense) {
+        return;
+    }
+
+    tileEntries(sparse);
+
+    tile.clear();
+    offset = 0;
+    count = 0;
+    dense = false;
+}
+
+template <typename _CoefficientType>
+void HybridStorage<_CoefficientType>::normalize() {
+    // Hysteresis between the two thresholds avoids switching back and forth.
+    if (dense) {
+        if (count < MINIMAL_DENSE_SIZE / 2 || 4 * count < tile.size()) {
+            toSparse();
+        }
+    } else if (sparse.size() >= MINIMAL_DENSE_SIZE) {
+        const std::size_t range = sparse.lastIndex() - alignedOffset(sparse.indexData()[0]) + 1;
+
+        if (2 * sparse.size() >= range) {
+            toDense();
+        }
+    }
+}
+
+}
+
+#endif
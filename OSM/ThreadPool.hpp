@@ -0,0 +1,294 @@
+/**
+ * \file ThreadPool.hpp
+ * \brief Thread pool balancing weighted tasks over its workers.
+ *
+ * Define everything for the ThreadPool class
+ */
+
+#ifndef __OSM_THREAD_POOL__
+#define __OSM_THREAD_POOL__
+
+
+#include "__base.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace OSM {
+
+/**
+ * \class ThreadPool
+ * \brief Fixed set of worker threads executing indexed tasks.
+ *
+ * The pool runs one job at a time, a job being a number of tasks executed with dynamic scheduling:
+ * each worker claims the next task from an atomic counter, so uneven tasks are balanced between workers.
+ * The calling thread takes part in the job as worker 0.
+ *
+ * A SparseMatrix uses the pool given by SparseMatrix::setThreadPool to process its chains in parallel.
+ */
+class ThreadPool {
+
+public:
+    /** \brief The job type, called with the task index and the worker index. */
+    typedef std::function<void(const std::size_t, const std::size_t)> Job;
+
+    /** \brief The minimal amount of work, in coefficients, worth a task of its own. */
+    static constexpr std::size_t MINIMAL_TASK_WEIGHT = 4096;
+
+private:
+    /** \brief The threads, worker 0 being the calling thread it is not stored. */
+    std::vector<std::thread> workers;
+
+    /** \brief Serializes the jobs. */
+    std::mutex jobMutex;
+
+    /** \brief Protects the job state. */
+    std::mutex stateMutex;
+
+    /** \brief Wakes up the workers when a job is posted. */
+    std::condition_variable jobPosted;
+
+    /** \brief Wakes up the caller when the workers are done. */
+    std::condition_variable jobDone;
+
+    /** \brief The current job. */
+    const Job *job = nullptr;
+
+    /** \brief The number of tasks of the current job. */
+    std::size_t taskCount = 0;
+
+    /** \brief The next task to claim. */
+    std::atomic<std::size_t> nextTask{0};
+
+    /** \brief The number of workers still running the current job. */
+    std::size_t runningWorkers = 0;
+
+    /** \brief Incremented on each job so workers do not run the same job twice. */
+    std::size_t jobGeneration = 0;
+
+    /** \brief The first exception raised by the current job. */
+    std::exception_ptr jobException;
+
+    /** \brief Set when the pool is destroyed. */
+    bool stopping = false;
+
+public:
+    /**
+     * \brief Create new ThreadPool object.
+     *
+     * \param[in] _threadCount The number of threads, including the calling thread (default is the hardware concurrency).
+     */
+    explicit ThreadPool(const std::size_t _threadCount = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool& operator=(const ThreadPool &) = delete;
+
+    /**
+     * \brief Stops and joins all threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * \brief Number of workers, including the calling thread.
+     *
+     * \return The number of workers.
+     */
+    std::size_t size() const noexcept { return workers.size() + 1; }
+
+    /**
+     * \brief Run tasks on all workers and wait for them.
+     *
+     * \note The first exception raised by a task is rethrown once all workers stopped.
+     *
+     * \param[in] _taskCount The number of tasks.
+     * \param[in] _job The job, called once per task.
+     */
+    void run(const std::size_t _taskCount, const Job &_job);
+
+    /**
+     * \brief Split weighted items in contiguous chunks of similar weight.
+     *
+     * Items heavier than the target weight get a chunk of their own.
+     *
+     * \param[in] _weights The weight of each item.
+     * \param[in] _chunkCount The wanted number of chunks.
+     *
+     * \return The chunks boundaries, chunk i spans from boundary i to boundary i + 1.
+     */
+    static std::vector<std::size_t> balancedChunks(const std::vector<std::size_t> &_weights, const std::size_t _chunkCount);
+
+    /**
+     * \brief Run a function on weighted items, in parallel if worth it.
+     *
+     * Items are grouped in about four chunks per worker of similar weight, claimed dynamically by the workers.
+     * Falls back to a sequential loop on worker 0 without pool or when the total weight is too small.
+     *
+     * \param[in] _pool The pool to use, may be null.
+     * \param[in] _weights The weight of each item.
+     * \param[in] _function The function, called with the item index and the worker index.
+     */
+    template <typename _Function>
+    static void forEachWeighted(ThreadPool *_pool, const std::vector<std::size_t> &_weights, const _Function &_function);
+
+private:
+    /**
+     * \brief Claims and runs tasks of the current job.
+     *
+     * \param[in] _worker The worker index.
+     */
+    void work(const std::size_t _worker);
+
+    /**
+     * \brief Worker thread loop.
+     *
+     * \param[in] _worker The worker index.
+     */
+    void workerLoop(const std::size_t _worker);
+};
+
+inline ThreadPool::ThreadPool(const std::size_t _threadCount) {
+    const std::size_t threadCount = std::max<std::size_t>(_threadCount, 1);
+
+    workers.reserve(threadCount - 1);
+    for (std::size_t worker = 1 ; worker < threadCount ; worker++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    jobPosted.notify_all();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::run(const std::size_t _taskCount, const Job &_job) {
+    if (_taskCount == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> jobLock(jobMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        job = &_job;
+        taskCount = _taskCount;
+        nextTask.store(0);
+        runningWorkers = workers.size();
+        jobException = nullptr;
+        jobGeneration++;
+    }
+    jobPosted.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    jobDone.wait(lock, [this] { return runningWorkers == 0; });
+    job = nullptr;
+
+    if (jobException) {
+        std::rethrow_exception(jobException);
+    }
+}
+
+inline std::vector<std::size_t> ThreadPool::balancedChunks(const std::vector<std::size_t> &_weights, const std::size_t _chunkCount) {
+    std::size_t totalWeight = 0;
+    for (std::size_t weight : _weights) {
+        totalWeight += weight;
+    }
+
+    const std::size_t targetWeight = std::max<std::size_t>(totalWeight / std::max<std::size_t>(_chunkCount, 1), 1);
+    std::vector<std::size_t> boundaries(1, 0);
+    std::size_t chunkWeight = 0;
+
+    for (std::size_t item = 0 ; item < _weights.size() ; item++) {
+        if (chunkWeight > 0 && chunkWeight + _weights[item] > targetWeight) {
+            boundaries.push_back(item);
+            chunkWeight = 0;
+        }
+        chunkWeight += _weights[item];
+    }
+
+    if (boundaries.back() != _weights.size()) {
+        boundaries.push_back(_weights.size());
+    }
+
+    return boundaries;
+}
+
+template <typename _Function>
+void ThreadPool::forEachWeighted(ThreadPool *_pool, const std::vector<std::size_t> &_weights, const _Function &_function) {
+    std::size_t totalWeight = 0;
+    for (std::size_t weight : _weights) {
+        totalWeight += weight;
+    }
+
+    if (_pool == nullptr || _pool->size() == 1 || totalWeight < 2 * MINIMAL_TASK_WEIGHT) {
+        for (std::size_t item = 0 ; item < _weights.size() ; item++) {
+            _function(item, 0);
+        }
+        return;
+    }
+
+    const std::size_t chunkCount = std::min(4 * _pool->size(), totalWeight / MINIMAL_TASK_WEIGHT);
+    const std::vector<std::size_t> boundaries = balancedChunks(_weights, chunkCount);
+
+    _pool->run(boundaries.size() - 1, [&](const std::size_t _chunk, const std::size_t _worker) {
+        for (std::size_t item = boundaries[_chunk] ; item < boundaries[_chunk + 1] ; item++) {
+            _function(item, _worker);
+        }
+    });
+}
+
+inline void ThreadPool::work(const std::size_t _worker) {
+    for (std::size_t task = nextTask.fetch_add(1) ; task < taskCount ; task = nextTask.fetch_add(1)) {
+        try {
+            (*job)(task, _worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!jobException) {
+                jobException = std::current_exception();
+            }
+        }
+    }
+}
+
+inline void ThreadPool::workerLoop(const std::size_t _worker) {
+    std::size_t lastGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            jobPosted.wait(lock, [this, lastGeneration] { return stopping || jobGeneration != lastGeneration; });
+
+            if (stopping) {
+                return;
+            }
+            lastGeneration = jobGeneration;
+        }
+
+        work(_worker);
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            runningWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+}
+
+#endif
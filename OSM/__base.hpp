@@ -12,6 +12,11 @@
 #define __OPTIMISED_SPARSED_MATRIX_BASE__
 
 
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+
+
 namespace OSM {
     /** \brief Chain type flag for column chain. */
     const int COLUMN = 0b01;
@@ -21,6 +26,132 @@ namespace OSM {
     /** \brief The default type for signed integers. */
     typedef int ZCoefficient;
 
+    /**
+     * \class Z2Coefficient
+     * \brief Coefficients of Z/2Z, addition is a XOR.
+     */
+    class Z2Coefficient;
+
+    /**
+     * \brief Number of trailing zero bits of a non zero word.
+     * 
+     * \param[in] _word The word, must not be 0.
+     * 
+     * \return The index of the lowest set bit.
+     */
+    inline int countTrailingZeros(const uint64_t _word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(_word);
+#else
+        int count = 0;
+        for (uint64_t word = _word ; (word & 1) == 0 ; word >>= 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    /**
+     * \brief Number of leading zero bits of a non zero word.
+     * 
+     * \param[in] _word The word, must not be 0.
+     * 
+     * \return 63 minus the index of the highest set bit.
+     */
+    inline int countLeadingZeros(const uint64_t _word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(_word);
+#else
+        int count = 0;
+        for (uint64_t word = _word ; (word >> 63) == 0 ; word <<= 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    /**
+     * \brief Number of set bits of a word.
+     * 
+     * \param[in] _word The word.
+     * 
+     * \return The number of set bits.
+     */
+    inline int populationCount(const uint64_t _word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(_word);
+#else
+        int count = 0;
+        for (uint64_t word = _word ; word != 0 ; word &= word - 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    /**
+     * \brief The chain type flag of a transposed chain.
+     * 
+     * \note A matrix indexed both ways (OSM::COLUMN | OSM::ROW) stays indexed both ways.
+     * 
+     * \tparam _ChainTypeFlag The type of vector the chain is representing.
+     */
+    template <int _ChainTypeFlag>
+    constexpr int TRANSPOSED = _ChainTypeFlag == COLUMN ? ROW : _ChainTypeFlag == ROW ? COLUMN : _ChainTypeFlag;
+
+    /**
+     * \class SortedStorage
+     * \brief Sorted flat-array storage policy for chains.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _InlineCapacity The number of entries stored inline before moving to the heap (default is 0)
+     * \tparam _Allocator The stateless allocator of the arrays (default is std::allocator)
+     */
+    template <typename _CoefficientType, std::size_t _InlineCapacity = 0, typename _Allocator = std::allocator<_CoefficientType>>
+    class SortedStorage;
+
+    /**
+     * \class MapStorage
+     * \brief Hash map storage policy for chains.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _Allocator The stateless allocator of the map (default is std::allocator)
+     */
+    template <typename _CoefficientType, typename _Allocator = std::allocator<_CoefficientType>>
+    class MapStorage;
+
+    /**
+     * \class Z2Storage
+     * \brief Index set storage policy for Z/2Z chains, sorted array or bitset chosen by density.
+     */
+    class Z2Storage;
+
+    /**
+     * \class HybridStorage
+     * \brief Storage policy for chains, sorted arrays or an aligned dense tile chosen by density.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types.
+     */
+    template <typename _CoefficientType>
+    class HybridStorage;
+
+    /**
+     * \brief The default chains storage policy for a coefficient type.
+     * 
+     * OSM::SortedStorage, except for OSM::Z2Coefficient chains which only store their index set in an OSM::Z2Storage.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types.
+     */
+    template <typename _CoefficientType>
+    struct DefaultStorage {
+        typedef SortedStorage<_CoefficientType> type;
+    };
+
+    template <>
+    struct DefaultStorage<Z2Coefficient> {
+        typedef Z2Storage type;
+    };
+
     /**
      * \class SparseMatrix
      * \brief Vector<Map> implementation of sparse matrices.
@@ -28,13 +159,14 @@ namespace OSM {
      * The SparseMatrix class contains all algebraic functions that are related to matrix.
      * 
      * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
-     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing, OSM::COLUMN | OSM::ROW to index both (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN>
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
     class SparseMatrix;
 
     /**
@@ -45,13 +177,146 @@ namespace OSM {
      * 
      * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
      * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
      * 
      * \author Fedyna K.
      * \version 0.1.0
      * \date 08/04/2024
      */
-    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN>
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
     class Chain;
+
+    /**
+     * \class ChainView
+     * \brief Read-only non-owning view on a chain.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class ChainView;
+
+    /**
+     * \class ChainExpression
+     * \brief Lazy linear combination of chains, evaluated in a single pass when assigned.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class ChainExpression;
+
+    /**
+     * \class LazyChain
+     * \brief Chain accumulating its additions in a heap of pending entries, consolidated when its last index is queried.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     * \tparam _StorageType The storage policy of the converted chains (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class LazyChain;
+
+    /**
+     * \class ChainPacket
+     * \brief Compact binary encoding of a sequence of chains, to be sent between processes.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of the encoded chains (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class ChainPacket;
+
+    /**
+     * \brief The default instrumentation policy, which collects nothing.
+     */
+    struct NoInstrumentation;
+
+    /**
+     * \class ColumnReduction
+     * \brief Persistence reduction of a column-based boundary matrix, with clearing or compression.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     * \tparam _Instrumentation The instrumentation policy (default is OSM::NoInstrumentation)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type, typename _Instrumentation = OSM::NoInstrumentation>
+    class ColumnReduction;
+
+    /**
+     * \class SmithNormalForm
+     * \brief Smith normal form of integer matrices, widening only the chains that may overflow.
+     * 
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _StorageType = typename OSM::DefaultStorage<OSM::ZCoefficient>::type>
+    class SmithNormalForm;
+
+    /**
+     * \class MappedMatrix
+     * \brief Read-only sparse matrix mapped from a binary matrix file.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN>
+    class MappedMatrix;
+
+    /**
+     * \class MatrixBuilder
+     * \brief Streaming chain by chain writer of binary matrix files.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of vector the chain is representing (default is OSM::COLUMN)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN>
+    class MatrixBuilder;
+
+    /**
+     * \class ReorientedView
+     * \brief Lazy view of a sparse matrix with the other chain type.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The chain type of the viewed matrix (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class ReorientedView;
+
+    /**
+     * \class ImplicitMatrix
+     * \brief Sparse matrix whose chains are generated on demand, the most recently used ones being cached.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of the generated chains (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class ImplicitMatrix;
+
+    /**
+     * \class DistributedMatrix
+     * \brief Sparse matrix whose chains are partitioned across the ranks of an MPI communicator, built with OSM_WITH_MPI.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _ChainTypeFlag The type of the distributed chains (default is OSM::COLUMN)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, int _ChainTypeFlag = OSM::COLUMN, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class DistributedMatrix;
+
+    /**
+     * \class DistributedReduction
+     * \brief Chunk reduction of a boundary matrix distributed by columns, built with OSM_WITH_MPI.
+     * 
+     * \tparam _CoefficientType The chain's coefficient types (default is OSM::ZCoefficient)
+     * \tparam _StorageType The chains storage policy (default is OSM::DefaultStorage)
+     */
+    template <typename _CoefficientType = OSM::ZCoefficient, typename _StorageType = typename OSM::DefaultStorage<_CoefficientType>::type>
+    class DistributedReduction;
 }
 
 #endif
\ No newline at end of file
@@ -1,7 +1,499 @@
+/**
+ * \file main.cpp
+ * \brief Benchmark suite of the library.
+ *
+ * Runs the chain and matrix operations over synthetic and real-world workloads, for Z, Z/2Z and Z/pZ coefficients,
+ * and prints one JSON object per measure so that successive releases can be compared. Each measure reports the median
+ * time of a repetition divided by the number of operations it timed (ns_per_op), the number of matrix entries processed
+ * by a repetition (nnz) and per second (nnz_per_s), and the peak resident set size of the process so far (peak_rss_kb).
+ * The chunked reductions also report their speedup over the sequential ones.
+ *
+ * Usage: osm_benchmark [--scale <factor>] [--repetitions <count>] [--threads <count>] [--filter <substring>]
+ */
+
 #include "OSM.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+
+namespace {
+
+/** \brief The command line options. */
+struct Options {
+    /** \brief The factor applied to the size of every workload. */
+    double scale = 1.0;
+
+    /** \brief The number of timed runs of each measure, the median is reported. */
+    int repetitions = 5;
+
+    /** \brief The number of threads of the parallel measures. */
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /** \brief Only the measures whose benchmark, coefficient or workload name contains it are run. */
+    std::string filter;
+};
+
+/** \brief The entries of a matrix, with the dimensions of its columns for boundary matrices. */
+struct Workload {
+    /** \brief The workload name. */
+    std::string name;
+
+    /** \brief The number of rows. */
+    int rowCount;
+
+    /** \brief The number of columns. */
+    int columnCount;
+
+    /** \brief The entries, with small integer values. */
+    std::vector<OSM::Triplet<int>> entries;
+
+    /** \brief The dimension of each column, empty if the matrix is not a boundary matrix. */
+    std::vector<int> dimensions;
+};
+
+/** \brief Accumulates the time spent between start and stop. */
+class Stopwatch {
+
+    /** \brief The start of the current measure. */
+    std::chrono::steady_clock::time_point begin;
+
+    /** \brief The accumulated time in nanoseconds. */
+    double elapsed = 0;
+
+public:
+    void start() { begin = std::chrono::steady_clock::now(); }
+    void stop() { elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count(); }
+    double nanoseconds() const { return elapsed; }
+};
+
+/** \brief The name printed for each coefficient type. */
+template <typename _CoefficientType> const char *coefficientName();
+template <> const char *coefficientName<OSM::ZCoefficient>() { return "Z"; }
+template <> const char *coefficientName<OSM::Z2Coefficient>() { return "Z2"; }
+template <> const char *coefficientName<OSM::ZpCoefficient<2147483647>>() { return "Zp"; }
+
+/** \brief The peak resident set size of the process, in kilobytes. */
+long peakResidentKilobytes() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+/**
+ * \brief Uniformly random entries.
+ *
+ * \param[in] _size The number of rows and columns.
+ * \param[in] _entriesPerColumn The mean number of entries of a column.
+ * \param[in] _seed The random seed.
+ */
+Workload randomWorkload(const int _size, const int _entriesPerColumn, const unsigned _seed) {
+    std::mt19937 generator(_seed);
+    std::uniform_int_distribution<int> index(0, _size - 1);
+    std::uniform_int_distribution<int> value(1, 3);
+    Workload workload{"random", _size, _size, {}, {}};
+
+    workload.entries.reserve(std::size_t(_size) * _entriesPerColumn);
+    for (std::size_t entry = 0 ; entry < std::size_t(_size) * _entriesPerColumn ; entry++) {
+        workload.entries.push_back({index(generator), index(generator), generator() % 2 ? value(generator) : -value(generator)});
+    }
+
+    return workload;
+}
+
+/**
+ * \brief Entries whose columns and rows follow a power law, a few chains holding most of the entries.
+ *
+ * \param[in] _size The number of rows and columns.
+ * \param[in] _entriesPerColumn The mean number of entries of a column.
+ * \param[in] _seed The random seed.
+ */
+Workload powerLawWorkload(const int _size, const int _entriesPerColumn, const unsigned _seed) {
+    std::mt19937 generator(_seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::uniform_int_distribution<int> value(1, 3);
+    Workload workload{"power_law", _size, _size, {}, {}};
+
+    // Index floor(size * u^3) has a density decreasing as a power of the index.
+    const auto powerLawIndex = [&]() { return std::min(_size - 1, static_cast<int>(_size * std::pow(uniform(generator), 3.0))); };
+
+    workload.entries.reserve(std::size_t(_size) * _entriesPerColumn);
+    for (std::size_t entry = 0 ; entry < std::size_t(_size) * _entriesPerColumn ; entry++) {
+        workload.entries.push_back({powerLawIndex(), powerLawIndex(), generator() % 2 ? value(generator) : -value(generator)});
+    }
+
+    return workload;
+}
+
+/**
+ * \brief Boundary matrix of the Vietoris-Rips 2-skeleton of random points of the unit square.
+ *
+ * The simplices are ordered by filtration value, the faces of a simplex before it.
+ *
+ * \param[in] _pointCount The number of points.
+ * \param[in] _radius The greatest edge length.
+ * \param[in] _seed The random seed.
+ */
+Workload vietorisRipsWorkload(const int _pointCount, const double _radius, const unsigned _seed) {
+    struct Simplex {
+        std::vector<int> vertices;
+        double value;
+    };
+
+    std::mt19937 generator(_seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<double> x(_pointCount), y(_pointCount);
+
+    for (int point = 0 ; point < _pointCount ; point++) {
+        x[point] = uniform(generator);
+        y[point] = uniform(generator);
+    }
+
+    const auto distance = [&](const int _first, const int _second) { return std::hypot(x[_first] - x[_second], y[_first] - y[_second]); };
+    std::vector<std::vector<int>> neighbours(_pointCount);
+    std::vector<Simplex> simplices;
+
+    for (int first = 0 ; first < _pointCount ; first++) {
+        simplices.push_back({{first}, 0});
+
+        for (int second = first + 1 ; second < _pointCount ; second++) {
+            if (distance(first, second) < _radius) {
+                neighbours[first].push_back(second);
+                simplices.push_back({{first, second}, distance(first, second)});
+            }
+        }
+    }
+
+    for (int first = 0 ; first < _pointCount ; first++) {
+        for (std::size_t i = 0 ; i < neighbours[first].size() ; i++) {
+            for (std::size_t j = i + 1 ; j < neighbours[first].size() ; j++) {
+                const int second = neighbours[first][i];
+                const int third = neighbours[first][j];
+
+                if (distance(second, third) < _radius) {
+                    simplices.push_back({{first, second, third}, std::max({distance(first, second), distance(first, third), distance(second, third)})});
+                }
+            }
+        }
+    }
+
+    std::stable_sort(simplices.begin(), simplices.end(), [](const Simplex &_first, const Simplex &_second) {
+        return _first.value < _second.value || (_first.value == _second.value && _first.vertices.size() < _second.vertices.size());
+    });
+
+    std::map<std::vector<int>, int> positions;
+    for (std::size_t simplex = 0 ; simplex < simplices.size() ; simplex++) {
+        positions[simplices[simplex].vertices] = simplex;
+    }
+
+    const int size = simplices.size();
+    Workload workload{"vietoris_rips", size, size, {}, std::vector<int>(size)};
+
+    for (int column = 0 ; column < size ; column++) {
+        const std::vector<int> &vertices = simplices[column].vertices;
+        workload.dimensions[column] = vertices.size() - 1;
+
+        for (std::size_t removed = 0 ; vertices.size() > 1 && removed < vertices.size() ; removed++) {
+            std::vector<int> face = vertices;
+            face.erase(face.begin() + removed);
+            workload.entries.push_back({positions[face], column, removed % 2 == 0 ? 1 : -1});
+        }
+    }
+
+    return workload;
+}
+
+/** \brief Runs the measures and prints them. */
+class Benchmark {
+
+    /** \brief The command line options. */
+    Options options;
+
+    /** \brief The pool of the parallel measures. */
+    OSM::ThreadPool pool;
+
+public:
+    explicit Benchmark(const Options &_options) : options(_options), pool(_options.threads) {}
+
+    /** \brief Runs every measure of a coefficient type on a workload. */
+    template <typename _CoefficientType>
+    void run(const Workload &_workload);
+
+private:
+    /** \brief Whether a measure passes the filter. */
+    bool selected(const std::string &_benchmark, const char *_coefficient, const Workload &_workload) const {
+        const std::string name = _benchmark + " " + _coefficient + " " + _workload.name;
+
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    /**
+     * \brief Times a measure and prints its median over the repetitions.
+     *
+     * \param[in] _measure Called once per repetition with a stopwatch, returns the number of operations it timed.
+     * \param[in] _entryCount The number of matrix entries processed by one repetition.
+     * \param[in] _baseline The median time of the sequential version of the measure, 0 if there is none.
+     *
+     * \return The median time of a repetition in nanoseconds.
+     */
+    template <typename _Measure>
+    double measure(const std::string &_benchmark, const char *_coefficient, const Workload &_workload, const int _threads,
+                   const std::size_t _entryCount, const _Measure &_measure, const double _baseline = 0);
+
+    /** \brief Times the chunked reduction against the sequential one. */
+    template <typename _CoefficientType>
+    void runReductions(const OSM::SparseMatrix<_CoefficientType, OSM::COLUMN> &_matrix, const Workload &_workload, const std::size_t _entryCount);
+};
+
+template <typename _Measure>
+double Benchmark::measure(const std::string &_benchmark, const char *_coefficient, const Workload &_workload, const int _threads,
+                          const std::size_t _entryCount, const _Measure &_measure, const double _baseline) {
+    std::vector<double> samples;
+    std::size_t operations = 1;
+
+    for (int repetition = 0 ; repetition < options.repetitions ; repetition++) {
+        Stopwatch stopwatch;
+        operations = std::max<std::size_t>(_measure(stopwatch), 1);
+        samples.push_back(stopwatch.nanoseconds());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const double median = samples[samples.size() / 2];
+    const std::string speedup = _baseline > 0 && median > 0 ? ",\"speedup\":" + std::to_string(_baseline / median) : "";
+
+    std::printf(
+        "{\"benchmark\":\"%s\",\"coefficient\":\"%s\",\"workload\":\"%s\",\"rows\":%d,\"columns\":%d,\"nnz\":%zu,\"threads\":%d,"
+        "\"repetitions\":%d,\"operations\":%zu,\"ns_per_op\":%.1f,\"nnz_per_s\":%.4g,\"peak_rss_kb\":%ld,\"simd\":\"%s\"%s}\n",
+        _benchmark.c_str(), _coefficient, _workload.name.c_str(), _workload.rowCount, _workload.columnCount, _entryCount, _threads,
+        options.repetitions, operations, median / operations, median > 0 ? _entryCount / (median * 1e-9) : 0.0,
+        peakResidentKilobytes(), OSM::simdLevelName(OSM::simdLevel()), speedup.c_str()
+    );
+    std::fflush(stdout);
+
+    return median;
+}
+
+template <typename _CoefficientType>
+void Benchmark::run(const Workload &_workload) {
+    typedef OSM::SparseMatrix<_CoefficientType, OSM::COLUMN> ColumnMatrix;
+    typedef OSM::Chain<_CoefficientType, OSM::COLUMN> Column;
+
+    const char *coefficient = coefficientName<_CoefficientType>();
+    std::vector<OSM::Triplet<_CoefficientType>> triplets;
+
+    triplets.reserve(_workload.entries.size());
+    for (const OSM::Triplet<int> &entry : _workload.entries) {
+        triplets.push_back({entry.row, entry.column, _CoefficientType(entry.value)});
+    }
+
+    const ColumnMatrix matrix = ColumnMatrix::fromTriplets(_workload.rowCount, _workload.columnCount, triplets);
+    std::size_t entryCount = 0;
+    for (int column = 0 ; column < matrix.getColumnCount() ; column++) {
+        entryCount += matrix[column].size();
+    }
+
+    if (selected("from_triplets", coefficient, _workload)) {
+        measure("from_triplets", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const ColumnMatrix built = ColumnMatrix::fromTriplets(_workload.rowCount, _workload.columnCount, triplets);
+            _stopwatch.stop();
+
+            return std::size_t(built.getColumnCount() > 0);
+        });
+    }
+
+    if (selected("chain_add", coefficient, _workload)) {
+        measure("chain_add", coefficient, _workload, 1, 2 * entryCount, [&](Stopwatch &_stopwatch) {
+            std::size_t operations = 0;
+            Column sum(matrix.getRowCount());
+
+            _stopwatch.start();
+            for (int column = 0 ; column < matrix.getColumnCount() ; column++) {
+                sum = matrix[column] + matrix[(column + 1) % matrix.getColumnCount()];
+                operations++;
+            }
+            _stopwatch.stop();
+
+            return operations;
+        });
+    }
+
+    if (selected("product", coefficient, _workload) && _workload.dimensions.empty()) {
+        measure("product", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const ColumnMatrix product = matrix * matrix;
+            _stopwatch.stop();
+
+            return std::size_t(product.getColumnCount() > 0);
+        });
+    }
+
+    if (selected("spmv", coefficient, _workload)) {
+        const std::vector<_CoefficientType> vector(matrix.getColumnCount(), _CoefficientType(1));
+
+        measure("spmv", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const std::vector<_CoefficientType> product = matrix.multiply(vector);
+            _stopwatch.stop();
+
+            return std::size_t(!product.empty());
+        });
+    }
+
+    if (selected("transpose", coefficient, _workload)) {
+        measure("transpose", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const OSM::SparseMatrix<_CoefficientType, OSM::ROW> transposed = matrix.transpose();
+            _stopwatch.stop();
+
+            return std::size_t(transposed.getRowCount() > 0);
+        });
+    }
+
+    if (selected("reorient", coefficient, _workload)) {
+        measure("reorient", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const OSM::SparseMatrix<_CoefficientType, OSM::ROW> rows = matrix.reoriented();
+            _stopwatch.stop();
+
+            return std::size_t(rows.getRowCount() > 0);
+        });
+    }
+
+    if (selected("submatrix", coefficient, _workload)) {
+        // Keeps every other index, like restricting a boundary matrix to a subcomplex.
+        std::vector<int> kept;
+        for (int index = 0 ; index < std::max(matrix.getRowCount(), matrix.getColumnCount()) ; index += 2) {
+            kept.push_back(index);
+        }
+        const OSM::IndexSet indexes(std::max(matrix.getRowCount(), matrix.getColumnCount()), kept);
+
+        measure("submatrix", coefficient, _workload, 1, entryCount, [&](Stopwatch &_stopwatch) {
+            _stopwatch.start();
+            const ColumnMatrix restricted = matrix.restriction(indexes);
+            _stopwatch.stop();
+
+            return std::size_t(restricted.getColumnCount() > 0);
+        });
+    }
+
+    if (!_workload.dimensions.empty()) {
+        runReductions(matrix, _workload, entryCount);
+    }
+}
+
+template <typename _CoefficientType>
+void Benchmark::runReductions(const OSM::SparseMatrix<_CoefficientType, OSM::COLUMN> &_matrix, const Workload &_workload, const std::size_t _entryCount) {
+    typedef OSM::SparseMatrix<_CoefficientType, OSM::COLUMN> ColumnMatrix;
+
+    const char *coefficient = coefficientName<_CoefficientType>();
+    const char *names[] = {"reduction", "reduction_clearing", "reduction_compression"};
+
+    for (int variant = 0 ; variant < 2 * (OSM::COMPRESSION + 1) ; variant++) {
+        const int optimization = variant / 2;
+        const bool apparentPairs = variant % 2 == 1;
+        const std::string name = std::string(names[optimization]) + (apparentPairs ? "_apparent" : "");
+
+        if (!selected(name, coefficient, _workload)) {
+            continue;
+        }
+
+        const auto reduce = [&](OSM::ThreadPool *_pool) {
+            return [&, _pool](Stopwatch &_stopwatch) {
+                ColumnMatrix reduced = _matrix;
+                OSM::ColumnReduction<_CoefficientType> reduction(_workload.dimensions, static_cast<OSM::ReductionOptimization>(optimization));
+                reduction.setThreadPool(_pool);
+                reduction.setApparentPairShortcut(apparentPairs);
+
+                _stopwatch.start();
+                const OSM::PersistenceDiagram diagram = reduction.reduce(reduced);
+                _stopwatch.stop();
+
+                return std::size_t(diagram.pairs.size() + diagram.essentials.size() > 0);
+            };
+        };
+
+        try {
+            const double sequential = measure(name, coefficient, _workload, 1, _entryCount, reduce(nullptr));
+
+            if (options.threads > 1) {
+                // The chunked reduction only runs with a pool of at least two threads.
+                measure(name + "_chunked", coefficient, _workload, options.threads, _entryCount, reduce(&pool), sequential);
+            }
+        } catch (const std::exception &_error) {
+            // Integer reductions may overflow, the measure is reported as failed.
+            std::printf("{\"benchmark\":\"%s\",\"coefficient\":\"%s\",\"workload\":\"%s\",\"error\":\"%s\"}\n",
+                        name.c_str(), coefficient, _workload.name.c_str(), _error.what());
+        }
+    }
+}
+
+/** \brief Prints the usage and exits with an error. */
+[[noreturn]] void usage(const char *_program) {
+    std::fprintf(stderr, "Usage: %s [--scale <factor>] [--repetitions <count>] [--threads <count>] [--filter <substring>]\n", _program);
+    std::exit(EXIT_FAILURE);
+}
+
+Options parseOptions(const int _argc, char **_argv) {
+    Options options;
+
+    for (int argument = 1 ; argument < _argc ; argument++) {
+        const char *value = argument + 1 < _argc ? _argv[argument + 1] : nullptr;
+
+        if (value == nullptr) {
+            usage(_argv[0]);
+        } else if (std::strcmp(_argv[argument], "--scale") == 0) {
+            options.scale = std::atof(value);
+        } else if (std::strcmp(_argv[argument], "--repetitions") == 0) {
+            options.repetitions = std::atoi(value);
+        } else if (std::strcmp(_argv[argument], "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(_argv[argument], "--filter") == 0) {
+            options.filter = value;
+        } else {
+            usage(_argv[0]);
+        }
+
+        argument++;
+    }
+
+    if (options.scale <= 0 || options.repetitions <= 0 || options.threads <= 0) {
+        usage(_argv[0]);
+    }
+
+    return options;
+}
+
+}
+
+int main(int argc, char **argv) {
+    const Options options = parseOptions(argc, argv);
+    Benchmark benchmark(options);
 
-int main() {
+    const int size = std::max(1, static_cast<int>(20000 * options.scale));
+    const int pointCount = std::max(2, static_cast<int>(250 * std::sqrt(options.scale)));
+    const Workload workloads[] = {
+        randomWorkload(size, 8, 1),
+        powerLawWorkload(size, 8, 2),
+        vietorisRipsWorkload(pointCount, 0.2, 3)
+    };
 
+    for (const Workload &workload : workloads) {
+        benchmark.run<OSM::ZCoefficient>(workload);
+        benchmark.run<OSM::Z2Coefficient>(workload);
+        benchmark.run<OSM::ZpCoefficient<2147483647>>(workload);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,114 @@
+/**
+ * \file ChainTrackingTest.cpp
+ * \brief Tests the tracking of empty chains after writes through chain references and iterators.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+#include <vector>
+
+
+namespace {
+
+typedef OSM::SparseMatrix<int, OSM::COLUMN> Matrix;
+typedef OSM::Chain<int, OSM::COLUMN> Column;
+
+/** \brief Counts the entries of a matrix from its chains. */
+std::size_t entryCount(const Matrix &_matrix) {
+    std::size_t count = 0;
+
+    for (Matrix::const_iterator it = _matrix.begin() ; it != _matrix.end() ; ++it) {
+        count += it->size();
+    }
+
+    return count;
+}
+
+/** \brief Counts the chains visited by forEachNonEmpty. */
+int visitedCount(const Matrix &_matrix) {
+    int count = 0;
+    _matrix.forEachNonEmpty([&count](const int, const Column &) { count++; });
+
+    return count;
+}
+
+/** \brief A matrix whose columns are all written through the mutable iterators. */
+Matrix writtenThroughIterators() {
+    Matrix matrix(3, 3);
+
+    for (Column &column : matrix) {
+        column[1] = 2;
+    }
+
+    return matrix;
+}
+
+void testIteratorWrites() {
+    Matrix identity = Matrix::fromTriplets(3, 3, {{0, 0, 1}, {1, 1, 1}, {2, 2, 1}});
+    const Matrix written = writtenThroughIterators();
+
+    identity += written;
+    OSM_CHECK(entryCount(identity) == 5);
+    OSM_CHECK(identity.getRow(1).size() == 3);
+
+    Matrix difference(3, 3);
+    difference -= written;
+    OSM_CHECK(entryCount(difference) == 3);
+
+    OSM_CHECK(written.multiply({1, 1, 1}) == std::vector<int>({0, 6, 0}));
+    OSM_CHECK(visitedCount(written) == 3);
+
+    Matrix scaled = writtenThroughIterators();
+    scaled *= 3;
+    OSM_CHECK(scaled.multiply({1, 1, 1}) == std::vector<int>({0, 18, 0}));
+    OSM_CHECK(scaled.transpose().multiply({1, 1, 1}) == std::vector<int>({6, 6, 6}));
+}
+
+void testReferenceWrites() {
+    Matrix matrix(3, 3);
+    Column &first = matrix[0];
+    Column &second = matrix[1];
+
+    first[2] = 4;
+    second[0] = 1;
+    OSM_CHECK(visitedCount(matrix) == 2);
+    OSM_CHECK(matrix.getRow(2).size() == 1);
+
+    // The chain is emptied after its reference was taken.
+    first = Column(3);
+    OSM_CHECK(visitedCount(matrix) == 1);
+    OSM_CHECK(matrix.multiply({1, 1, 1}) == std::vector<int>({1, 0, 0}));
+    OSM_CHECK(matrix.reoriented().getRowCount() == 3);
+    OSM_CHECK(matrix.reoriented()[2].size() == 0);
+
+    const Matrix copy(matrix);
+    OSM_CHECK(visitedCount(copy) == 1);
+
+    second[2] = 5;
+    OSM_CHECK(visitedCount(matrix) == 1);
+    OSM_CHECK(matrix.multiply({0, 1, 0}) == std::vector<int>({1, 0, 5}));
+
+    matrix.commitChains();
+    OSM_CHECK(visitedCount(matrix) == 1);
+    OSM_CHECK(entryCount(matrix) == 2);
+}
+
+void testRemovalAfterWrites() {
+    Matrix matrix(3, 3);
+    matrix[2][0] = 7;
+    matrix[2][2] = 1;
+
+    matrix /= std::vector<int>({0});
+    OSM_CHECK(matrix.getRowCount() == 2 && matrix.getColumnCount() == 2);
+    OSM_CHECK(matrix.multiply({0, 1}) == std::vector<int>({0, 1}));
+}
+
+}
+
+int main() {
+    testIteratorWrites();
+    testReferenceWrites();
+    testRemovalAfterWrites();
+
+    return OSM::Tests::report();
+}
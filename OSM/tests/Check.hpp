@@ -0,0 +1,80 @@
+/**
+ * \file Check.hpp
+ * \brief Assertion helpers shared by the behavior tests.
+ *
+ * Each test executable checks its cases with OSM_CHECK, which reports the failing expression without stopping, and
+ * returns OSM::Tests::report() so that CTest sees the failures.
+ */
+
+#ifndef __OSM_TESTS_CHECK__
+#define __OSM_TESTS_CHECK__
+
+
+#include <cstdio>
+
+
+namespace OSM {
+namespace Tests {
+
+/** \brief The number of failed checks of the test executable. */
+inline int failureCount = 0;
+
+/**
+ * \brief Records a check, printing it if it failed.
+ *
+ * \param[in] _passed Whether the checked condition holds.
+ * \param[in] _expression The checked expression.
+ * \param[in] _file The file of the check.
+ * \param[in] _line The line of the check.
+ */
+inline void check(const bool _passed, const char *_expression, const char *_file, const int _line) {
+    if (!_passed) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", _file, _line, _expression);
+        failureCount++;
+    }
+}
+
+/**
+ * \brief Records that an expression throws the given exception type.
+ *
+ * \param[in] _function The function evaluating the expression.
+ * \param[in] _expression The checked expression.
+ * \param[in] _file The file of the check.
+ * \param[in] _line The line of the check.
+ */
+template <typename _Exception, typename _Function>
+void checkThrows(const _Function &_function, const char *_expression, const char *_file, const int _line) {
+    bool thrown = false;
+
+    try {
+        _function();
+    } catch (const _Exception &) {
+        thrown = true;
+    } catch (...) {}
+
+    check(thrown, _expression, _file, _line);
+}
+
+/**
+ * \brief Gives the exit code of the test executable.
+ *
+ * \return 0 if every check passed, 1 otherwise.
+ */
+inline int report() {
+    if (failureCount != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failureCount);
+    }
+
+    return failureCount == 0 ? 0 : 1;
+}
+
+}
+}
+
+/** \brief Checks that a condition holds. */
+#define OSM_CHECK(...) OSM::Tests::check((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+/** \brief Checks that an expression throws the given exception type. */
+#define OSM_CHECK_THROWS(_exception, _expression) OSM::Tests::checkThrows<_exception>([&]() { (void)(_expression); }, #_expression, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * \file CoefficientTest.cpp
+ * \brief Tests the Z/2Z and Z/pZ coefficient types and the exact quotients used by the reductions.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+#include <climits>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+template <uint32_t _Prime>
+void testPrimeField() {
+    typedef OSM::ZpCoefficient<_Prime> Zp;
+
+    OSM_CHECK(Zp(-1).reduced() == _Prime - 1);
+    OSM_CHECK(Zp(1) - Zp(2) == Zp(-1));
+    OSM_CHECK(Zp(-1) + Zp(2) == Zp(1));
+    if constexpr (_Prime < 1000) {
+        OSM_CHECK(Zp(_Prime + 3) == Zp(3));
+    }
+
+    for (int value = 1 ; value < 200 ; value++) {
+        if (value % _Prime != 0) {
+            OSM_CHECK(Zp(value) * Zp(value).inverse() == Zp(1));
+            OSM_CHECK(Zp(value) / Zp(value) == Zp(1));
+        }
+    }
+
+    // The deferred sums are reduced once, after products overflowing the modulus
+    typename OSM::DeferredReduction<Zp>::accumulator_type sum = OSM::DeferredReduction<Zp>::lift(Zp(0));
+    long long expected = 0;
+    for (int term = 0 ; term < 1000 ; term++) {
+        const int first = -1 - 46337 * term;
+        const int second = term + 7;
+
+        OSM::DeferredReduction<Zp>::accumulate(sum, Zp(first), Zp(second));
+        expected = (expected + Zp(first).reduced() * (long long)Zp(second).reduced()) % _Prime;
+    }
+    OSM_CHECK(OSM::DeferredReduction<Zp>::reduce(sum) == Zp(static_cast<int>(expected)));
+}
+
+void testTwoElementField() {
+    typedef OSM::Z2Coefficient Z2;
+
+    OSM_CHECK(Z2(3) == Z2(1));
+    OSM_CHECK(Z2(1) + Z2(1) == Z2(0));
+    OSM_CHECK(OSM::exactQuotient(Z2(1), Z2(1)) == Z2(1));
+    OSM_CHECK_THROWS(std::domain_error, OSM::exactQuotient(Z2(1), Z2(0)));
+}
+
+void testIntegerQuotient() {
+    OSM_CHECK(OSM::exactQuotient(12, -4) == -3);
+    OSM_CHECK(OSM::exactQuotient(INT_MAX, -1) == -INT_MAX);
+    OSM_CHECK(OSM::exactQuotient(INT_MIN, 1) == INT_MIN);
+    OSM_CHECK_THROWS(std::overflow_error, OSM::exactQuotient(INT_MIN, -1));
+    OSM_CHECK_THROWS(std::domain_error, OSM::exactQuotient(7, 2));
+    OSM_CHECK_THROWS(std::domain_error, OSM::exactQuotient(7, 0));
+}
+
+void testChainsOverFields() {
+    typedef OSM::ZpCoefficient<7> Z7;
+    typedef OSM::SparseMatrix<Z7, OSM::COLUMN> Matrix;
+
+    const Matrix matrix = Matrix::fromTriplets(2, 2, {{0, 0, Z7(3)}, {1, 0, Z7(4)}, {1, 1, Z7(6)}});
+    const std::vector<Z7> product = matrix.multiply({Z7(5), Z7(2)});
+    OSM_CHECK(product == std::vector<Z7>({Z7(1), Z7(4)}));
+
+    const Matrix square = matrix * matrix;
+    OSM_CHECK(square.multiply({Z7(1), Z7(0)}) == std::vector<Z7>({Z7(2), Z7(1)}));
+}
+
+}
+
+int main() {
+    testPrimeField<2>();
+    testPrimeField<3>();
+    testPrimeField<65521>();
+    testPrimeField<2147483647>();
+    testTwoElementField();
+    testIntegerQuotient();
+    testChainsOverFields();
+
+    return OSM::Tests::report();
+}
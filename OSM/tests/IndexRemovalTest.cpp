@@ -0,0 +1,101 @@
+/**
+ * \file IndexRemovalTest.cpp
+ * \brief Tests the removal and restriction of indexes on chains and matrices, for every storage policy.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+#include <vector>
+
+
+namespace {
+
+/** \brief The indexes of the non null coefficients of a chain. */
+template <typename _Chain>
+std::vector<int> support(const _Chain &_chain) {
+    std::vector<int> result;
+
+    for (int index = 0 ; index < _chain.getUpperBound() ; index++) {
+        if (_chain[index] != 0) {
+            result.push_back(index);
+        }
+    }
+
+    return result;
+}
+
+template <typename _CoefficientType, typename _StorageType>
+void testChainRemoval() {
+    typedef OSM::Chain<_CoefficientType, OSM::COLUMN, _StorageType> Column;
+
+    Column chain(10);
+    for (int index : {0, 2, 3, 5, 9}) {
+        chain[index] = _CoefficientType(1);
+    }
+
+    const std::vector<int> expected = {0, 1, 3};
+
+    // Unsorted, duplicated and out of range indexes
+    Column byVector = chain;
+    byVector /= std::vector<int>({9, 3, 1, 3, 12, -4});
+    OSM_CHECK(byVector.getUpperBound() == 7);
+    OSM_CHECK(support(byVector) == expected);
+
+    const int terminated[] = {9, 3, 1, -1};
+    Column byPointer = chain;
+    byPointer /= terminated;
+    OSM_CHECK(byPointer.getUpperBound() == 7);
+    OSM_CHECK(support(byPointer) == expected);
+
+    const Column bySet = chain / OSM::IndexSet(10, std::vector<int>({1, 3, 9}));
+    OSM_CHECK(bySet.getUpperBound() == 7);
+    OSM_CHECK(support(bySet) == expected);
+
+    OSM_CHECK(support(chain / std::vector<int>()) == support(chain));
+
+    const Column restricted = chain.restriction(OSM::IndexSet(10, std::vector<int>({2, 4, 5, 9})));
+    OSM_CHECK(restricted.getUpperBound() == 4);
+    OSM_CHECK(support(restricted) == std::vector<int>({0, 2, 3}));
+}
+
+void testMatrixRemoval() {
+    typedef OSM::SparseMatrix<int, OSM::COLUMN> Matrix;
+
+    // Boundary of a filled triangle: vertices 0, 1, 2, edges 3, 4, 5, face 6
+    const Matrix boundary = Matrix::fromTriplets(7, 7, {
+        {0, 3, -1}, {1, 3, 1}, {1, 4, -1}, {2, 4, 1}, {0, 5, -1}, {2, 5, 1},
+        {3, 6, 1}, {4, 6, 1}, {5, 6, -1}
+    });
+
+    // Removing vertex 2 and the edges and face containing it
+    Matrix removed = boundary;
+    removed /= std::vector<int>({6, 2, 4, 5});
+    OSM_CHECK(removed.getRowCount() == 3 && removed.getColumnCount() == 3);
+    OSM_CHECK(removed.multiply({0, 0, 1}) == std::vector<int>({-1, 1, 0}));
+
+    const int terminated[] = {6, 2, 4, 5, -1};
+    Matrix removedByPointer = boundary;
+    removedByPointer /= terminated;
+    OSM_CHECK(removedByPointer.multiply({0, 0, 1}) == std::vector<int>({-1, 1, 0}));
+
+    const Matrix kept = boundary.restriction(OSM::IndexSet(7, std::vector<int>({0, 1, 3})));
+    OSM_CHECK(kept.getRowCount() == 3 && kept.getColumnCount() == 3);
+    OSM_CHECK(kept.multiply({0, 0, 1}) == removed.multiply({0, 0, 1}));
+
+    OSM::SparseMatrix<int, OSM::COLUMN | OSM::ROW> dual(boundary);
+    dual /= std::vector<int>({6, 2, 4, 5});
+    OSM_CHECK(dual.getRowCount() == 3 && dual.getColumnCount() == 3);
+    OSM_CHECK(dual.getRow(0).size() == 1 && dual.getColumn(2).size() == 2);
+}
+
+}
+
+int main() {
+    testChainRemoval<int, OSM::DefaultStorage<int>::type>();
+    testChainRemoval<int, OSM::MapStorage<int>>();
+    testChainRemoval<int, OSM::HybridStorage<int>>();
+    testChainRemoval<OSM::Z2Coefficient, OSM::Z2Storage>();
+    testMatrixRemoval();
+
+    return OSM::Tests::report();
+}
@@ -0,0 +1,140 @@
+/**
+ * \file MappedMatrixTest.cpp
+ * \brief Tests the binary matrix files: round trips and rejection of malformed files.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+typedef OSM::SparseMatrix<int, OSM::COLUMN> Matrix;
+typedef OSM::MappedMatrix<int, OSM::COLUMN> Mapped;
+typedef OSM::MappedMatrix<int, OSM::ROW> RowMapped;
+
+/** \brief The file written by the tests, in the working directory. */
+const std::string PATH = "MappedMatrixTest.osm";
+
+/** \brief The file rewritten with malformed contents. */
+const std::string MALFORMED_PATH = "MappedMatrixTest.malformed.osm";
+
+/** \brief A 4 x 3 matrix with an empty column. */
+Matrix sample() {
+    return Matrix::fromTriplets(4, 3, {{0, 0, 1}, {3, 0, -2}, {1, 2, 5}, {2, 2, 7}});
+}
+
+std::vector<char> readBytes(const std::string &_path) {
+    std::ifstream file(_path, std::ios::binary);
+
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string &_path, const std::vector<char> &_bytes) {
+    std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+    file.write(_bytes.data(), _bytes.size());
+}
+
+/** \brief Overwrites a value of the sample file, optionally truncates it, and writes it to the malformed file. */
+template <typename _Value>
+void writePatched(const std::size_t _position, const _Value _value, const std::size_t _size = 0) {
+    std::vector<char> bytes = readBytes(PATH);
+    std::memcpy(bytes.data() + _position, &_value, sizeof(_Value));
+
+    if (_size != 0) {
+        bytes.resize(_size);
+    }
+
+    writeBytes(MALFORMED_PATH, bytes);
+}
+
+void testRoundTrip() {
+    const Matrix matrix = sample();
+    Mapped::write(matrix, PATH);
+
+    const Mapped mapped(PATH);
+    OSM_CHECK(mapped.getRowCount() == 4 && mapped.getColumnCount() == 3);
+    OSM_CHECK(mapped.getEntryCount() == 4);
+    OSM_CHECK(mapped[1].size() == 0);
+    OSM_CHECK(mapped.getCoefficient(3, 0) == -2);
+    OSM_CHECK(mapped.getCoefficient(2, 2) == 7);
+    OSM_CHECK(mapped.getCoefficient(2, 0) == 0);
+
+    const Matrix copy = mapped.toSparseMatrix();
+    OSM_CHECK(copy.multiply({1, 10, 100}) == matrix.multiply({1, 10, 100}));
+    OSM_CHECK(copy.transpose().multiply({1, 2, 3, 4}) == matrix.transpose().multiply({1, 2, 3, 4}));
+}
+
+void testMalformedFiles() {
+    const std::size_t entryCountPosition = 56;
+    const std::size_t offsetsPosition = 64;
+    const std::size_t indexesPosition = OSM::BinaryMatrixHeader::indexesPosition(3);
+
+    Mapped::write(sample(), PATH);
+    const std::size_t size = readBytes(PATH).size();
+
+    writePatched(entryCountPosition, uint64_t(1) << 61);
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    // An entry count whose byte size wraps around to 0, with a matching last offset
+    {
+        std::vector<char> bytes = readBytes(PATH);
+        const uint64_t entryCount = uint64_t(1) << 62;
+        std::memcpy(bytes.data() + entryCountPosition, &entryCount, sizeof(entryCount));
+        std::memcpy(bytes.data() + offsetsPosition + 3 * sizeof(uint64_t), &entryCount, sizeof(entryCount));
+        writeBytes(MALFORMED_PATH, bytes);
+    }
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    writePatched(entryCountPosition, ~uint64_t(0));
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    writePatched(entryCountPosition, uint64_t(4), size - 1);
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    writePatched(entryCountPosition, uint64_t(4), 72);
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    // Offsets 0, 2, 1, 4: decreasing
+    writePatched(offsetsPosition + 2 * sizeof(uint64_t), uint64_t(1));
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    // Offsets 0, 2, 2, 3: the last one is not the entry count
+    writePatched(offsetsPosition + 3 * sizeof(uint64_t), uint64_t(3));
+    OSM_CHECK_THROWS(std::invalid_argument, Mapped(MALFORMED_PATH));
+
+    // Indexes 0, 3, 2, 1: unsorted in the last chain, only found when copied
+    writePatched(indexesPosition + 2 * sizeof(int32_t), uint64_t(2) | uint64_t(1) << 32);
+    const Mapped unsorted(MALFORMED_PATH);
+    OSM_CHECK_THROWS(std::invalid_argument, unsorted.toSparseMatrix());
+
+    // Index 4 in a chain of 4 rows
+    writePatched(indexesPosition + sizeof(int32_t), int32_t(4));
+    const Mapped outOfBounds(MALFORMED_PATH);
+    OSM_CHECK_THROWS(std::invalid_argument, outOfBounds.toSparseMatrix());
+
+    writePatched(indexesPosition, int32_t(-1));
+    const Mapped negative(MALFORMED_PATH);
+    OSM_CHECK_THROWS(std::invalid_argument, negative.toSparseMatrix());
+
+    OSM_CHECK_THROWS(std::invalid_argument, RowMapped(PATH));
+}
+
+}
+
+int main() {
+    testRoundTrip();
+    testMalformedFiles();
+
+    std::remove(PATH.c_str());
+    std::remove(MALFORMED_PATH.c_str());
+
+    return OSM::Tests::report();
+}
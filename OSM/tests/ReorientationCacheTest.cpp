@@ -0,0 +1,86 @@
+/**
+ * \file ReorientationCacheTest.cpp
+ * \brief Tests that the cached reorientation and the reoriented view follow the writes to the matrix.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+
+
+namespace {
+
+typedef OSM::SparseMatrix<int, OSM::COLUMN> Matrix;
+typedef OSM::Chain<int, OSM::COLUMN> Column;
+
+void testWriteAfterCaching() {
+    Matrix matrix(3, 3);
+    Column &first = matrix[0];
+
+    OSM_CHECK(matrix.getReoriented()[2].size() == 0);
+
+    first[2] = 5;
+    OSM_CHECK(!matrix.isReorientedCached());
+    OSM_CHECK(matrix.getReoriented()[2][0] == 5);
+
+    // The reference given before the write is refreshed in place.
+    const OSM::SparseMatrix<int, OSM::ROW> &rows = matrix.getReoriented();
+    first[1] = 3;
+    matrix.getReoriented();
+    OSM_CHECK(rows[1][0] == 3);
+
+    matrix.commitChains();
+    OSM_CHECK(!matrix.isReorientedCached());
+    OSM_CHECK(matrix.getReoriented()[1][0] == 3);
+    OSM_CHECK(matrix.isReorientedCached());
+}
+
+void testIteratorWriteAfterCaching() {
+    Matrix matrix(2, 2);
+    Matrix::iterator column = matrix.begin();
+
+    OSM_CHECK(matrix.getReoriented()[1].size() == 0);
+
+    (*column)[1] = 4;
+    OSM_CHECK(matrix.getReoriented()[1][0] == 4);
+}
+
+void testCacheDroppedByModifications() {
+    Matrix matrix = Matrix::fromTriplets(2, 2, {{0, 0, 1}, {1, 1, 2}});
+
+    OSM_CHECK(matrix.getReoriented()[1][1] == 2);
+    OSM_CHECK(matrix.isReorientedCached());
+
+    const Matrix copy(matrix);
+    OSM_CHECK(copy.isReorientedCached());
+
+    matrix.setColumn(1, Column(2));
+    OSM_CHECK(!matrix.isReorientedCached());
+    OSM_CHECK(matrix.getReoriented()[1].size() == 0);
+    OSM_CHECK(copy.getReoriented()[1][1] == 2);
+}
+
+void testViewAfterWrites() {
+    Matrix matrix(3, 3);
+    Column &last = matrix[2];
+    const OSM::ReorientedView<int, OSM::COLUMN> view(matrix);
+
+    last[0] = 7;
+    OSM_CHECK(view[0][2] == 7);
+
+    last[0] = 0;
+    last[1] = 6;
+    OSM_CHECK(view[0].size() == 0);
+    OSM_CHECK(view[1][2] == 6);
+    OSM_CHECK(view.materialize()[1][2] == 6);
+}
+
+}
+
+int main() {
+    testWriteAfterCaching();
+    testIteratorWriteAfterCaching();
+    testCacheDroppedByModifications();
+    testViewAfterWrites();
+
+    return OSM::Tests::report();
+}
@@ -0,0 +1,133 @@
+/**
+ * \file SmithNormalFormTest.cpp
+ * \brief Tests the Smith normal form against known invariant factors and determinantal divisors.
+ */
+
+#include "../OSM.hpp"
+#include "Check.hpp"
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+typedef OSM::SparseMatrix<int, OSM::COLUMN> Matrix;
+typedef OSM::SmithNormalForm<OSM::DefaultStorage<int>::type> Smith;
+typedef std::vector<Smith::WideCoefficient> Factors;
+
+/** \brief The matrix of the given dense rows. */
+Matrix fromRows(const std::vector<std::vector<int>> &_rows) {
+    std::vector<OSM::Triplet<int>> triplets;
+
+    for (std::size_t row = 0 ; row < _rows.size() ; row++) {
+        for (std::size_t column = 0 ; column < _rows[row].size() ; column++) {
+            if (_rows[row][column] != 0) {
+                triplets.push_back({static_cast<int>(row), static_cast<int>(column), _rows[row][column]});
+            }
+        }
+    }
+
+    return Matrix::fromTriplets(_rows.size(), _rows.empty() ? 0 : _rows[0].size(), triplets);
+}
+
+Factors invariantFactors(const std::vector<std::vector<int>> &_rows) {
+    Smith smith;
+
+    return smith.compute(fromRows(_rows));
+}
+
+void testKnownInvariants() {
+    OSM_CHECK(invariantFactors({{2, 0}, {0, 4}}) == Factors({2, 4}));
+    OSM_CHECK(invariantFactors({{2, 0}, {0, 3}}) == Factors({1, 6}));
+    OSM_CHECK(invariantFactors({{2, 4}, {6, 8}}) == Factors({2, 4}));
+    OSM_CHECK(invariantFactors({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}}) == Factors({1, 3}));
+    OSM_CHECK(invariantFactors({{2, 4, 4}, {-6, 6, 12}}) == Factors({2, 6}));
+    OSM_CHECK(invariantFactors({{0, 0}, {0, 0}}).empty());
+
+    // Boundary of the 2-cells of the real projective plane as a CW complex: one 2-cell attached twice along a loop
+    OSM_CHECK(invariantFactors({{2}}) == Factors({2}));
+
+    // Boundary of a filled triangle: the edges have no torsion, the face boundary is a cycle
+    const std::vector<std::vector<int>> edges = {{-1, 0, -1}, {1, -1, 0}, {0, 1, 1}};
+    OSM_CHECK(invariantFactors(edges) == Factors({1, 1}));
+
+    Smith smith;
+    smith.compute(fromRows({{6, 0, 0}, {0, 10, 0}, {0, 0, 15}}));
+    OSM_CHECK(smith.getInvariantFactors() == Factors({1, 30, 30}));
+    OSM_CHECK(smith.getRank() == 3);
+}
+
+/** \brief The determinant of a 3 x 3 matrix. */
+long long determinant(const std::vector<std::vector<int>> &_rows) {
+    return (long long)_rows[0][0] * ((long long)_rows[1][1] * _rows[2][2] - (long long)_rows[1][2] * _rows[2][1])
+         - (long long)_rows[0][1] * ((long long)_rows[1][0] * _rows[2][2] - (long long)_rows[1][2] * _rows[2][0])
+         + (long long)_rows[0][2] * ((long long)_rows[1][0] * _rows[2][1] - (long long)_rows[1][1] * _rows[2][0]);
+}
+
+/** \brief The products d1, d1 d2, d1 d2 d3 of the invariant factors, 0 past the rank. */
+std::vector<long long> determinantalDivisors(const Factors &_factors) {
+    std::vector<long long> result(3, 0);
+    long long product = 1;
+
+    for (std::size_t factor = 0 ; factor < _factors.size() ; factor++) {
+        product *= _factors[factor];
+        result[factor] = product;
+    }
+
+    return result;
+}
+
+void testDeterminantalDivisors() {
+    std::mt19937 generator(2026);
+    std::uniform_int_distribution<int> coefficients(-6, 6);
+
+    for (int trial = 0 ; trial < 200 ; trial++) {
+        std::vector<std::vector<int>> rows(3, std::vector<int>(3));
+        for (std::vector<int> &row : rows) {
+            for (int &coefficient : row) {
+                coefficient = trial % 4 == 0 && coefficients(generator) > 0 ? 0 : coefficients(generator);
+            }
+        }
+
+        // The k-th determinantal divisor is the gcd of the k x k minors.
+        long long entries = 0;
+        long long minors = 0;
+        for (int row = 0 ; row < 3 ; row++) {
+            for (int column = 0 ; column < 3 ; column++) {
+                entries = std::gcd(entries, (long long)rows[row][column]);
+            }
+        }
+        for (int firstRow = 0 ; firstRow < 3 ; firstRow++) {
+            for (int secondRow = firstRow + 1 ; secondRow < 3 ; secondRow++) {
+                for (int firstColumn = 0 ; firstColumn < 3 ; firstColumn++) {
+                    for (int secondColumn = firstColumn + 1 ; secondColumn < 3 ; secondColumn++) {
+                        minors = std::gcd(minors, (long long)rows[firstRow][firstColumn] * rows[secondRow][secondColumn]
+                                                - (long long)rows[firstRow][secondColumn] * rows[secondRow][firstColumn]);
+                    }
+                }
+            }
+        }
+
+        const Factors factors = invariantFactors(rows);
+        const std::vector<long long> divisors = determinantalDivisors(factors);
+
+        OSM_CHECK(divisors[0] == entries);
+        OSM_CHECK(divisors[1] == minors);
+        OSM_CHECK(divisors[2] == std::llabs(determinant(rows)));
+
+        for (std::size_t factor = 1 ; factor < factors.size() ; factor++) {
+            OSM_CHECK(factors[factor] % factors[factor - 1] == 0);
+        }
+    }
+}
+
+}
+
+int main() {
+    testKnownInvariants();
+    testDeterminantalDivisors();
+
+    return OSM::Tests::report();
+}